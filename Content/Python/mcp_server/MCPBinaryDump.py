@@ -0,0 +1,220 @@
+"""
+MCP 二进制属性导出解码器 - 不依赖unreal
+
+解析 UMCPObjectInformDumpLibrary::ExportBlueprintPropertiesBinary 写出的文件。
+
+格式：
+- 头部: b"MCPB" + 版本(u8) + 标志(u8, bit0=zlib压缩) [+ 未压缩长度(varint)]
+- 负载: 字符串表 -> 属性 schema -> 元数据 -> 根结构体值
+- 值以 1 字节 tag 开头，整数使用 zigzag varint，浮点为 8 字节小端 double
+
+用法：
+    from mcp_server import MCPBinaryDump
+    dump = MCPBinaryDump.load("D:/Temp/BP_Hero.mcpb")
+    print(dump.blueprint, dump.properties["Health"])
+"""
+
+import struct
+import zlib
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional
+
+MAGIC = b"MCPB"
+VERSION = 1
+FLAG_COMPRESSED = 0x01
+
+TAG_NULL = 0
+TAG_FALSE = 1
+TAG_TRUE = 2
+TAG_INT = 3
+TAG_DOUBLE = 4
+TAG_STRING = 5
+TAG_ENUM = 6
+TAG_STRUCT = 7
+TAG_ARRAY = 8
+TAG_SET = 9
+TAG_MAP = 10
+TAG_OBJECT = 11
+TAG_REFERENCE = 12
+TAG_CIRCULAR = 13
+
+
+class TruncatedList(list):
+    """容器元素被截断时使用，total 为原始元素数量"""
+
+    def __init__(self, items=(), total: int = 0):
+        super().__init__(items)
+        self.total = total
+
+    @property
+    def truncated(self) -> bool:
+        return self.total > len(self)
+
+
+@dataclass
+class PropertySchema:
+    """属性描述：名称、C++类型、属性类（如 FloatProperty）"""
+    name: str
+    cpp_type: str
+    property_class: str
+
+
+@dataclass
+class EnumValue:
+    name: str
+    value: int
+
+
+@dataclass
+class ObjectRef:
+    """对象引用；properties 为 None 表示未内联展开，circular 表示循环引用"""
+    path: str
+    class_name: str = ""
+    properties: Optional[Dict[str, Any]] = None
+    circular: bool = False
+
+
+@dataclass
+class Reference:
+    """Class/SoftObject/WeakRef 等只记录路径的引用"""
+    kind: str
+    path: str
+
+
+@dataclass
+class BinaryDump:
+    package_path: str
+    blueprint: str
+    generated_class: str
+    parent_class: str
+    schema: List[PropertySchema] = field(default_factory=list)
+    properties: Dict[str, Any] = field(default_factory=dict)
+
+
+class _Reader:
+    def __init__(self, data: bytes):
+        self.view = memoryview(data)
+        self.pos = 0
+        self.strings: List[str] = []
+        self.schema: List[PropertySchema] = []
+
+    def byte(self) -> int:
+        value = self.view[self.pos]
+        self.pos += 1
+        return value
+
+    def varuint(self) -> int:
+        result = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            result |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return result
+            shift += 7
+
+    def varint(self) -> int:
+        value = self.varuint()
+        return (value >> 1) ^ -(value & 1)
+
+    def string(self) -> str:
+        return self.strings[self.varuint()]
+
+    def read_string_table(self):
+        count = self.varuint()
+        for _ in range(count):
+            length = self.varuint()
+            self.strings.append(bytes(self.view[self.pos:self.pos + length]).decode("utf-8"))
+            self.pos += length
+
+    def read_schema(self):
+        count = self.varuint()
+        for _ in range(count):
+            self.schema.append(PropertySchema(self.string(), self.string(), self.string()))
+
+    def value(self) -> Any:
+        tag = self.byte()
+        if tag == TAG_NULL:
+            return None
+        if tag == TAG_FALSE:
+            return False
+        if tag == TAG_TRUE:
+            return True
+        if tag == TAG_INT:
+            return self.varint()
+        if tag == TAG_DOUBLE:
+            value = struct.unpack_from("<d", self.view, self.pos)[0]
+            self.pos += 8
+            return value
+        if tag == TAG_STRING:
+            return self.string()
+        if tag == TAG_ENUM:
+            return EnumValue(self.string(), self.varint())
+        if tag == TAG_STRUCT:
+            return self.struct_body()
+        if tag in (TAG_ARRAY, TAG_SET):
+            total = self.varuint()
+            emitted = self.varuint()
+            items = [self.value() for _ in range(emitted)]
+            return TruncatedList(items, total) if emitted < total else items
+        if tag == TAG_MAP:
+            total = self.varuint()
+            emitted = self.varuint()
+            # 键可能是不可哈希的结构体，使用 (key, value) 列表
+            pairs = [(self.value(), self.value()) for _ in range(emitted)]
+            return TruncatedList(pairs, total) if emitted < total else pairs
+        if tag == TAG_OBJECT:
+            path = self.string()
+            class_name = self.string()
+            inner = self.value()
+            return ObjectRef(path, class_name, inner)
+        if tag == TAG_REFERENCE:
+            return Reference(self.string(), self.string())
+        if tag == TAG_CIRCULAR:
+            return ObjectRef(self.string(), circular=True)
+        raise ValueError(f"未知的值标签 {tag}，偏移 {self.pos - 1}")
+
+    def struct_body(self) -> Dict[str, Any]:
+        count = self.varuint()
+        result = {}
+        for _ in range(count):
+            prop = self.schema[self.varuint()]
+            result[prop.name] = self.value()
+        return result
+
+
+def decode(data: bytes) -> BinaryDump:
+    """解码二进制导出内容"""
+    if len(data) < 6 or data[:4] != MAGIC:
+        raise ValueError("不是 MCP 二进制导出文件")
+    version = data[4]
+    if version != VERSION:
+        raise ValueError(f"不支持的格式版本 {version}")
+    flags = data[5]
+
+    payload: bytes
+    if flags & FLAG_COMPRESSED:
+        header = _Reader(data)
+        header.pos = 6
+        raw_size = header.varuint()
+        payload = zlib.decompress(data[header.pos:])
+        if len(payload) != raw_size:
+            raise ValueError(f"解压长度不匹配: {len(payload)} != {raw_size}")
+    else:
+        payload = data[6:]
+
+    reader = _Reader(payload)
+    reader.read_string_table()
+    reader.read_schema()
+    dump = BinaryDump(reader.string(), reader.string(), reader.string(), reader.string())
+    dump.schema = reader.schema
+
+    root = reader.value()
+    dump.properties = root if isinstance(root, dict) else {}
+    return dump
+
+
+def load(path: str) -> BinaryDump:
+    """从文件加载二进制导出"""
+    with open(path, "rb") as f:
+        return decode(f.read())
@@ -12,6 +12,11 @@ MCPConfig.py - MCP服务器配置管理
 - MCP_HOST: MCP服务器监听地址 (默认: 127.0.0.1)
 - EDITOR_PORT: 编辑器转发服务器端口 (默认: 8100)
 - EDITOR_HOST: 编辑器转发服务器地址 (默认: 127.0.0.1)
+- EDITOR_ENDPOINT: 编辑器端转发实现，python (MCPForwarder.py) 或 native (C++ FMCPEndpoint) (默认: python)
+- EDITOR_ENCODING: 与编辑器通信的消息编码，auto / json / msgpack (默认: auto，安装了 msgpack 扩展时协商 msgpack)
+- EDITOR_COMPRESSION: 编辑器大响应的压缩算法，auto / lz4 / zlib / none (默认: auto，安装了 lz4 扩展时用 lz4，否则 zlib)
+- EDITOR_SHARED_MEMORY: 同机编辑器的大响应经共享内存传输，auto / off (默认: auto，EDITOR_HOST 为回环地址时启用)
+- NATIVE_MCP_PORT: 在编辑器内用 C++ 直接提供 MCP 协议（Streamable HTTP，http://<host>:<port>/mcp）的端口，0 表示不启用 (默认: 0)
 """
 
 import os
@@ -23,6 +28,11 @@ DEFAULT_MCP_PORT = 8099
 DEFAULT_MCP_HOST = "127.0.0.1"
 DEFAULT_EDITOR_PORT = 8100
 DEFAULT_EDITOR_HOST = "127.0.0.1"
+DEFAULT_EDITOR_ENDPOINT = "python"
+DEFAULT_EDITOR_ENCODING = "auto"
+DEFAULT_EDITOR_COMPRESSION = "auto"
+DEFAULT_EDITOR_SHARED_MEMORY = "auto"
+DEFAULT_NATIVE_MCP_PORT = 0
 
 
 def _find_env_file() -> Optional[str]:
@@ -140,6 +150,11 @@ def load_config(force_reload: bool = False) -> dict:
         - mcp_host: str
         - editor_port: int
         - editor_host: str
+        - editor_endpoint: str
+        - editor_encoding: str
+        - editor_compression: str
+        - editor_shared_memory: str
+        - native_mcp_port: int
     """
     global _config_cache
     
@@ -161,6 +176,11 @@ def load_config(force_reload: bool = False) -> dict:
     mcp_host = _get_config_value("MCP_HOST", DEFAULT_MCP_HOST, env_config)
     editor_port_str = _get_config_value("EDITOR_PORT", str(DEFAULT_EDITOR_PORT), env_config)
     editor_host = _get_config_value("EDITOR_HOST", DEFAULT_EDITOR_HOST, env_config)
+    editor_endpoint = _get_config_value("EDITOR_ENDPOINT", DEFAULT_EDITOR_ENDPOINT, env_config).strip().lower()
+    editor_encoding = _get_config_value("EDITOR_ENCODING", DEFAULT_EDITOR_ENCODING, env_config).strip().lower()
+    editor_compression = _get_config_value("EDITOR_COMPRESSION", DEFAULT_EDITOR_COMPRESSION, env_config).strip().lower()
+    editor_shared_memory = _get_config_value("EDITOR_SHARED_MEMORY", DEFAULT_EDITOR_SHARED_MEMORY, env_config).strip().lower()
+    native_mcp_port_str = _get_config_value("NATIVE_MCP_PORT", str(DEFAULT_NATIVE_MCP_PORT), env_config)
     
     # 解析端口号
     try:
@@ -175,16 +195,45 @@ def load_config(force_reload: bool = False) -> dict:
         print(f"[MCPConfig] Warning: Invalid EDITOR_PORT '{editor_port_str}', using default {DEFAULT_EDITOR_PORT}")
         editor_port = DEFAULT_EDITOR_PORT
     
+    try:
+        native_mcp_port = int(native_mcp_port_str)
+    except ValueError:
+        print(f"[MCPConfig] Warning: Invalid NATIVE_MCP_PORT '{native_mcp_port_str}', using default {DEFAULT_NATIVE_MCP_PORT}")
+        native_mcp_port = DEFAULT_NATIVE_MCP_PORT
+    
+    if editor_endpoint not in ("python", "native"):
+        print(f"[MCPConfig] Warning: Invalid EDITOR_ENDPOINT '{editor_endpoint}', using default {DEFAULT_EDITOR_ENDPOINT}")
+        editor_endpoint = DEFAULT_EDITOR_ENDPOINT
+    
+    if editor_encoding not in ("auto", "json", "msgpack"):
+        print(f"[MCPConfig] Warning: Invalid EDITOR_ENCODING '{editor_encoding}', using default {DEFAULT_EDITOR_ENCODING}")
+        editor_encoding = DEFAULT_EDITOR_ENCODING
+    
+    if editor_compression not in ("auto", "lz4", "zlib", "none"):
+        print(f"[MCPConfig] Warning: Invalid EDITOR_COMPRESSION '{editor_compression}', using default {DEFAULT_EDITOR_COMPRESSION}")
+        editor_compression = DEFAULT_EDITOR_COMPRESSION
+    
+    if editor_shared_memory not in ("auto", "off"):
+        print(f"[MCPConfig] Warning: Invalid EDITOR_SHARED_MEMORY '{editor_shared_memory}', using default {DEFAULT_EDITOR_SHARED_MEMORY}")
+        editor_shared_memory = DEFAULT_EDITOR_SHARED_MEMORY
+    
     _config_cache = {
         "mcp_port": mcp_port,
         "mcp_host": mcp_host,
         "editor_port": editor_port,
         "editor_host": editor_host,
+        "editor_endpoint": editor_endpoint,
+        "editor_encoding": editor_encoding,
+        "editor_compression": editor_compression,
+        "editor_shared_memory": editor_shared_memory,
+        "native_mcp_port": native_mcp_port,
     }
     
     print(f"[MCPConfig] Configuration loaded:")
     print(f"  MCP Server: {mcp_host}:{mcp_port}")
-    print(f"  Editor Forwarder: {editor_host}:{editor_port}")
+    print(f"  Editor Forwarder: {editor_host}:{editor_port} ({editor_endpoint})")
+    if native_mcp_port > 0:
+        print(f"  Native MCP HTTP: port {native_mcp_port}")
     
     return _config_cache
 
@@ -207,3 +256,28 @@ def get_editor_port() -> int:
 def get_editor_host() -> str:
     """获取编辑器转发服务器地址"""
     return load_config()["editor_host"]
+
+
+def get_editor_endpoint() -> str:
+    """获取编辑器端转发实现（python / native）"""
+    return load_config()["editor_endpoint"]
+
+
+def get_editor_encoding() -> str:
+    """获取与编辑器通信的消息编码（auto / json / msgpack）"""
+    return load_config()["editor_encoding"]
+
+
+def get_editor_compression() -> str:
+    """获取编辑器响应的压缩算法（auto / lz4 / zlib / none）"""
+    return load_config()["editor_compression"]
+
+
+def get_editor_shared_memory() -> str:
+    """获取同机共享内存传输设置（auto / off）"""
+    return load_config()["editor_shared_memory"]
+
+
+def get_native_mcp_port() -> int:
+    """获取编辑器内原生 MCP HTTP 端点的端口（0 表示不启用）"""
+    return load_config()["native_mcp_port"]
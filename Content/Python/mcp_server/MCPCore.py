@@ -11,6 +11,8 @@ MCPCore - MCP公共核心模块
 
 import os
 import sys
+import hashlib
+from collections import OrderedDict
 from datetime import datetime
 from typing import List, Dict, Any, Tuple, Optional
 from dataclasses import dataclass
@@ -129,6 +131,10 @@ TOOL_EXECUTE_COMMAND = ToolDefinition(
             "code": {
                 "type": "string",
                 "description": "Python code to execute in the editor"
+            },
+            "session": {
+                "type": "string",
+                "description": "Optional session name. Code run with the same session shares its globals, so helper functions and variables defined once can be reused by later calls without resending them."
             }
         }
     },
@@ -344,8 +350,61 @@ class CodeExecutor:
     
     提供日志捕获功能（仅在编辑器内可用）
     此类可在编辑器内和独立进程中使用
+    
+    编译结果按 (源码哈希, 文件名) 缓存（LRU，最多 CODE_CACHE_SIZE 个），重复发送的代码片段不再重新编译；
+    指定 session 时在该会话持久的全局变量中执行，之前定义的辅助函数和变量可直接使用
+    （最多保留 MAX_SESSIONS 个会话，超出时丢弃最久未使用的）。
     """
     
+    CODE_CACHE_SIZE = 256
+    MAX_SESSIONS = 32
+    
+    # (sha1, filename) -> code object
+    _code_cache: "OrderedDict[Tuple[str, str], Any]" = OrderedDict()
+    # 会话名 -> 全局变量字典
+    _sessions: "OrderedDict[str, dict]" = OrderedDict()
+    
+    @classmethod
+    def compile_cached(cls, code: str, filename: str = "<mcp>"):
+        """编译代码，相同源码和文件名直接返回缓存的 code object；语法错误时抛出 SyntaxError（不缓存）"""
+        key = (hashlib.sha1(code.encode("utf-8", "surrogatepass")).hexdigest(), filename)
+        compiled = cls._code_cache.get(key)
+        if compiled is not None:
+            cls._code_cache.move_to_end(key)
+            return compiled
+        
+        compiled = compile(code, filename, "exec")
+        cls._code_cache[key] = compiled
+        while len(cls._code_cache) > cls.CODE_CACHE_SIZE:
+            cls._code_cache.popitem(last=False)
+        return compiled
+    
+    @classmethod
+    def get_session_globals(cls, session: str) -> dict:
+        """获取会话的全局变量字典，不存在时创建"""
+        session_globals = cls._sessions.get(session)
+        if session_globals is None:
+            session_globals = {"__name__": "__mcp_session__", "__builtins__": __builtins__}
+            cls._sessions[session] = session_globals
+            while len(cls._sessions) > cls.MAX_SESSIONS:
+                cls._sessions.popitem(last=False)
+        else:
+            cls._sessions.move_to_end(session)
+        return session_globals
+    
+    @classmethod
+    def reset_session(cls, session: str = None) -> int:
+        """丢弃指定会话（为 None 时丢弃所有会话）的全局变量，返回丢弃的会话数量"""
+        if session is None:
+            count = len(cls._sessions)
+            cls._sessions.clear()
+            return count
+        return 1 if cls._sessions.pop(session, None) is not None else 0
+    
+    @classmethod
+    def list_sessions(cls) -> List[str]:
+        return list(cls._sessions.keys())
+    
     @staticmethod
     def _get_log_capture():
         """获取日志捕获模块（仅在编辑器内可用）"""
@@ -473,13 +532,16 @@ class CodeExecutor:
         return ""
     
     @classmethod
-    def execute_code(cls, code: str, exec_globals: dict = None) -> ExecutionResult:
+    def execute_code(cls, code: str, exec_globals: dict = None, session: str = None,
+                     filename: str = "<mcp>") -> ExecutionResult:
         """
         执行Python代码
         
         Args:
             code: Python代码字符串
             exec_globals: 执行时的全局变量字典，默认为空字典
+            session: 会话名，exec_globals 为 None 时在该会话持久的全局变量中执行
+            filename: 编译时使用的文件名（出现在异常堆栈中）
             
         Returns:
             ExecutionResult 执行结果
@@ -488,8 +550,8 @@ class CodeExecutor:
         
         try:
             if exec_globals is None:
-                exec_globals = {}
-            exec(code, exec_globals)
+                exec_globals = cls.get_session_globals(session) if session else {}
+            exec(cls.compile_cached(code, filename), exec_globals)
             logs = cls._disable_log_capture() if log_enabled else ""
             return ExecutionResult(
                 success=True,
@@ -503,6 +565,14 @@ class CodeExecutor:
                 success=False,
                 error=f"Syntax error: {e}"
             )
+        except KeyboardInterrupt:
+            # 原生端点收到 cancel 时中断执行
+            logs = cls._disable_log_capture() if log_enabled else ""
+            return ExecutionResult(
+                success=False,
+                error="Execution cancelled",
+                logs=logs
+            )
         except Exception as e:
             logs = cls._disable_log_capture() if log_enabled else ""
             return ExecutionResult(
@@ -512,13 +582,14 @@ class CodeExecutor:
             )
     
     @classmethod
-    def execute_file(cls, file_path: str, exec_globals: dict = None) -> ExecutionResult:
+    def execute_file(cls, file_path: str, exec_globals: dict = None, session: str = None) -> ExecutionResult:
         """
         执行Python文件
         
         Args:
             file_path: Python文件路径
             exec_globals: 执行时的全局变量字典，默认为空字典
+            session: 会话名，见 execute_code
             
         Returns:
             ExecutionResult 执行结果
@@ -526,7 +597,7 @@ class CodeExecutor:
         try:
             with open(file_path, 'r', encoding='utf-8') as f:
                 code = f.read()
-            return cls.execute_code(code, exec_globals)
+            return cls.execute_code(code, exec_globals, session=session, filename=file_path)
         except FileNotFoundError:
             return ExecutionResult(
                 success=False,
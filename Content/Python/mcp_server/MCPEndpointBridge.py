@@ -0,0 +1,90 @@
+"""
+MCPEndpointBridge - 原生C++端点的Python桥接
+
+原生端点（FMCPEndpoint）在C++中处理 socket、ping、get_state 和 dump_stream，
+execute / execute_file / get_imported_modules 等需要Python的请求在游戏线程上调用 handle_pending()：
+1. 通过 unreal.MCPEndpointLibrary.get_pending_python_request() 读取请求JSON
+2. 复用 MCPForwarder 的请求处理逻辑执行
+3. 通过 unreal.MCPEndpointLibrary.set_pending_python_response() 写回响应JSON
+
+执行中的代码可以调用 report_progress() / send_partial() 在最终结果前向客户端发送进度和部分输出：
+    from mcp_server.MCPEndpointBridge import report_progress
+    for i, asset in enumerate(assets):
+        report_progress(f"处理 {asset}", i / len(assets))
+
+客户端取消请求时，执行中的代码会收到 KeyboardInterrupt；也可以调用 is_cancelled() 主动检查。
+"""
+
+import json
+from typing import Optional
+
+try:
+    from .MCPForwarder import MCPForwarder
+except ImportError:
+    from MCPForwarder import MCPForwarder
+
+# 仅用于处理请求的转发器实例，不会启动socket
+_handler: Optional[MCPForwarder] = None
+
+
+def _get_handler() -> MCPForwarder:
+    global _handler
+    if _handler is None:
+        _handler = MCPForwarder()
+    return _handler
+
+
+def handle_pending():
+    """处理C++端点当前挂起的请求"""
+    import unreal
+    
+    request_id = None
+    try:
+        request = json.loads(unreal.MCPEndpointLibrary.get_pending_python_request())
+        request_id = request.get("id")
+        response = _get_handler().handle_request(request)
+    except Exception as e:
+        response = {
+            "type": "error",
+            "id": request_id,
+            "error": f"MCPEndpointBridge error: {e}"
+        }
+    
+    if response is not None:
+        unreal.MCPEndpointLibrary.set_pending_python_response(json.dumps(response, ensure_ascii=False))
+
+
+def report_progress(message: str, fraction: float = -1.0) -> bool:
+    """
+    向当前请求的客户端发送进度消息，客户端收到后会延长超时
+    
+    Args:
+        message: 当前步骤描述
+        fraction: 0~1 的完成度，负数表示未知
+    
+    Returns:
+        不在原生端点的请求中执行时返回 False
+    """
+    try:
+        import unreal
+        return bool(unreal.MCPEndpointLibrary.report_progress(str(message), float(fraction)))
+    except (ImportError, AttributeError):
+        return False
+
+
+def is_cancelled() -> bool:
+    """当前请求是否已被客户端取消"""
+    try:
+        import unreal
+        return bool(unreal.MCPEndpointLibrary.is_current_request_cancelled())
+    except (ImportError, AttributeError):
+        return False
+
+
+def send_partial(text: str) -> bool:
+    """向当前请求的客户端发送一段部分输出，不在原生端点的请求中执行时返回 False"""
+    try:
+        import unreal
+        return bool(unreal.MCPEndpointLibrary.send_partial_output(str(text)))
+    except (ImportError, AttributeError):
+        return False
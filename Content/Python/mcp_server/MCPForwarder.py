@@ -14,7 +14,8 @@ UE4 MCP Forwarder - 编辑器内转发服务器
 import json
 import time
 import socket
-from typing import Optional, Dict, Any, List
+from collections import deque
+from typing import Optional, Dict, Any, List, Deque
 from enum import Enum
 
 # 导入通用代码执行器
@@ -38,9 +39,13 @@ class MCPForwarder:
     通信协议：
     - 使用长度前缀协议：4字节大端序长度 + JSON消息体
     - 消息类型：
-      - ping/pong: 连接检测
-      - execute: 执行Python代码
+      - ping/pong、heartbeat: 连接检测（原生端点另外报告游戏线程是否忙碌）
+      - execute: 执行Python代码（可带 "session"，在该会话持久的全局变量中执行）
       - execute_file: 执行Python文件
+      - reset_session: 丢弃会话的全局变量
+      - dump_stream: 分块导出蓝图属性，每帧发送一个 chunk 消息，最后发送 result
+      - batch: 在同一帧内按顺序执行一组子请求，以一个 result 返回所有子结果
+      - log_tail/dump_object/get_property/set_property/tag_exists: 由 C++ 原生处理器执行
       - result: 执行结果
     """
     
@@ -48,6 +53,14 @@ class MCPForwarder:
     DEFAULT_HOST = "127.0.0.1"
     DEFAULT_PORT = 8100
     
+    # 单个 batch 的子请求数量上限，与 C++ FMCPEndpoint::MaxBatchSize 一致
+    MAX_BATCH_SIZE = 1024
+    # 不能放进 batch 的请求类型
+    BATCH_EXCLUDED_TYPES = ("batch", "dump_stream", "hello", "cancel")
+    # 已编码待发送字节的上限，与 C++ 的 MCP.Endpoint.SendQueueLimitKB 默认值一致；
+    # 超过后暂停读取新请求和推进分块导出，响应保持未编码排队，直到客户端读走数据
+    SEND_BUFFER_LIMIT = 8 * 1024 * 1024
+    
     def __init__(self, host: str = None, port: int = None):
         """
         初始化转发服务器
@@ -62,9 +75,15 @@ class MCPForwarder:
         self._server_socket: Optional[socket.socket] = None
         self._client_socket: Optional[socket.socket] = None
         self._state = ForwarderState.IDLE
-        self._pending_requests: List[Dict[str, Any]] = []
-        self._pending_responses: List[Dict[str, Any]] = []
-        self._recv_buffer = b""
+        # 队列头部出队为 O(1)，一帧内大量流水线请求不会退化为平方复杂度
+        self._pending_requests: Deque[Dict[str, Any]] = deque()
+        self._pending_responses: Deque[Dict[str, Any]] = deque()
+        self._recv_buffer = bytearray()
+        # 已编码但尚未写入 socket 的字节，部分写入后保留剩余部分
+        self._send_buffer = bytearray()
+        self._send_offset = 0
+        # 进行中的分块导出：每帧每个流只推进一个 chunk，避免长时间阻塞编辑器
+        self._active_streams: List[Dict[str, Any]] = []
         self._is_running = False
         self._last_tick_time = time.time()
         
@@ -112,7 +131,8 @@ class MCPForwarder:
         1. 接受新连接
         2. 接收数据
         3. 处理请求
-        4. 发送响应
+        4. 推进分块导出
+        5. 发送响应
         
         Args:
             delta_time: 帧间隔时间（秒）
@@ -126,13 +146,17 @@ class MCPForwarder:
             # 1. 处理新连接
             self._accept_connection()
             
-            # 2. 接收数据
-            self._receive_data()
+            # 2. 接收数据（发送队列已满时暂停，压力经 TCP 窗口传回客户端）
+            if not self._is_send_queue_full():
+                self._receive_data()
             
             # 3. 处理请求队列中的请求
             self._process_requests()
             
-            # 4. 发送响应
+            # 4. 推进分块导出
+            self._advance_streams()
+            
+            # 5. 发送响应
             self._send_responses()
             
         except Exception as e:
@@ -160,7 +184,7 @@ class MCPForwarder:
             client.setsockopt(socket.SOL_SOCKET, socket.SO_KEEPALIVE, 1)
             
             self._client_socket = client
-            self._recv_buffer = b""
+            self._recv_buffer = bytearray()
             self._log(f"MCPForwarder: Client connected from {addr}")
             
         except BlockingIOError:
@@ -206,35 +230,56 @@ class MCPForwarder:
         """
         解析消息
         协议：4字节大端序长度前缀 + JSON消息体
+        
+        在缓冲区上按偏移解码，处理完后一次性移除已消费的字节，大量小请求的开销保持线性
         """
-        while len(self._recv_buffer) >= 4:
-            # 读取消息长度（4字节大端序）
-            msg_len = int.from_bytes(self._recv_buffer[:4], 'big')
-            
-            # 检查消息是否完整
-            if len(self._recv_buffer) < 4 + msg_len:
-                break  # 消息不完整，等待更多数据
-            
-            # 提取消息体
-            msg_data = self._recv_buffer[4:4 + msg_len]
-            self._recv_buffer = self._recv_buffer[4 + msg_len:]
-            
-            try:
-                message = json.loads(msg_data.decode('utf-8'))
-                self._pending_requests.append(message)
-            except json.JSONDecodeError as e:
-                self._log(f"MCPForwarder JSON decode error: {e}")
-            except UnicodeDecodeError as e:
-                self._log(f"MCPForwarder Unicode decode error: {e}")
+        buffer = self._recv_buffer
+        offset = 0
+        
+        with memoryview(buffer) as view:
+            while len(buffer) - offset >= 4:
+                # 读取消息长度（4字节大端序）
+                msg_len = int.from_bytes(view[offset:offset + 4], 'big')
+                
+                # 检查消息是否完整
+                if len(buffer) - offset - 4 < msg_len:
+                    break  # 消息不完整，等待更多数据
+                
+                # 提取消息体
+                msg_data = bytes(view[offset + 4:offset + 4 + msg_len])
+                offset += 4 + msg_len
+                
+                try:
+                    message = json.loads(msg_data.decode('utf-8'))
+                    self._pending_requests.append(message)
+                except json.JSONDecodeError as e:
+                    self._log(f"MCPForwarder JSON decode error: {e}")
+                except UnicodeDecodeError as e:
+                    self._log(f"MCPForwarder Unicode decode error: {e}")
+        
+        if offset:
+            del buffer[:offset]
     
     def _process_requests(self):
         """处理待处理的请求队列"""
         while self._pending_requests:
-            request = self._pending_requests.pop(0)
+            request = self._pending_requests.popleft()
             response = self._handle_request(request)
             if response is not None:
                 self._pending_responses.append(response)
     
+    def handle_request(self, request: Dict[str, Any]) -> Optional[Dict[str, Any]]:
+        """
+        处理单个请求（不经过socket），供原生C++端点通过 MCPEndpointBridge 复用
+        
+        Args:
+            request: 请求字典
+            
+        Returns:
+            响应字典，或None（如果不需要响应）
+        """
+        return self._handle_request(request)
+    
     def _handle_request(self, request: Dict[str, Any]) -> Optional[Dict[str, Any]]:
         """
         处理单个请求
@@ -243,8 +288,13 @@ class MCPForwarder:
         - ping: 连接检测
         - execute: 执行Python代码
         - execute_file: 执行Python文件
+        - reset_session: 丢弃 session（省略时为全部会话）的全局变量
         - get_state: 获取当前状态
         - get_imported_modules: 获取已导入的模块
+        - dump_stream: 分块导出蓝图属性
+        - cancel: 取消进行中的分块导出（其他请求在本帧内同步执行完毕，无法取消）
+        - batch: 按顺序执行 requests 中的子请求，stop_on_error 时遇到失败即停止
+        - 其他类型若注册了 C++ 原生处理器（log_tail、get_property 等），直接交给原生处理器
         
         Args:
             request: 请求字典
@@ -255,24 +305,45 @@ class MCPForwarder:
         msg_type = request.get("type")
         request_id = request.get("id")
         
-        if msg_type == "ping":
-            # 连接检测响应
+        if msg_type in ("ping", "heartbeat"):
+            # 连接检测响应；能在 tick 中应答说明游戏线程没有阻塞
             return {
-                "type": "pong",
+                "type": "pong" if msg_type == "ping" else "heartbeat",
                 "id": request_id,
                 "timestamp": time.time(),
-                "state": self._state.value
+                "state": self._state.value,
+                "busy": False
             }
         
         elif msg_type == "execute":
             # 执行Python代码
             code = request.get("code", "")
-            return self._execute_code(request_id, code)
+            return self._execute_code(request_id, code, request.get("session"))
         
         elif msg_type == "execute_file":
             # 执行Python文件
             file_path = request.get("file", "")
-            return self._execute_file(request_id, file_path)
+            return self._execute_file(request_id, file_path, request.get("session"))
+        
+        elif msg_type == "reset_session":
+            session = request.get("session")
+            return {
+                "type": "result",
+                "id": request_id,
+                "success": True,
+                "reset": CodeExecutor.reset_session(session),
+                "sessions": CodeExecutor.list_sessions()
+            }
+        
+        elif msg_type == "hello":
+            # 编码协商：Python 转发器只支持 JSON
+            return {
+                "type": "hello",
+                "id": request_id,
+                "server": "python",
+                "encoding": "json",
+                "compression": "none"
+            }
         
         elif msg_type == "get_state":
             # 获取当前状态
@@ -289,21 +360,111 @@ class MCPForwarder:
             output_format = request.get("format", "imports")
             return self._get_imported_modules(request_id, include_stdlib, output_format)
         
-        else:
-            # 未知消息类型
-            return {
-                "type": "error",
-                "id": request_id,
-                "error": f"Unknown message type: {msg_type}"
-            }
+        elif msg_type == "dump_stream":
+            # 分块导出蓝图属性，响应由 _advance_streams 逐帧产生
+            return self._start_dump_stream(request_id, request)
+        
+        elif msg_type == "cancel":
+            return self._cancel_request(request_id, request.get("target"))
+        
+        elif msg_type == "batch":
+            return self._execute_batch(request_id, request)
+        
+        # 注册了 C++ 原生处理器的类型
+        native_response = self._handle_native_request(request)
+        if native_response is not None:
+            return native_response
+        
+        # 未知消息类型
+        return {
+            "type": "error",
+            "id": request_id,
+            "error": f"Unknown message type: {msg_type}"
+        }
     
-    def _execute_code(self, request_id: str, code: str) -> Dict[str, Any]:
+    def _execute_batch(self, request_id: str, request: Dict[str, Any]) -> Dict[str, Any]:
+        """
+        在本帧内按顺序执行一组子请求
+        
+        子请求没有 id 时按位置生成（"<batch id>#<index>"）；stop_on_error 时第一个失败之后的
+        子请求不再执行，结果标记 "skipped": true。返回的 results 与 requests 一一对应。
+        """
+        entries = request.get("requests")
+        if not isinstance(entries, list):
+            return {"type": "result", "id": request_id, "success": False,
+                    "error": "batch requires a requests array"}
+        if len(entries) > self.MAX_BATCH_SIZE:
+            return {"type": "result", "id": request_id, "success": False,
+                    "error": f"batch has {len(entries)} requests, the limit is {self.MAX_BATCH_SIZE}"}
+        
+        stop_on_error = bool(request.get("stop_on_error", False))
+        results = []
+        completed = 0
+        failed_index = None
+        
+        for index, entry in enumerate(entries):
+            entry_id = f"{request_id}#{index}"
+            if isinstance(entry, dict):
+                entry_id = entry.get("id", entry_id)
+            
+            if stop_on_error and failed_index is not None:
+                results.append({"type": "result", "id": entry_id, "success": False, "skipped": True,
+                                "error": "Skipped after an earlier request in the batch failed"})
+                continue
+            
+            if not isinstance(entry, dict):
+                entry_result = {"type": "result", "id": entry_id, "success": False,
+                                "error": "batch entries must be request objects"}
+            elif entry.get("type") in self.BATCH_EXCLUDED_TYPES:
+                entry_result = {"type": "result", "id": entry_id, "success": False,
+                                "error": f"'{entry.get('type')}' cannot be used inside a batch"}
+            else:
+                entry_result = self._handle_request(dict(entry, id=entry_id))
+                completed += 1
+            
+            # 错误响应是 {"type": "error"}，没有 success 字段
+            success = entry_result.get("success", entry_result.get("type") != "error")
+            if not success and failed_index is None:
+                failed_index = index
+            results.append(entry_result)
+        
+        response = {
+            "type": "result",
+            "id": request_id,
+            "success": failed_index is None,
+            "completed": completed,
+        }
+        if failed_index is not None:
+            response["failed_index"] = failed_index
+        response["results"] = results
+        return response
+    
+    def _handle_native_request(self, request: Dict[str, Any]) -> Optional[Dict[str, Any]]:
+        """交给 C++ 原生处理器执行，不经过 CodeExecutor；没有对应处理器时返回None"""
+        try:
+            import unreal
+            response_json = unreal.MCPEndpointLibrary.execute_native_request(json.dumps(request, ensure_ascii=False))
+        except Exception:
+            return None
+        return json.loads(response_json) if response_json else None
+    
+    @staticmethod
+    def _invalidate_native_cache():
+        """执行任意代码后清空原生处理器的结果缓存（代码可能修改了编辑器状态）"""
+        try:
+            import unreal
+            unreal.MCPEndpointLibrary.invalidate_result_cache()
+        except (ImportError, AttributeError):
+            pass
+    
+    def _execute_code(self, request_id: str, code: str, session: Optional[str] = None) -> Dict[str, Any]:
         """
         在编辑器主线程执行Python代码
         
         Args:
             request_id: 请求ID
             code: 要执行的Python代码
+            session: 会话名，指定时在该会话持久的全局变量中执行
             
         Returns:
             执行结果字典
@@ -311,7 +472,8 @@ class MCPForwarder:
         self._state = ForwarderState.EXECUTING
         
         # 使用通用CodeExecutor执行代码
-        result = CodeExecutor.execute_code(code)
+        result = CodeExecutor.execute_code(code, session=session)
+        self._invalidate_native_cache()
         
         self._state = ForwarderState.IDLE
         
@@ -324,13 +486,14 @@ class MCPForwarder:
             "logs": result.logs if result.logs else None
         }
     
-    def _execute_file(self, request_id: str, file_path: str) -> Dict[str, Any]:
+    def _execute_file(self, request_id: str, file_path: str, session: Optional[str] = None) -> Dict[str, Any]:
         """
         执行Python文件
         
         Args:
             request_id: 请求ID
             file_path: Python文件路径
+            session: 会话名，见 _execute_code
             
         Returns:
             执行结果字典
@@ -338,7 +501,8 @@ class MCPForwarder:
         self._state = ForwarderState.EXECUTING
         
         # 使用通用CodeExecutor执行文件
-        result = CodeExecutor.execute_file(file_path)
+        result = CodeExecutor.execute_file(file_path, session=session)
+        self._invalidate_native_cache()
         
         self._state = ForwarderState.IDLE
         
@@ -380,22 +544,189 @@ class MCPForwarder:
             "logs": result.logs if result.logs else None
         }
     
+    def _start_dump_stream(self, request_id: str, request: Dict[str, Any]) -> Optional[Dict[str, Any]]:
+        """
+        登记一个分块导出
+        
+        Args:
+            request_id: 请求ID
+            request: kind 为 "blueprint"（默认）时包含 package_path、visible_only、modified_only、chunk_chars；
+                     kind 为 "table" 时包含 package_path、row_filter、start_row、max_rows、chunk_rows
+            
+        Returns:
+            参数错误时返回错误结果，否则返回None（chunk 和 result 在后续帧发送）
+        """
+        package_path = request.get("package_path", "")
+        if not package_path:
+            return {
+                "type": "result",
+                "id": request_id,
+                "success": False,
+                "output": None,
+                "error": "dump_stream requires package_path",
+                "logs": None
+            }
+        
+        kind = request.get("kind", "blueprint")
+        if kind == "table":
+            start_row = max(int(request.get("start_row", 0)), 0)
+            max_rows = int(request.get("max_rows", 0))
+            self._active_streams.append({
+                "id": request_id,
+                "kind": kind,
+                "package_path": package_path,
+                "row_filter": request.get("row_filter", ""),
+                "chunk_rows": max(int(request.get("chunk_rows", 200)), 1),
+                # 截止行（不含），0 表示直到最后一行
+                "end_row": start_row + max_rows if max_rows > 0 else 0,
+                "cursor": start_row,
+                "seq": 0
+            })
+        else:
+            self._active_streams.append({
+                "id": request_id,
+                "kind": kind,
+                "package_path": package_path,
+                "visible_only": bool(request.get("visible_only", False)),
+                "modified_only": bool(request.get("modified_only", False)),
+                "chunk_chars": int(request.get("chunk_chars", 16384)),
+                "cursor": 0,
+                "seq": 0
+            })
+        return None
+    
+    def _cancel_request(self, request_id: Optional[str], target: Optional[str]) -> Dict[str, Any]:
+        """取消进行中的分块导出"""
+        stream = next((s for s in self._active_streams if s["id"] == target), None)
+        if stream is not None:
+            self._active_streams.remove(stream)
+            self._pending_responses.append({
+                "type": "result",
+                "id": target,
+                "success": False,
+                "cancelled": True,
+                "error": "Request cancelled"
+            })
+        return {
+            "type": "result",
+            "id": request_id,
+            "success": True,
+            "target": target,
+            "cancelled": stream is not None
+        }
+    
+    def _advance_streams(self):
+        """为每个进行中的分块导出产生一个 chunk"""
+        if not self._active_streams:
+            return
+        
+        if self._client_socket is None:
+            # 连接断开，放弃所有进行中的导出
+            self._active_streams.clear()
+            return
+        
+        if self._is_send_queue_full():
+            # 客户端读取跟不上，等发送队列排空后再继续
+            return
+        
+        import unreal
+        
+        for stream in list(self._active_streams):
+            self._state = ForwarderState.EXECUTING
+            try:
+                if stream["kind"] == "table":
+                    chunk, next_cursor, success = self._read_table_chunk(stream)
+                else:
+                    chunk, next_cursor, success = unreal.MCPObjectInformDumpLibrary.dump_blueprint_properties_chunk(
+                        stream["package_path"], stream["cursor"], stream["chunk_chars"],
+                        stream["visible_only"], stream["modified_only"])
+            except Exception as e:
+                success, chunk, next_cursor = False, f"dump_stream failed: {e}", -1
+            finally:
+                self._state = ForwarderState.IDLE
+            
+            if not success:
+                self._active_streams.remove(stream)
+                self._pending_responses.append({
+                    "type": "result",
+                    "id": stream["id"],
+                    "success": False,
+                    "output": None,
+                    "error": chunk,
+                    "logs": None
+                })
+                continue
+            
+            if chunk:
+                self._pending_responses.append({
+                    "type": "chunk",
+                    "id": stream["id"],
+                    "seq": stream["seq"],
+                    "data": chunk
+                })
+                stream["seq"] += 1
+            
+            if next_cursor < 0:
+                self._active_streams.remove(stream)
+                self._pending_responses.append({
+                    "type": "result",
+                    "id": stream["id"],
+                    "success": True,
+                    "output": None,
+                    "error": None,
+                    "logs": None,
+                    "chunks": stream["seq"]
+                })
+            else:
+                stream["cursor"] = next_cursor
+    
+    def _read_table_chunk(self, stream: Dict[str, Any]):
+        """读取 DataTable/CurveTable 的下一批行，表头只在第一个 chunk 中输出"""
+        import unreal
+        
+        rows = stream["chunk_rows"]
+        if stream["end_row"] > 0:
+            rows = min(rows, stream["end_row"] - stream["cursor"])
+        
+        chunk, next_row = unreal.MCPObjectInformDumpLibrary.dump_table_rows(
+            stream["package_path"], stream["row_filter"], stream["cursor"], rows, stream["seq"] == 0)
+        
+        if stream["end_row"] > 0 and next_row >= stream["end_row"]:
+            next_row = -1
+        return chunk, next_row, not chunk.startswith("Error:")
+    
+    def _is_send_queue_full(self) -> bool:
+        """待发送字节是否已达上限"""
+        return len(self._send_buffer) - self._send_offset >= self.SEND_BUFFER_LIMIT
+    
     def _send_responses(self):
-        """发送待发送的响应"""
+        """
+        发送待发送的响应
+        
+        响应只在发送缓冲低于 SEND_BUFFER_LIMIT 时编码，socket 写满时保留未写出的部分，下一帧从断点继续
+        """
         if self._client_socket is None:
             self._pending_responses.clear()
+            self._send_buffer.clear()
+            self._send_offset = 0
             return
         
-        while self._pending_responses:
-            response = self._pending_responses.pop(0)
+        while self._pending_responses and not self._is_send_queue_full():
+            response = self._pending_responses.popleft()
+            data = json.dumps(response, ensure_ascii=False).encode('utf-8')
+            # 添加长度前缀
+            self._send_buffer += len(data).to_bytes(4, 'big')
+            self._send_buffer += data
+        
+        while self._send_offset < len(self._send_buffer):
             try:
-                data = json.dumps(response, ensure_ascii=False).encode('utf-8')
-                # 添加长度前缀
-                length_prefix = len(data).to_bytes(4, 'big')
-                self._client_socket.sendall(length_prefix + data)
+                with memoryview(self._send_buffer)[self._send_offset:] as view:
+                    sent = self._client_socket.send(view)
+                if sent <= 0:
+                    break
+                self._send_offset += sent
             except BlockingIOError:
-                # 发送缓冲区满，放回队列
-                self._pending_responses.insert(0, response)
+                # socket 发送缓冲区满，剩余部分下一帧再发
                 break
             except BrokenPipeError:
                 self._log("MCPForwarder: Broken pipe during send")
@@ -409,6 +740,14 @@ class MCPForwarder:
                 self._log(f"MCPForwarder send error: {e}")
                 self._close_client()
                 break
+        
+        if self._send_offset >= len(self._send_buffer):
+            self._send_buffer = bytearray()
+            self._send_offset = 0
+        elif self._send_offset >= len(self._send_buffer) // 2:
+            # 已发送部分过半时才整体前移，部分写入不必每次搬动剩余数据
+            del self._send_buffer[:self._send_offset]
+            self._send_offset = 0
     
     def _close_client(self):
         """关闭客户端连接"""
@@ -418,7 +757,9 @@ class MCPForwarder:
             except Exception:
                 pass
             self._client_socket = None
-        self._recv_buffer = b""
+        self._recv_buffer = bytearray()
+        self._send_buffer = bytearray()
+        self._send_offset = 0
         self._pending_requests.clear()
         self._pending_responses.clear()
         self._state = ForwarderState.IDLE
@@ -0,0 +1,214 @@
+"""
+MCP 协议 MessagePack 编解码 - 不依赖unreal
+
+与 C++ FMCPMessagePack 对应，用于 hello 协商后的连接。
+安装了 msgpack 扩展时直接使用它（编解码比 json 快数倍）；否则使用下面的纯 Python 实现，
+仅保证兼容，速度不如 json，因此客户端默认只在 HAS_NATIVE 时协商 msgpack。
+
+用法：
+    from mcp_server import MCPMessagePack
+    data = MCPMessagePack.packb({"type": "ping"})
+    message = MCPMessagePack.unpackb(memoryview(buffer)[4:4 + size])
+"""
+
+import struct
+from typing import Any, Tuple
+
+try:
+    import msgpack as _msgpack
+    HAS_NATIVE = True
+except ImportError:
+    _msgpack = None
+    HAS_NATIVE = False
+
+MAX_DEPTH = 64
+
+
+def is_msgpack_frame(data) -> bool:
+    """帧首字节是否为 MessagePack map（JSON 帧以 '{' 开头）"""
+    if not len(data):
+        return False
+    first = data[0]
+    return (first & 0xF0) == 0x80 or first in (0xDE, 0xDF)
+
+
+def packb(obj: Any) -> bytes:
+    """编码为 MessagePack"""
+    if _msgpack is not None:
+        return _msgpack.packb(obj, use_bin_type=True)
+    out = bytearray()
+    _pack(obj, out, 0)
+    return bytes(out)
+
+
+def unpackb(data) -> Any:
+    """解码 MessagePack，data 可以是 bytes/bytearray/memoryview（不复制）"""
+    if _msgpack is not None:
+        return _msgpack.unpackb(data, raw=False, strict_map_key=False)
+    view = memoryview(data)
+    value, pos = _unpack(view, 0, 0)
+    if pos != len(view):
+        raise ValueError("MessagePack 数据末尾有多余字节")
+    return value
+
+
+def _pack_header(out: bytearray, count: int, fix_tag: int, fix_limit: int, tag16: int, tag32: int):
+    if count < fix_limit:
+        out.append(fix_tag | count)
+    elif count <= 0xFFFF:
+        out.append(tag16)
+        out += struct.pack(">H", count)
+    else:
+        out.append(tag32)
+        out += struct.pack(">I", count)
+
+
+def _pack(obj: Any, out: bytearray, depth: int):
+    if depth > MAX_DEPTH:
+        raise ValueError("MessagePack 嵌套层数过深")
+
+    if obj is None:
+        out.append(0xC0)
+    elif obj is True:
+        out.append(0xC3)
+    elif obj is False:
+        out.append(0xC2)
+    elif isinstance(obj, int):
+        if 0 <= obj <= 0x7F:
+            out.append(obj)
+        elif -32 <= obj < 0:
+            out.append(obj & 0xFF)
+        elif -(1 << 31) <= obj < (1 << 31):
+            out.append(0xD2)
+            out += struct.pack(">i", obj)
+        elif -(1 << 63) <= obj < (1 << 63):
+            out.append(0xD3)
+            out += struct.pack(">q", obj)
+        else:
+            out.append(0xCF)
+            out += struct.pack(">Q", obj)
+    elif isinstance(obj, float):
+        out.append(0xCB)
+        out += struct.pack(">d", obj)
+    elif isinstance(obj, str):
+        data = obj.encode("utf-8")
+        if len(data) < 32:
+            out.append(0xA0 | len(data))
+        elif len(data) <= 0xFF:
+            out.append(0xD9)
+            out.append(len(data))
+        else:
+            _pack_header(out, len(data), 0, 0, 0xDA, 0xDB)
+        out += data
+    elif isinstance(obj, (bytes, bytearray, memoryview)):
+        data = bytes(obj)
+        if len(data) <= 0xFF:
+            out.append(0xC4)
+            out.append(len(data))
+        else:
+            _pack_header(out, len(data), 0, 0, 0xC5, 0xC6)
+        out += data
+    elif isinstance(obj, dict):
+        _pack_header(out, len(obj), 0x80, 16, 0xDE, 0xDF)
+        for key, value in obj.items():
+            _pack(key, out, depth + 1)
+            _pack(value, out, depth + 1)
+    elif isinstance(obj, (list, tuple)):
+        _pack_header(out, len(obj), 0x90, 16, 0xDC, 0xDD)
+        for item in obj:
+            _pack(item, out, depth + 1)
+    else:
+        raise TypeError(f"无法编码为 MessagePack 的类型: {type(obj).__name__}")
+
+
+_FIXED = {
+    0xCC: (">B", 1), 0xCD: (">H", 2), 0xCE: (">I", 4), 0xCF: (">Q", 8),
+    0xD0: (">b", 1), 0xD1: (">h", 2), 0xD2: (">i", 4), 0xD3: (">q", 8),
+    0xCA: (">f", 4), 0xCB: (">d", 8),
+}
+_LENGTH = {0xD9: 1, 0xDA: 2, 0xDB: 4, 0xC4: 1, 0xC5: 2, 0xC6: 4}
+_FIXEXT = {0xD4: 1, 0xD5: 2, 0xD6: 4, 0xD7: 8, 0xD8: 16}
+_EXT = {0xC7: 1, 0xC8: 2, 0xC9: 4}
+_LENGTH_FORMATS = {1: ">B", 2: ">H", 4: ">I"}
+
+
+def _read_length(view: memoryview, pos: int, size: int) -> Tuple[int, int]:
+    if pos + size > len(view):
+        raise ValueError("MessagePack 数据不完整")
+    return struct.unpack_from(_LENGTH_FORMATS[size], view, pos)[0], pos + size
+
+
+def _unpack(view: memoryview, pos: int, depth: int) -> Tuple[Any, int]:
+    if depth > MAX_DEPTH:
+        raise ValueError("MessagePack 嵌套层数过深")
+    if pos >= len(view):
+        raise ValueError("MessagePack 数据不完整")
+
+    tag = view[pos]
+    pos += 1
+
+    if tag <= 0x7F:
+        return tag, pos
+    if tag >= 0xE0:
+        return tag - 0x100, pos
+    if (tag & 0xF0) == 0x80:
+        return _unpack_map(view, pos, tag & 0x0F, depth)
+    if (tag & 0xF0) == 0x90:
+        return _unpack_array(view, pos, tag & 0x0F, depth)
+    if (tag & 0xE0) == 0xA0:
+        return _unpack_str(view, pos, tag & 0x1F)
+
+    if tag == 0xC0:
+        return None, pos
+    if tag == 0xC2:
+        return False, pos
+    if tag == 0xC3:
+        return True, pos
+    if tag in _FIXED:
+        fmt, size = _FIXED[tag]
+        if pos + size > len(view):
+            raise ValueError("MessagePack 数据不完整")
+        return struct.unpack_from(fmt, view, pos)[0], pos + size
+    if tag in _LENGTH:
+        length, pos = _read_length(view, pos, _LENGTH[tag])
+        if tag in (0xC4, 0xC5, 0xC6):
+            if pos + length > len(view):
+                raise ValueError("MessagePack 数据不完整")
+            return bytes(view[pos:pos + length]), pos + length
+        return _unpack_str(view, pos, length)
+    if tag in _FIXEXT:
+        return None, pos + 1 + _FIXEXT[tag]
+    if tag in _EXT:
+        length, pos = _read_length(view, pos, _EXT[tag])
+        return None, pos + 1 + length
+    if tag in (0xDC, 0xDD):
+        count, pos = _read_length(view, pos, 2 if tag == 0xDC else 4)
+        return _unpack_array(view, pos, count, depth)
+    if tag in (0xDE, 0xDF):
+        count, pos = _read_length(view, pos, 2 if tag == 0xDE else 4)
+        return _unpack_map(view, pos, count, depth)
+    raise ValueError(f"无效的 MessagePack 标签 0x{tag:02x}，偏移 {pos - 1}")
+
+
+def _unpack_str(view: memoryview, pos: int, length: int) -> Tuple[str, int]:
+    end = pos + length
+    if end > len(view):
+        raise ValueError("MessagePack 数据不完整")
+    return str(view[pos:end], "utf-8"), end
+
+
+def _unpack_array(view: memoryview, pos: int, count: int, depth: int) -> Tuple[list, int]:
+    items = []
+    for _ in range(count):
+        item, pos = _unpack(view, pos, depth + 1)
+        items.append(item)
+    return items, pos
+
+
+def _unpack_map(view: memoryview, pos: int, count: int, depth: int) -> Tuple[dict, int]:
+    result = {}
+    for _ in range(count):
+        key, pos = _unpack(view, pos, depth + 1)
+        value, pos = _unpack(view, pos, depth + 1)
+        result[key] = value
+    return result, pos
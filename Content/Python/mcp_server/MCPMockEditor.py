@@ -0,0 +1,745 @@
+"""
+MCP 模拟编辑器 - 不依赖unreal
+
+在没有 UE 编辑器的机器上（包括 Linux）实现编辑器一端的长度前缀协议，用于压测传输层：
+客户端、MCPStandalone 或仓库根目录的 loadtest.py 连接它即可测量吞吐和延迟，不需要任何引擎内容。
+
+线程模型与 C++ FMCPEndpoint 相同：
+- I/O 线程（asyncio 事件循环）收发数据、解析帧，直接应答 ping/heartbeat/hello/cancel/metrics，
+  并按连接协商的编码（json/msgpack）和压缩（zlib/lz4）发送响应
+- 模拟的游戏线程每 frame_ms 毫秒 tick 一次，按优先级在帧预算内执行排队的请求（每帧至少一个），
+  推进分块导出、推送订阅事件；执行期间游戏线程阻塞，heartbeat 报告 executing/stalled
+- log_tail、captured_logs、find_assets 与原生端点一样在工作线程执行
+
+请求由合成处理器应答，执行耗时按类型配置（--delay execute=5），可加随机抖动；
+请求带 "mock_output_bytes" 时 output 为该长度的文本，便于测试大响应。
+
+用法：
+    python MCPMockEditor.py [--port 8100] [--frame-ms 16.7] [--budget-ms 5]
+                            [--delay execute=2 --delay dump_object=0.5] [--jitter 0.2]
+                            [--stall-every 0 --stall-ms 2000] [--events-per-frame 0]
+"""
+
+import argparse
+import asyncio
+import json
+import queue
+import random
+import struct
+import threading
+import time
+import zlib
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field
+from typing import Any, Deque, Dict, List, Optional
+
+try:
+    from . import MCPMessagePack
+except ImportError:
+    import MCPMessagePack
+
+try:
+    import lz4.block as lz4_block
+except ImportError:
+    lz4_block = None
+
+# 与 C++ FMCPEndpoint 一致的协议常量
+MAX_MESSAGE_SIZE = 256 * 1024 * 1024
+MAX_BATCH_SIZE = 1024
+COMPRESSED_FRAME_MARKER = 0xC1
+COMPRESSION_ZLIB = 1
+COMPRESSION_LZ4 = 2
+
+PRIORITY_HIGH = 0
+PRIORITY_NORMAL = 1
+PRIORITY_LOW = 2
+PRIORITY_NAMES = {"high": PRIORITY_HIGH, "normal": PRIORITY_NORMAL, "low": PRIORITY_LOW}
+
+# 在工作线程执行的类型（对应 FMCPNativeHandler::bThreadSafe）
+WORKER_TYPES = ("log_tail", "captured_logs", "find_assets")
+
+# 各类型的默认执行耗时（毫秒），未列出的类型使用 default
+DEFAULT_DELAYS_MS = {
+    "default": 0.2,
+    "execute": 2.0,
+    "execute_file": 5.0,
+    "dump_stream": 0.5,
+}
+
+
+@dataclass
+class MockEditorConfig:
+    """模拟编辑器配置"""
+    host: str = "127.0.0.1"
+    port: int = 8100
+    frame_ms: float = 16.7               # 游戏线程帧间隔
+    frame_budget_ms: float = 5.0         # 每帧执行请求的预算，与 MCP.Endpoint.FrameBudgetMs 对应
+    delays_ms: Dict[str, float] = field(default_factory=lambda: dict(DEFAULT_DELAYS_MS))
+    jitter: float = 0.0                  # 执行耗时的随机抖动比例（0.2 表示 ±20%）
+    output_bytes: int = 64               # 默认的 output 长度
+    stream_chunks: int = 8               # dump_stream 的 chunk 数
+    worker_threads: int = 4              # 工作线程数，0 表示全部在游戏线程执行
+    compression_threshold: int = 16 * 1024
+    send_queue_limit: int = 8 * 1024 * 1024  # 连接待发送字节超过此值时暂停分块导出
+    stall_every: float = 0.0             # 每隔多少秒模拟一次游戏线程停滞（着色器编译等），0 关闭
+    stall_ms: float = 2000.0
+    stall_threshold_ms: float = 1000.0   # 与 MCP.Endpoint.StallThresholdMs 对应
+    events_per_frame: int = 0            # 每帧为每个 log 订阅生成的合成日志事件数
+    max_connections: int = 16
+
+    def get_delay_seconds(self, msg_type: str) -> float:
+        delay = self.delays_ms.get(msg_type, self.delays_ms.get("default", 0.0))
+        if self.jitter > 0:
+            delay *= 1.0 + random.uniform(-self.jitter, self.jitter)
+        return max(delay, 0.0) / 1000.0
+
+
+@dataclass
+class MockRequest:
+    """I/O 线程交给游戏线程的请求"""
+    conn: "MockConnection"
+    type: str
+    id: Optional[str]
+    message: Dict[str, Any]
+    receive_time: float
+    priority: int = PRIORITY_NORMAL
+    deadline: float = 0.0
+    cancelled: bool = False
+
+
+@dataclass
+class MockStream:
+    """游戏线程上进行中的分块导出"""
+    request: MockRequest
+    chunk_chars: int
+    total: int
+    seq: int = 0
+
+
+class LatencySamples:
+    """按类型记录的耗时样本，只保留最近 max_samples 个"""
+
+    def __init__(self, max_samples: int = 100000):
+        self._samples: Deque[float] = deque(maxlen=max_samples)
+        self.count = 0
+
+    def add(self, seconds: float):
+        self._samples.append(seconds)
+        self.count += 1
+
+    def to_dict(self) -> Dict[str, float]:
+        ordered = sorted(self._samples)
+        if not ordered:
+            return {"count": 0}
+
+        def percentile(fraction: float) -> float:
+            return ordered[min(int(fraction * len(ordered)), len(ordered) - 1)] * 1000.0
+
+        return {
+            "count": self.count,
+            "mean_ms": sum(ordered) / len(ordered) * 1000.0,
+            "p50_ms": percentile(0.5),
+            "p90_ms": percentile(0.9),
+            "p99_ms": percentile(0.99),
+            "max_ms": ordered[-1] * 1000.0,
+        }
+
+
+class MockConnection:
+    """一个客户端连接，发送只在 I/O 线程进行"""
+
+    def __init__(self, editor: "MockEditor", conn_id: int, writer: asyncio.StreamWriter):
+        self.editor = editor
+        self.id = conn_id
+        self.writer = writer
+        self.msgpack = False
+        self.compression: Optional[str] = None
+        self.compression_threshold = editor.config.compression_threshold
+        self.in_flight: Dict[str, MockRequest] = {}
+        self.closed = False
+
+    def send(self, message: Dict[str, Any], request_type: Optional[str] = None):
+        """编码并写入一条消息（仅 I/O 线程），发送字节数计入 request_type 的统计"""
+        if self.closed:
+            return
+        if self.msgpack:
+            payload = MCPMessagePack.packb(message)
+        else:
+            payload = json.dumps(message, ensure_ascii=False).encode('utf-8')
+        payload = self._compress(payload)
+        self.writer.write(len(payload).to_bytes(4, 'big') + payload)
+        if request_type:
+            self.editor.record_sent(request_type, 4 + len(payload))
+
+    def send_threadsafe(self, message: Dict[str, Any], request_type: Optional[str] = None):
+        """游戏线程或工作线程发送，编码交给 I/O 线程"""
+        self.editor.loop.call_soon_threadsafe(self.send, message, request_type)
+
+    def is_congested(self) -> bool:
+        transport = self.writer.transport
+        return transport is not None and transport.get_write_buffer_size() >= self.editor.config.send_queue_limit
+
+    def _compress(self, payload: bytes) -> bytes:
+        if self.compression is None or len(payload) < self.compression_threshold:
+            return payload
+        if self.compression == "lz4":
+            algorithm, data = COMPRESSION_LZ4, lz4_block.compress(payload, store_size=False)
+        else:
+            algorithm, data = COMPRESSION_ZLIB, zlib.compress(payload, 1)
+        if len(data) + 6 >= len(payload):
+            return payload
+        return bytes((COMPRESSED_FRAME_MARKER, algorithm)) + len(payload).to_bytes(4, 'big') + data
+
+
+class MockEditor:
+    """
+    模拟编辑器
+
+    start() 在后台线程启动 I/O 事件循环和游戏线程，stop() 停止；也可以用 run_forever() 阻塞运行。
+    """
+
+    def __init__(self, config: MockEditorConfig = None):
+        self.config = config or MockEditorConfig()
+        self.loop: Optional[asyncio.AbstractEventLoop] = None
+        self._server: Optional[asyncio.AbstractServer] = None
+        self._io_thread: Optional[threading.Thread] = None
+        self._game_thread: Optional[threading.Thread] = None
+        self._workers: Optional[ThreadPoolExecutor] = None
+        self._stop = threading.Event()
+        self._started = threading.Event()
+        self._connections: Dict[int, MockConnection] = {}
+        self._next_conn_id = 1
+
+        # I/O 线程 -> 游戏线程
+        self._incoming: "queue.SimpleQueue[MockRequest]" = queue.SimpleQueue()
+        self._scheduled: List[Deque[MockRequest]] = [deque(), deque(), deque()]
+        self._streams: List[MockStream] = []
+        # 订阅ID -> (连接, 主题列表)，仅游戏线程
+        self._subscriptions: Dict[str, Any] = {}
+
+        # 游戏线程状态，heartbeat 在 I/O 线程读取
+        self.frame = 0
+        self._last_tick = 0.0
+        self._busy = False
+        self._current_type: Optional[str] = None
+        self._current_start = 0.0
+        self._next_stall = 0.0
+        self._active_workers = 0
+
+        self._metrics_lock = threading.Lock()
+        self._reset_metrics()
+
+    # ------------------------------------------------------------------ 生命周期
+
+    def start(self):
+        """在后台线程启动，端口监听成功后返回"""
+        self._io_thread = threading.Thread(target=self._run_io, name="MockEditorIO", daemon=True)
+        self._io_thread.start()
+        self._started.wait()
+        if self._server is None:
+            raise OSError(f"MockEditor failed to listen on {self.config.host}:{self.config.port}")
+
+    def stop(self):
+        self._stop.set()
+        if self.loop is not None and self.loop.is_running():
+            self.loop.call_soon_threadsafe(self.loop.stop)
+        if self._io_thread is not None:
+            self._io_thread.join(timeout=5)
+        if self._game_thread is not None:
+            self._game_thread.join(timeout=5)
+        if self._workers is not None:
+            self._workers.shutdown(wait=False)
+
+    def run_forever(self):
+        self.start()
+        try:
+            while not self._stop.is_set():
+                time.sleep(0.5)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            self.stop()
+
+    def _run_io(self):
+        self.loop = asyncio.new_event_loop()
+        asyncio.set_event_loop(self.loop)
+        try:
+            self._server = self.loop.run_until_complete(
+                asyncio.start_server(self._handle_client, self.config.host, self.config.port))
+        except OSError as e:
+            print(f"[MockEditor] Listen error: {e}")
+            self._started.set()
+            return
+
+        if self.config.worker_threads > 0:
+            self._workers = ThreadPoolExecutor(self.config.worker_threads, thread_name_prefix="MockEditorWorker")
+        self._game_thread = threading.Thread(target=self._run_game_thread, name="MockEditorGameThread", daemon=True)
+        self._game_thread.start()
+        print(f"[MockEditor] Listening on {self.config.host}:{self.config.port} "
+              f"(frame {self.config.frame_ms} ms, budget {self.config.frame_budget_ms} ms)")
+        self._started.set()
+
+        try:
+            self.loop.run_forever()
+        finally:
+            self._server.close()
+            for conn in list(self._connections.values()):
+                conn.closed = True
+                conn.writer.close()
+            self.loop.close()
+
+    # ------------------------------------------------------------------ I/O 线程
+
+    async def _handle_client(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter):
+        if len(self._connections) >= self.config.max_connections:
+            writer.close()
+            return
+
+        conn = MockConnection(self, self._next_conn_id, writer)
+        self._next_conn_id += 1
+        self._connections[conn.id] = conn
+        sock = writer.get_extra_info("socket")
+        if sock is not None:
+            import socket
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+        buffer = bytearray()
+        try:
+            while not self._stop.is_set():
+                data = await reader.read(1024 * 1024)
+                if not data:
+                    break
+                buffer += data
+                if not self._parse_messages(conn, buffer):
+                    break
+                await writer.drain()
+        except (ConnectionError, asyncio.IncompleteReadError):
+            pass
+        finally:
+            conn.closed = True
+            self._connections.pop(conn.id, None)
+            for request in conn.in_flight.values():
+                request.cancelled = True
+            writer.close()
+
+    def _parse_messages(self, conn: MockConnection, buffer: bytearray) -> bool:
+        """在缓冲区上按偏移解析帧，处理完后一次性移除已消费的字节"""
+        offset = 0
+        with memoryview(buffer) as view:
+            while len(buffer) - offset >= 4:
+                size = int.from_bytes(view[offset:offset + 4], 'big')
+                if size > MAX_MESSAGE_SIZE:
+                    print(f"[MockEditor] Message size {size} exceeds limit, closing connection {conn.id}")
+                    return False
+                if len(buffer) - offset - 4 < size:
+                    break
+
+                body = view[offset + 4:offset + 4 + size]
+                offset += 4 + size
+                start = time.perf_counter()
+                try:
+                    if MCPMessagePack.is_msgpack_frame(body):
+                        message = MCPMessagePack.unpackb(body)
+                    else:
+                        message = json.loads(bytes(body))
+                except ValueError as e:
+                    print(f"[MockEditor] Decode error: {e}")
+                    continue
+                finally:
+                    body.release()
+
+                if isinstance(message, dict):
+                    self.record_received(message.get("type"), 4 + size, time.perf_counter() - start)
+                    self._handle_incoming(conn, message)
+        if offset:
+            del buffer[:offset]
+        return True
+
+    def _handle_incoming(self, conn: MockConnection, message: Dict[str, Any]):
+        msg_type = message.get("type", "")
+        request_id = message.get("id")
+
+        if msg_type in ("ping", "heartbeat"):
+            conn.send(self._make_state_message("pong" if msg_type == "ping" else "heartbeat", request_id), msg_type)
+            return
+        if msg_type == "hello":
+            self._handle_hello(conn, message, request_id)
+            return
+        if msg_type == "cancel":
+            target = message.get("target")
+            request = conn.in_flight.pop(target, None)
+            if request is not None:
+                request.cancelled = True
+            conn.send({"type": "result", "id": request_id, "success": True,
+                       "target": target, "cancelled": request is not None}, msg_type)
+            return
+        if msg_type == "metrics":
+            reply = self.get_metrics()
+            reply.update({"type": "metrics", "id": request_id, "success": True,
+                          "connections": len(self._connections)})
+            if message.get("reset"):
+                self._reset_metrics()
+            conn.send(reply, msg_type)
+            return
+
+        request = MockRequest(conn=conn, type=msg_type, id=request_id, message=message,
+                              receive_time=time.perf_counter(), priority=self._get_priority(msg_type, message))
+        deadline_ms = message.get("deadline_ms") or 0
+        if deadline_ms > 0:
+            request.deadline = request.receive_time + deadline_ms / 1000.0
+        if request_id:
+            conn.in_flight[request_id] = request
+
+        if msg_type in WORKER_TYPES and self._workers is not None and self._active_workers < self.config.worker_threads:
+            self._active_workers += 1
+            self._workers.submit(self._execute_on_worker, request)
+            return
+        self._incoming.put(request)
+
+    def _handle_hello(self, conn: MockConnection, message: Dict[str, Any], request_id: Optional[str]):
+        use_msgpack = "msgpack" in (message.get("encodings") or [])
+        compression = "none"
+        for name in message.get("compression") or []:
+            if name == "zlib" or (name == "lz4" and lz4_block is not None):
+                compression = name
+                break
+        if message.get("compression_threshold"):
+            conn.compression_threshold = int(message["compression_threshold"])
+
+        # 应答总是 JSON，之后才切换编码；不提供共享内存传输
+        conn.send({"type": "hello", "id": request_id, "server": "mock",
+                   "encoding": "msgpack" if use_msgpack else "json",
+                   "compression": compression, "compression_threshold": conn.compression_threshold}, "hello")
+        conn.msgpack = use_msgpack
+        conn.compression = None if compression == "none" else compression
+
+    def _make_state_message(self, msg_type: str, request_id: Optional[str]) -> Dict[str, Any]:
+        since_tick = time.perf_counter() - self._last_tick if self._last_tick > 0 else 0.0
+        executing = self._busy
+        stalled = not executing and since_tick * 1000.0 >= self.config.stall_threshold_ms
+        message = {
+            "type": msg_type,
+            "id": request_id,
+            "timestamp": time.time(),
+            "state": "executing" if executing else "stalled" if stalled else "idle",
+            "busy": executing or stalled,
+            "frame": self.frame,
+            "since_tick_ms": since_tick * 1000.0,
+            "queued": self._incoming.qsize() + sum(len(q) for q in self._scheduled),
+            "worker_requests": self._active_workers,
+        }
+        current_type = self._current_type
+        if executing and current_type:
+            message["request_type"] = current_type
+            message["request_ms"] = (time.perf_counter() - self._current_start) * 1000.0
+        return message
+
+    @staticmethod
+    def _get_priority(msg_type: str, message: Dict[str, Any]) -> int:
+        priority = PRIORITY_NORMAL
+        if msg_type in ("ping", "get_state", "subscribe", "unsubscribe"):
+            priority = PRIORITY_HIGH
+        elif msg_type in ("execute", "execute_file"):
+            priority = PRIORITY_LOW
+        # 与 FMCPRequestScheduler 一致：客户端只能降低优先级
+        return max(priority, PRIORITY_NAMES.get(message.get("priority"), priority))
+
+    # ------------------------------------------------------------------ 游戏线程
+
+    def _run_game_thread(self):
+        frame_seconds = self.config.frame_ms / 1000.0
+        next_frame = time.perf_counter()
+        self._next_stall = next_frame + self.config.stall_every if self.config.stall_every > 0 else 0.0
+
+        while not self._stop.is_set():
+            frame_start = time.perf_counter()
+            self.frame += 1
+            self._last_tick = frame_start
+
+            while True:
+                try:
+                    request = self._incoming.get_nowait()
+                except queue.Empty:
+                    break
+                self._scheduled[request.priority].append(request)
+
+            self._execute_scheduled(frame_start)
+            self._advance_streams(frame_start)
+            self._push_events()
+
+            if self._next_stall and frame_start >= self._next_stall:
+                # 模拟着色器编译等长时间阻塞，heartbeat 应报告 stalled
+                time.sleep(self.config.stall_ms / 1000.0)
+                self._next_stall = time.perf_counter() + self.config.stall_every
+
+            next_frame += frame_seconds
+            sleep_time = next_frame - time.perf_counter()
+            if sleep_time > 0:
+                time.sleep(sleep_time)
+            else:
+                next_frame = time.perf_counter()
+
+    def _execute_scheduled(self, frame_start: float):
+        budget_end = frame_start + self.config.frame_budget_ms / 1000.0
+        executed_any = False
+        for priority, pending in enumerate(self._scheduled):
+            while pending:
+                if priority != PRIORITY_HIGH and executed_any and time.perf_counter() >= budget_end:
+                    return
+                request = pending.popleft()
+                if request.id:
+                    request.conn.in_flight.pop(request.id, None)
+                if request.conn.closed:
+                    continue
+
+                now = time.perf_counter()
+                if request.cancelled:
+                    request.conn.send_threadsafe(self._make_cancelled(request.id), request.type)
+                    continue
+                if request.deadline and now > request.deadline:
+                    self.record_expired(request.type, now - request.receive_time)
+                    request.conn.send_threadsafe(self._make_error(
+                        request.id, f"Request expired after waiting {(now - request.receive_time) * 1000.0:.0f} ms in the queue"), request.type)
+                    continue
+
+                self._busy = True
+                self._current_type = request.type
+                self._current_start = now
+                response = self._handle_request(request)
+                self._busy = False
+                self._current_type = None
+                self.record_executed(request.type, now - request.receive_time, time.perf_counter() - now)
+                executed_any = priority != PRIORITY_HIGH or executed_any
+                if response is not None:
+                    request.conn.send_threadsafe(response, request.type)
+
+    def _execute_on_worker(self, request: MockRequest):
+        try:
+            start = time.perf_counter()
+            response = self._handle_request(request)
+            self.record_executed(request.type, start - request.receive_time, time.perf_counter() - start)
+            if response is not None and not request.conn.closed:
+                request.conn.send_threadsafe(response, request.type)
+        finally:
+            if request.id:
+                request.conn.in_flight.pop(request.id, None)
+            self._active_workers -= 1
+
+    def _handle_request(self, request: MockRequest) -> Optional[Dict[str, Any]]:
+        """合成处理器，返回 None 表示结果稍后发送（dump_stream）"""
+        msg_type = request.type
+        message = request.message
+
+        if msg_type == "get_state":
+            return self._make_state_message("state", request.id)
+        if msg_type == "batch":
+            return self._handle_batch(request)
+        if msg_type == "dump_stream":
+            time.sleep(self.config.get_delay_seconds(msg_type))
+            self._streams.append(MockStream(
+                request=request,
+                chunk_chars=int(message.get("chunk_chars", 16384)),
+                total=int(message.get("mock_chunks", self.config.stream_chunks))))
+            return None
+        if msg_type == "subscribe":
+            topics = message.get("topics") or []
+            self._subscriptions[request.id] = (request.conn, list(topics))
+            return {"type": "result", "id": request.id, "success": True,
+                    "subscription": request.id, "topics": topics}
+        if msg_type == "unsubscribe":
+            target = message.get("target")
+            removed = [sub_id for sub_id, (conn, _) in self._subscriptions.items()
+                       if conn is request.conn and (not target or sub_id == target)]
+            for sub_id in removed:
+                del self._subscriptions[sub_id]
+            return {"type": "result", "id": request.id, "success": True, "target": target, "removed": len(removed)}
+
+        time.sleep(self.config.get_delay_seconds(msg_type))
+        output_bytes = int(message.get("mock_output_bytes", self.config.output_bytes))
+        return {"type": "result", "id": request.id, "success": True,
+                "output": "x" * output_bytes, "error": None, "logs": None}
+
+    def _handle_batch(self, request: MockRequest) -> Dict[str, Any]:
+        entries = request.message.get("requests") or []
+        if len(entries) > MAX_BATCH_SIZE:
+            return self._make_error(request.id, f"batch has {len(entries)} requests, the limit is {MAX_BATCH_SIZE}")
+
+        stop_on_error = bool(request.message.get("stop_on_error"))
+        results = []
+        failed_index = None
+        for index, entry in enumerate(entries):
+            entry_id = entry.get("id") or f"{request.id}#{index}"
+            if stop_on_error and failed_index is not None:
+                result = self._make_error(entry_id, "Skipped after an earlier request in the batch failed")
+                result["skipped"] = True
+            elif entry.get("type") in ("batch", "dump_stream", "hello", "cancel"):
+                result = self._make_error(entry_id, f"'{entry.get('type')}' cannot be used inside a batch")
+            else:
+                sub_request = MockRequest(conn=request.conn, type=entry.get("type", ""), id=entry_id,
+                                          message=entry, receive_time=request.receive_time)
+                result = self._handle_request(sub_request)
+            # get_state 的结果是状态消息，没有 success 字段
+            if result.get("success", True) is False and failed_index is None and not result.get("skipped"):
+                failed_index = index
+            results.append(result)
+
+        response = {"type": "result", "id": request.id, "success": failed_index is None,
+                    "completed": len(results), "results": results}
+        if failed_index is not None:
+            response["failed_index"] = failed_index
+        return response
+
+    def _advance_streams(self, frame_start: float):
+        """每个导出每帧推进一个 chunk，连接发送队列已满时暂停"""
+        for stream in list(self._streams):
+            request = stream.request
+            if request.conn.closed:
+                self._streams.remove(stream)
+                continue
+            if request.cancelled:
+                self._streams.remove(stream)
+                request.conn.send_threadsafe(self._make_cancelled(request.id), request.type)
+                continue
+            if request.conn.is_congested():
+                continue
+
+            time.sleep(self.config.get_delay_seconds("dump_stream"))
+            request.conn.send_threadsafe({"type": "chunk", "id": request.id, "seq": stream.seq,
+                                          "data": "x" * stream.chunk_chars}, request.type)
+            stream.seq += 1
+            if stream.seq >= stream.total:
+                self._streams.remove(stream)
+                request.conn.send_threadsafe({"type": "result", "id": request.id, "success": True,
+                                              "output": None, "error": None, "logs": None, "chunks": stream.seq}, request.type)
+
+    def _push_events(self):
+        """为 log 订阅生成合成事件，每帧合并为一条消息"""
+        if self.config.events_per_frame <= 0 or not self._subscriptions:
+            return
+        now = time.time()
+        for sub_id, (conn, topics) in list(self._subscriptions.items()):
+            if conn.closed:
+                del self._subscriptions[sub_id]
+                continue
+            if "log" not in topics:
+                continue
+            events = [{"category": "LogMock", "verbosity": "Log", "message": f"frame {self.frame} event {i}", "time": now}
+                      for i in range(self.config.events_per_frame)]
+            conn.send_threadsafe({"type": "event", "subscription": sub_id, "topic": "log",
+                                  "frame": self.frame, "events": events}, "event")
+
+    @staticmethod
+    def _make_error(request_id: Optional[str], error: str) -> Dict[str, Any]:
+        return {"type": "result", "id": request_id, "success": False, "output": None, "error": error, "logs": None}
+
+    @classmethod
+    def _make_cancelled(cls, request_id: Optional[str]) -> Dict[str, Any]:
+        result = cls._make_error(request_id, "Request cancelled")
+        result["cancelled"] = True
+        return result
+
+    # ------------------------------------------------------------------ 统计
+
+    def _reset_metrics(self):
+        with self._metrics_lock:
+            self._metrics: Dict[str, Dict[str, Any]] = {}
+            self._metrics_start = time.time()
+
+    def _type_metrics(self, msg_type: Optional[str]) -> Dict[str, Any]:
+        key = msg_type or "(unknown)"
+        metrics = self._metrics.get(key)
+        if metrics is None:
+            metrics = self._metrics[key] = {
+                "executed": 0, "expired": 0, "messages_in": 0, "messages_out": 0, "bytes_in": 0, "bytes_out": 0,
+                "queue_wait": LatencySamples(), "execution": LatencySamples(), "serialization": LatencySamples()}
+        return metrics
+
+    def record_received(self, msg_type: Optional[str], size: int, decode_seconds: float):
+        with self._metrics_lock:
+            metrics = self._type_metrics(msg_type)
+            metrics["messages_in"] += 1
+            metrics["bytes_in"] += size
+            metrics["serialization"].add(decode_seconds)
+
+    def record_sent(self, msg_type: Optional[str], size: int):
+        with self._metrics_lock:
+            metrics = self._type_metrics(msg_type)
+            metrics["messages_out"] += 1
+            metrics["bytes_out"] += size
+
+    def record_executed(self, msg_type: str, queue_wait: float, execution: float):
+        with self._metrics_lock:
+            metrics = self._type_metrics(msg_type)
+            metrics["executed"] += 1
+            metrics["queue_wait"].add(queue_wait)
+            metrics["execution"].add(execution)
+
+    def record_expired(self, msg_type: str, queue_wait: float):
+        with self._metrics_lock:
+            metrics = self._type_metrics(msg_type)
+            metrics["expired"] += 1
+            metrics["queue_wait"].add(queue_wait)
+
+    def get_metrics(self) -> Dict[str, Any]:
+        """与原生端点 {"type": "metrics"} 相同的结构"""
+        with self._metrics_lock:
+            types = {}
+            for key, metrics in self._metrics.items():
+                types[key] = {name: value.to_dict() if isinstance(value, LatencySamples) else value
+                              for name, value in metrics.items()}
+            return {"uptime": time.time() - self._metrics_start, "types": types}
+
+
+def _parse_delays(values: List[str]) -> Dict[str, float]:
+    delays = dict(DEFAULT_DELAYS_MS)
+    for value in values or []:
+        name, _, ms = value.partition("=")
+        if not ms:
+            raise argparse.ArgumentTypeError(f"--delay expects type=ms, got '{value}'")
+        delays[name.strip()] = float(ms)
+    return delays
+
+
+def build_arg_parser() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(description="Mock UE editor endpoint for load-testing the MCP forwarder protocol")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8100)
+    parser.add_argument("--frame-ms", type=float, default=16.7, help="Game-thread frame interval")
+    parser.add_argument("--budget-ms", type=float, default=5.0, help="Per-frame request budget")
+    parser.add_argument("--delay", action="append", default=[], metavar="TYPE=MS",
+                        help="Execution time per request type, e.g. execute=5 (repeatable; 'default' for unlisted types)")
+    parser.add_argument("--jitter", type=float, default=0.0, help="Random execution-time jitter, e.g. 0.2 for +-20%%")
+    parser.add_argument("--output-bytes", type=int, default=64, help="Default result output size")
+    parser.add_argument("--stream-chunks", type=int, default=8, help="Chunks per dump_stream")
+    parser.add_argument("--workers", type=int, default=4, help="Worker threads for log_tail/captured_logs/find_assets")
+    parser.add_argument("--stall-every", type=float, default=0.0, help="Simulate a game-thread stall every N seconds")
+    parser.add_argument("--stall-ms", type=float, default=2000.0, help="Length of a simulated stall")
+    parser.add_argument("--events-per-frame", type=int, default=0, help="Synthetic log events per frame for each log subscription")
+    return parser
+
+
+def config_from_args(args: argparse.Namespace) -> MockEditorConfig:
+    return MockEditorConfig(
+        host=args.host,
+        port=args.port,
+        frame_ms=args.frame_ms,
+        frame_budget_ms=args.budget_ms,
+        delays_ms=_parse_delays(args.delay),
+        jitter=args.jitter,
+        output_bytes=args.output_bytes,
+        stream_chunks=args.stream_chunks,
+        worker_threads=args.workers,
+        stall_every=args.stall_every,
+        stall_ms=args.stall_ms,
+        events_per_frame=args.events_per_frame,
+    )
+
+
+def main():
+    args = build_arg_parser().parse_args()
+    MockEditor(config_from_args(args)).run_forever()
+
+
+if __name__ == "__main__":
+    main()
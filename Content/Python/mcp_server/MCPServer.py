@@ -40,7 +40,7 @@ class MCPServer:
                 log(f"call_tool name: {name} arg:{arguments}")
                 
                 if name == "execute_command":
-                    result = CodeExecutor.execute_code(arguments.get('code', ''))
+                    result = CodeExecutor.execute_code(arguments.get('code', ''), session=arguments.get('session'))
                     return result.to_mcp_content()
                     
                 elif name == "excute_file":
@@ -0,0 +1,112 @@
+"""
+MCP 端点共享内存环形缓冲的客户端 - 不依赖unreal
+
+与 C++ FMCPSharedMemoryRing 对应。同机客户端在 hello 中请求 "shm": true，
+端点应答 {"shm": {"name", "size", "threshold"}}；之后大帧的负载写入共享内存，
+socket 上只收到 6 字节的引用帧（0xC1 0x80 + u32 长度），按顺序调用 SharedMemoryRing.read(长度) 取出负载。
+
+共享区布局（小端序）：
+    [0]  u32 Magic 'MCPR'   [4]  u32 Version
+    [8]  u64 Capacity       [16] u64 WritePos（端点写）   [24] u64 ReadPos（客户端写）
+    [64] 数据区
+"""
+
+import os
+import struct
+from typing import Optional
+
+try:
+    from multiprocessing import shared_memory as _shared_memory
+    SHM_AVAILABLE = True
+except ImportError:
+    _shared_memory = None
+    SHM_AVAILABLE = False
+
+MAGIC = 0x5250434D
+VERSION = 1
+HEADER_SIZE = 64
+_CAPACITY_OFFSET = 8
+_WRITE_POS_OFFSET = 16
+_READ_POS_OFFSET = 24
+
+# 引用帧：压缩帧标记 + 该算法值表示负载位于共享内存
+SHARED_MEMORY_REFERENCE = 0x80
+
+
+class SharedMemoryRing:
+    """端点创建的共享内存环形缓冲（只读消费端）"""
+
+    def __init__(self, name: str):
+        if not SHM_AVAILABLE:
+            raise RuntimeError("multiprocessing.shared_memory is not available")
+        self._shm = _open_shared_memory(name)
+        self._buf = self._shm.buf
+
+        magic, version, capacity = struct.unpack_from("<IIQ", self._buf, 0)
+        if magic != MAGIC or version != VERSION:
+            self.close()
+            raise ValueError(f"Unexpected shared memory header: magic=0x{magic:08x}, version={version}")
+        if HEADER_SIZE + capacity > len(self._buf):
+            self.close()
+            raise ValueError(f"Shared memory region too small for capacity {capacity}")
+
+        self.capacity = capacity
+        self._read_pos = struct.unpack_from("<Q", self._buf, _READ_POS_OFFSET)[0]
+
+    def read(self, size: int) -> bytes:
+        """按顺序读取下一段负载并释放其空间"""
+        write_pos = struct.unpack_from("<Q", self._buf, _WRITE_POS_OFFSET)[0]
+        if write_pos - self._read_pos < size:
+            raise ValueError(f"Shared memory underrun: {write_pos - self._read_pos} bytes available, {size} referenced")
+
+        offset = self._read_pos % self.capacity
+        first = min(size, self.capacity - offset)
+        start = HEADER_SIZE + offset
+        if first == size:
+            data = bytes(self._buf[start:start + size])
+        else:
+            data = bytes(self._buf[start:start + first]) + bytes(self._buf[HEADER_SIZE:HEADER_SIZE + size - first])
+
+        # 拷贝完成后再发布读位置，端点才会覆盖这段空间
+        self._read_pos += size
+        struct.pack_into("<Q", self._buf, _READ_POS_OFFSET, self._read_pos)
+        return data
+
+    def close(self):
+        """解除映射（共享内存由端点在连接关闭时删除）"""
+        if self._shm is None:
+            return
+        self._buf = None
+        try:
+            self._shm.close()
+        except (BufferError, OSError):
+            pass
+        self._shm = None
+
+
+def _open_shared_memory(name: str):
+    """打开已存在的共享内存，不交给 resource_tracker 管理（否则客户端退出时会删除端点的共享内存）"""
+    try:
+        return _shared_memory.SharedMemory(name=name, create=False, track=False)
+    except TypeError:
+        # Python 3.13 之前没有 track 参数，打开后手动取消跟踪（仅 POSIX 会跟踪）
+        shm = _shared_memory.SharedMemory(name=name, create=False)
+        if os.name != "posix":
+            return shm
+        try:
+            from multiprocessing import resource_tracker
+            resource_tracker.unregister(shm._name, "shared_memory")
+        except (ImportError, AttributeError, KeyError):
+            pass
+        return shm
+
+
+def open_ring(description: Optional[dict]) -> Optional[SharedMemoryRing]:
+    """根据 hello 应答中的 "shm" 描述打开环形缓冲，失败时返回 None（继续只用 socket）"""
+    if not description or not SHM_AVAILABLE:
+        return None
+    try:
+        return SharedMemoryRing(description["name"])
+    except (KeyError, OSError, ValueError, RuntimeError) as e:
+        print(f"[MCPSharedMemory] Failed to open shared memory ring: {e}")
+        return None
@@ -23,6 +23,7 @@ import sys
 import tempfile
 import os
 import subprocess
+import zlib
 from typing import Optional, Dict, Any, List, Callable
 from enum import Enum
 from dataclasses import dataclass
@@ -39,6 +40,8 @@ try:
         get_mcp_tools
     )
     from .MCPConfig import load_config, get_mcp_port, get_mcp_host, get_editor_port, get_editor_host
+    from . import MCPMessagePack
+    from . import MCPSharedMemory
 except ImportError:
     from MCPCore import (
         MCP_AVAILABLE, MCP_IMPORT_ERRORS,
@@ -50,6 +53,21 @@ except ImportError:
         get_mcp_tools
     )
     from MCPConfig import load_config, get_mcp_port, get_mcp_host, get_editor_port, get_editor_host
+    import MCPMessagePack
+    import MCPSharedMemory
+
+# LZ4 响应解压（可选依赖，未安装时只协商 zlib）
+try:
+    import lz4.block as lz4_block
+    LZ4_AVAILABLE = True
+except ImportError:
+    lz4_block = None
+    LZ4_AVAILABLE = False
+
+# 压缩帧：标记字节 + 算法(u8) + 原始长度(u32 大端序) + 压缩数据，与 C++ FMCPEndpoint 一致
+COMPRESSED_FRAME_MARKER = 0xC1
+COMPRESSION_ZLIB = 1
+COMPRESSION_LZ4 = 2
 
 # CORS中间件
 try:
@@ -66,15 +84,22 @@ class EditorState(Enum):
     CONNECTING = "connecting"      # 正在连接
     CONNECTED = "connected"        # 已连接
     EXECUTING = "executing"        # 正在执行请求
+    BUSY = "busy"                  # 已连接，但编辑器游戏线程忙碌或停滞（心跳报告）
 
 
 @dataclass
 class ConnectionConfig:
     """连接配置"""
-    reconnect_interval: float = 2.0      # 重连间隔（秒）
+    reconnect_interval: float = 2.0      # 重连间隔（秒），连续失败时指数退避
+    max_reconnect_interval: float = 30.0 # 重连退避的最大间隔（秒）
+    heartbeat_interval: float = 5.0      # 心跳间隔（秒），0 关闭
+    busy_timeout: float = 600.0          # 编辑器报告忙碌时，请求超时后最多额外等待的时间（秒）
     connect_timeout: float = 5.0         # 连接超时（秒）
     request_timeout: float = 60.0        # 请求超时（秒）
     recv_buffer_size: int = 65536        # 接收缓冲区大小
+    encoding: str = "auto"               # 消息编码：auto（有 msgpack 扩展时协商 msgpack）/ json / msgpack
+    compression: str = "auto"            # 响应压缩：auto（有 lz4 扩展时用 lz4，否则 zlib）/ lz4 / zlib / none
+    shared_memory: str = "auto"          # 共享内存传输：auto（编辑器在本机时请求）/ off
 
 
 class EditorConnection:
@@ -110,8 +135,24 @@ class EditorConnection:
         self._state = EditorState.DISCONNECTED
         self._request_counter = 0
         self._pending_requests: Dict[str, asyncio.Future] = {}
-        self._recv_buffer = b""
+        # 分块响应：请求ID -> 已收到的 chunk / chunk 回调
+        self._stream_chunks: Dict[str, List[str]] = {}
+        self._chunk_callbacks: Dict[str, Callable[[str], None]] = {}
+        # 进度消息回调，以及各请求最近一次收到 progress/partial/chunk 的时间（用于按无响应时长计算超时）
+        self._progress_callbacks: Dict[str, Callable[[Dict[str, Any]], None]] = {}
+        self._request_activity: Dict[str, float] = {}
+        # 事件订阅：订阅ID -> 回调，收到 {"type": "event"} 时调用；断开连接后订阅失效
+        self._event_callbacks: Dict[str, Callable[[Dict[str, Any]], None]] = {}
+        self._recv_buffer = bytearray()
+        # 发送请求使用的编码，hello 协商成功后切换为 msgpack；接收时按帧首字节判断
+        self._encoding = "json"
+        # hello 协商的共享内存环形缓冲，大帧的负载从这里读取
+        self._shm_ring: Optional[MCPSharedMemory.SharedMemoryRing] = None
         self._lock = asyncio.Lock()
+        # 心跳不经过 _lock（请求等待期间也要能发送），socket 写入单独加锁以免帧交错
+        self._send_lock = asyncio.Lock()
+        # 最近一次心跳应答（原生端点带 busy/frame/since_tick_ms/queued）
+        self.last_heartbeat: Optional[Dict[str, Any]] = None
         self._receive_task: Optional[asyncio.Task] = None
         
         # 状态变化回调
@@ -126,7 +167,7 @@ class EditorConnection:
     @property
     def is_connected(self) -> bool:
         """是否已连接"""
-        return self._state in (EditorState.CONNECTED, EditorState.EXECUTING)
+        return self._state in (EditorState.CONNECTED, EditorState.EXECUTING, EditorState.BUSY)
     
     def _set_state(self, new_state: EditorState):
         """设置状态并触发回调"""
@@ -183,11 +224,14 @@ class EditorConnection:
                 self._set_state(EditorState.DISCONNECTED)
                 return False
             
-            self._recv_buffer = b""
+            self._recv_buffer = bytearray()
+            self._encoding = "json"
+            self.last_heartbeat = None
             self._set_state(EditorState.CONNECTED)
             print(f"[EditorConnection] Connected to editor at {self.host}:{self.port}")
             
             self._receive_task = asyncio.create_task(self._receive_loop())
+            await self._negotiate_encoding()
             
             return True
             
@@ -197,6 +241,78 @@ class EditorConnection:
             self._set_state(EditorState.DISCONNECTED)
             return False
     
+    def _supported_compression(self) -> List[str]:
+        """按偏好顺序列出可以解压的算法"""
+        wanted = self.config.compression
+        if wanted == "none":
+            return []
+        if wanted == "lz4":
+            return ["lz4"] if LZ4_AVAILABLE else []
+        if wanted == "zlib":
+            return ["zlib"]
+        return (["lz4"] if LZ4_AVAILABLE else []) + ["zlib"]
+    
+    async def _negotiate_encoding(self):
+        """通过 hello 协商 MessagePack 编码和响应压缩，失败或对端不支持时继续使用未压缩的 JSON"""
+        wanted = self.config.encoding
+        use_msgpack = wanted == "msgpack" or (wanted == "auto" and MCPMessagePack.HAS_NATIVE)
+        compression = self._supported_compression()
+        use_shm = (self.config.shared_memory != "off" and MCPSharedMemory.SHM_AVAILABLE
+                   and self.host in ("127.0.0.1", "localhost", "::1"))
+        if not use_msgpack and not compression and not use_shm:
+            return
+        
+        try:
+            response = await self.send_request({
+                "type": "hello",
+                "encodings": ["msgpack", "json"] if use_msgpack else ["json"],
+                "compression": compression,
+                "shm": use_shm
+            }, timeout=self.config.connect_timeout)
+            print(f"[EditorConnection] Message encoding: {self._encoding}, "
+                  f"compression: {response.get('compression', 'none')}, "
+                  f"shared memory: {'on' if self._shm_ring else 'off'}")
+        except Exception as e:
+            if self.debug:
+                print(f"[DEBUG][EditorConnection] Negotiation failed, using uncompressed json: {e}")
+    
+    def _apply_hello(self, message: Dict[str, Any]):
+        """应用 hello 应答：之后发出的请求使用协商的编码，打开共享内存；
+        在解析循环中立即执行，同一批数据中后续的引用帧即可从共享内存读取"""
+        self._encoding = "msgpack" if message.get("encoding") == "msgpack" else "json"
+        if self._shm_ring is not None:
+            self._shm_ring.close()
+        self._shm_ring = MCPSharedMemory.open_ring(message.get("shm"))
+    
+    def _decompress_frame(self, body: memoryview) -> bytes:
+        """解压压缩帧（或读取共享内存引用帧），返回原始帧内容"""
+        if len(body) < 6:
+            raise ValueError("Truncated compressed frame")
+        algorithm = body[1]
+        raw_size = int.from_bytes(body[2:6], 'big')
+        data = body[6:]
+        if algorithm == MCPSharedMemory.SHARED_MEMORY_REFERENCE:
+            if self._shm_ring is None:
+                raise ValueError("Shared memory frame without a negotiated ring")
+            return self._shm_ring.read(raw_size)
+        if algorithm == COMPRESSION_LZ4 and lz4_block is not None:
+            raw = lz4_block.decompress(data, uncompressed_size=raw_size)
+        elif algorithm == COMPRESSION_ZLIB:
+            raw = zlib.decompress(data)
+        else:
+            raise ValueError(f"Unsupported frame compression {algorithm}")
+        if len(raw) != raw_size:
+            raise ValueError(f"Decompressed size mismatch: {len(raw)} != {raw_size}")
+        return raw
+    
+    def _encode_frame(self, message: Dict[str, Any]) -> bytes:
+        """编码一条消息（含 4 字节长度前缀）"""
+        if self._encoding == "msgpack":
+            data = MCPMessagePack.packb(message)
+        else:
+            data = json.dumps(message, ensure_ascii=False).encode('utf-8')
+        return len(data).to_bytes(4, 'big') + data
+    
     def _close_socket(self):
         """关闭socket"""
         if self._socket:
@@ -218,8 +334,13 @@ class EditorConnection:
             if not future.done():
                 future.set_exception(ConnectionError("Disconnected from editor"))
         self._pending_requests.clear()
+        self._event_callbacks.clear()
         
-        self._recv_buffer = b""
+        self._recv_buffer = bytearray()
+        self._encoding = "json"
+        if self._shm_ring is not None:
+            self._shm_ring.close()
+            self._shm_ring = None
         self._set_state(EditorState.DISCONNECTED)
     
     async def _receive_loop(self):
@@ -263,21 +384,41 @@ class EditorConnection:
                 break
     
     async def _parse_messages(self):
-        """解析接收到的消息"""
-        while len(self._recv_buffer) >= 4:
-            msg_len = int.from_bytes(self._recv_buffer[:4], 'big')
-            
-            if len(self._recv_buffer) < 4 + msg_len:
-                break
-            
-            msg_data = self._recv_buffer[4:4 + msg_len]
-            self._recv_buffer = self._recv_buffer[4 + msg_len:]
-            
-            try:
-                message = json.loads(msg_data.decode('utf-8'))
-                await self._handle_message(message)
-            except json.JSONDecodeError as e:
-                print(f"[EditorConnection] JSON decode error: {e}")
+        """解析接收到的消息：在缓冲区上按偏移切片解码，处理完后一次性移除已消费的字节"""
+        buffer = self._recv_buffer
+        offset = 0
+        messages = []
+        
+        with memoryview(buffer) as view:
+            while len(buffer) - offset >= 4:
+                msg_len = int.from_bytes(view[offset:offset + 4], 'big')
+                if len(buffer) - offset - 4 < msg_len:
+                    break
+                
+                body = view[offset + 4:offset + 4 + msg_len]
+                offset += 4 + msg_len
+                try:
+                    if len(body) and body[0] == COMPRESSED_FRAME_MARKER:
+                        raw = self._decompress_frame(body)
+                        body.release()
+                        body = memoryview(raw)
+                    if MCPMessagePack.is_msgpack_frame(body):
+                        message = MCPMessagePack.unpackb(body)
+                    else:
+                        message = json.loads(bytes(body))
+                    if isinstance(message, dict) and message.get("type") == "hello":
+                        self._apply_hello(message)
+                    messages.append(message)
+                except (ValueError, zlib.error) as e:
+                    print(f"[EditorConnection] Message decode error: {e}")
+                finally:
+                    body.release()
+        
+        if offset:
+            del buffer[:offset]
+        
+        for message in messages:
+            await self._handle_message(message)
     
     async def _handle_message(self, message: Dict[str, Any]):
         """处理接收到的消息"""
@@ -287,22 +428,60 @@ class EditorConnection:
             print(f"[DEBUG][EditorConnection] Received message: id={request_id}, type={message.get('type')}")
             print(f"[DEBUG][EditorConnection] Message content: {json.dumps(message, indent=2, ensure_ascii=False)[:500]}")
         
+        if request_id in self._request_activity:
+            self._request_activity[request_id] = time.monotonic()
+        
+        if message.get("type") == "event":
+            # 订阅推送的事件，不对应任何请求
+            callback = self._event_callbacks.get(message.get("subscription"))
+            if callback:
+                callback(message)
+            return
+        
+        if message.get("type") in ("progress", "partial"):
+            # 进度和部分输出只刷新超时，不完成请求
+            callback = self._progress_callbacks.get(request_id)
+            if callback:
+                callback(message)
+            return
+        
+        if message.get("type") == "chunk" and request_id in self._stream_chunks:
+            # 分块数据，最终 result 到达前不完成请求
+            data = message.get("data", "")
+            self._stream_chunks[request_id].append(data)
+            callback = self._chunk_callbacks.get(request_id)
+            if callback:
+                callback(data)
+            return
+        
         if request_id and request_id in self._pending_requests:
             future = self._pending_requests.pop(request_id)
             if not future.done():
                 future.set_result(message)
             
-            if self._state == EditorState.EXECUTING:
+            if self._state == EditorState.EXECUTING and message.get("type") != "heartbeat":
                 self._set_state(EditorState.CONNECTED)
     
     async def send_request(self, request: Dict[str, Any], 
-                          timeout: float = None) -> Dict[str, Any]:
+                          timeout: float = None,
+                          on_chunk: Callable[[str], None] = None,
+                          on_progress: Callable[[Dict[str, Any]], None] = None,
+                          on_event: Callable[[Dict[str, Any]], None] = None) -> Dict[str, Any]:
         """
         发送请求并等待响应
         
+        超时按编辑器无响应的时长计算：每收到该请求的 progress/partial/chunk 消息都会重新计时，
+        长时间运行但持续报告进度的操作不会超时。
+        
         Args:
             request: 请求字典
             timeout: 超时时间（秒）
+            on_chunk: 收到分块数据时的回调；指定后 chunk 会被收集，
+                      并在最终响应的 output 中拼接返回
+            on_progress: 收到 progress/partial 消息时的回调；指定后请求执行期间的日志
+                         会以 {"type": "partial", "stream": "log"} 逐步发送
+            on_event: subscribe 请求的事件回调，以请求 ID 作为订阅 ID 在发送前登记，
+                      订阅失败时移除
             
         Returns:
             响应字典
@@ -316,6 +495,11 @@ class EditorConnection:
             self._request_counter += 1
             request_id = f"req_{self._request_counter}_{int(time.time() * 1000)}"
             request["id"] = request_id
+            # 客户端放弃后编辑器端不必再执行仍在排队的请求（Python 转发器会忽略该字段）；
+            # 编辑器忙碌时客户端最多再等 busy_timeout，截止时间相应放宽
+            request.setdefault("deadline_ms", int((timeout + self.config.busy_timeout) * 1000))
+            if on_progress is not None:
+                request["progress"] = True
             
             if self.debug:
                 print(f"[DEBUG][EditorConnection] Sending request: id={request_id}, type={request.get('type')}")
@@ -323,34 +507,116 @@ class EditorConnection:
             
             future = asyncio.get_event_loop().create_future()
             self._pending_requests[request_id] = future
+            if on_chunk is not None:
+                self._stream_chunks[request_id] = []
+                self._chunk_callbacks[request_id] = on_chunk
+            if on_progress is not None:
+                self._progress_callbacks[request_id] = on_progress
+            if on_event is not None:
+                self._event_callbacks[request_id] = on_event
+            self._request_activity[request_id] = time.monotonic()
             
-            if request.get("type") in ("execute", "execute_file"):
+            if request.get("type") in ("execute", "execute_file") and self._state != EditorState.BUSY:
                 self._set_state(EditorState.EXECUTING)
             
             try:
-                data = json.dumps(request, ensure_ascii=False).encode('utf-8')
-                length_prefix = len(data).to_bytes(4, 'big')
+                await self._send_frame(request)
                 
-                loop = asyncio.get_event_loop()
-                await loop.sock_sendall(self._socket, length_prefix + data)
-                
-                response = await asyncio.wait_for(future, timeout=timeout)
+                response = await self._wait_response(request_id, future, timeout)
                 
                 if self.debug:
                     print(f"[DEBUG][EditorConnection] Received response for {request_id}")
                 
+                chunks = self._stream_chunks.get(request_id)
+                if chunks and response.get("output") is None:
+                    response["output"] = "".join(chunks)
+                if on_event is not None and not response.get("success"):
+                    self._event_callbacks.pop(request_id, None)
+                
                 return response
                 
             except asyncio.TimeoutError:
                 self._pending_requests.pop(request_id, None)
+                self._event_callbacks.pop(request_id, None)
                 if self._state == EditorState.EXECUTING:
                     self._set_state(EditorState.CONNECTED)
+                # 通知编辑器停止执行，避免被放弃的请求继续占用游戏线程
+                await self._send_cancel(request_id)
                 raise TimeoutError(f"Request {request_id} timed out after {timeout}s")
+            except asyncio.CancelledError:
+                self._pending_requests.pop(request_id, None)
+                self._event_callbacks.pop(request_id, None)
+                if self._state == EditorState.EXECUTING:
+                    self._set_state(EditorState.CONNECTED)
+                await asyncio.shield(self._send_cancel(request_id))
+                raise
             except Exception as e:
                 self._pending_requests.pop(request_id, None)
+                self._event_callbacks.pop(request_id, None)
                 if self._state == EditorState.EXECUTING:
                     self._set_state(EditorState.CONNECTED)
                 raise
+            finally:
+                self._stream_chunks.pop(request_id, None)
+                self._chunk_callbacks.pop(request_id, None)
+                self._progress_callbacks.pop(request_id, None)
+                self._request_activity.pop(request_id, None)
+    
+    async def _send_cancel(self, request_id: str):
+        """发送 cancel 消息，不等待应答（应答没有对应的 pending 请求，会被忽略）"""
+        if not self._socket:
+            return
+        try:
+            await self._send_frame({
+                "type": "cancel",
+                "id": f"cancel_{request_id}",
+                "target": request_id
+            })
+        except (OSError, ConnectionError) as e:
+            if self.debug:
+                print(f"[DEBUG][EditorConnection] Failed to cancel {request_id}: {e}")
+    
+    async def _send_frame(self, message: Dict[str, Any]):
+        """编码并发送一帧"""
+        if not self._socket:
+            raise ConnectionError("Not connected to editor")
+        data = self._encode_frame(message)
+        async with self._send_lock:
+            await asyncio.get_event_loop().sock_sendall(self._socket, data)
+    
+    async def _wait_response(self, request_id: str, future: asyncio.Future, timeout: float) -> Dict[str, Any]:
+        """
+        等待响应，超过 timeout 秒没有收到该请求的任何消息时抛出 asyncio.TimeoutError
+        
+        超时前先发心跳确认编辑器状态：编辑器报告忙碌（执行中、游戏线程停滞或仍有排队请求）时
+        按指数退避继续等待，累计最多 busy_timeout 秒；编辑器空闲或心跳无应答时才算超时。
+        """
+        busy_waited = 0.0
+        backoff = 1.0
+        while True:
+            idle = time.monotonic() - self._request_activity.get(request_id, 0.0)
+            remaining = timeout - idle
+            if remaining <= 0:
+                if future.done():
+                    return future.result()
+                status = await self.heartbeat(timeout=min(5.0, timeout))
+                if not status or not self._is_busy(status) or busy_waited >= self.config.busy_timeout:
+                    raise asyncio.TimeoutError()
+                # 编辑器还活着但忙碌：退避后再检查，期间收到响应会直接返回
+                wait = min(backoff, self.config.busy_timeout - busy_waited)
+                print(f"[EditorConnection] Editor busy ({status.get('state')}, "
+                      f"{status.get('since_tick_ms', 0):.0f} ms since last tick, {status.get('queued', 0)} queued), "
+                      f"waiting {wait:.0f}s more for {request_id}")
+                busy_waited += wait
+                backoff = min(backoff * 2, 30.0)
+                self._request_activity[request_id] = time.monotonic() - timeout + wait
+                continue
+            try:
+                # shield：等待超时不取消 future，期间有进度时继续等待同一个 future
+                return await asyncio.wait_for(asyncio.shield(future), timeout=remaining)
+            except asyncio.TimeoutError:
+                if future.done():
+                    return future.result()
     
     async def ping(self, timeout: float = 5.0) -> bool:
         """发送ping检测连接"""
@@ -360,13 +626,71 @@ class EditorConnection:
         except Exception:
             return False
     
-    async def execute_file(self, file_path: str, timeout: float = None) -> Dict[str, Any]:
+    @staticmethod
+    def _is_busy(status: Dict[str, Any]) -> bool:
+        """心跳应答是否表示编辑器忙碌（Python 转发器的应答没有这些字段，能应答即视为空闲）"""
+        return bool(status.get("busy")) or status.get("queued", 0) > 0
+    
+    async def heartbeat(self, timeout: float = 5.0) -> Optional[Dict[str, Any]]:
+        """
+        发送心跳并返回编辑器状态，不等待进行中的请求（不占用请求锁）
+        
+        原生端点在 I/O 线程直接应答，游戏线程阻塞时也能返回：
+        {"state": "idle" | "executing" | "stalled", "busy", "frame", "since_tick_ms", "queued",
+         "worker_requests", "request_type"?, "request_ms"?}
+        
+        Returns:
+            应答字典，超时或未连接时返回 None
+        """
+        if not self._socket:
+            return None
+        
+        self._request_counter += 1
+        request_id = f"hb_{self._request_counter}_{int(time.time() * 1000)}"
+        future = asyncio.get_event_loop().create_future()
+        self._pending_requests[request_id] = future
+        try:
+            await self._send_frame({"type": "heartbeat", "id": request_id})
+            status = await asyncio.wait_for(future, timeout=timeout)
+        except (asyncio.TimeoutError, OSError, ConnectionError):
+            return None
+        finally:
+            self._pending_requests.pop(request_id, None)
+        
+        if status.get("type") == "error" or status.get("success") is False:
+            # 不认识 heartbeat 的旧版转发器
+            return None
+        
+        self.last_heartbeat = status
+        if self._is_busy(status):
+            if self._state == EditorState.CONNECTED:
+                self._set_state(EditorState.BUSY)
+        elif self._state == EditorState.BUSY:
+            self._set_state(EditorState.CONNECTED)
+        return status
+    
+    async def get_metrics(self, reset: bool = False, timeout: float = 5.0) -> Dict[str, Any]:
+        """
+        获取原生端点按消息类型统计的延迟与吞吐（Python 转发器不支持）
+        
+        返回 {"uptime", "connections", "types": {<type>: {"executed", "expired", "bytes_in", "bytes_out",
+        "queue_wait", "execution", "serialization"}}}，三项耗时各含 count/mean_ms/p50_ms/p90_ms/p99_ms/max_ms。
+        queue_wait 高说明受帧量化或排队影响，execution 高说明耗时在编辑器（Python）中，serialization 高说明负载过大。
+        
+        Args:
+            reset: 返回后清空统计
+        """
+        return await self.send_request({"type": "metrics", "reset": reset}, timeout=timeout)
+    
+    async def execute_file(self, file_path: str, timeout: float = None,
+                           on_progress: Callable[[Dict[str, Any]], None] = None) -> Dict[str, Any]:
         """
         执行Python文件（自动进行mypy类型检查）
         
         Args:
             file_path: Python文件路径
-            timeout: 执行超时时间
+            timeout: 执行超时时间（无进度消息的最长等待时间）
+            on_progress: 进度/部分输出回调，见 send_request
             
         Returns:
             执行结果字典
@@ -389,7 +713,7 @@ class EditorConnection:
         return await self.send_request({
             "type": "execute_file",
             "file": file_path
-        }, timeout=timeout)
+        }, timeout=timeout, on_progress=on_progress)
     
     async def _check_file_with_mypy(self, file_path: str) -> Dict[str, Any]:
         """
@@ -504,12 +828,135 @@ class EditorConnection:
             "format": output_format
         }, timeout=timeout)
     
-    async def _check_code_with_mypy(self, code: str) -> Dict[str, Any]:
+    async def dump_blueprint_properties(self, package_path: str,
+                                        visible_only: bool = False,
+                                        modified_only: bool = False,
+                                        chunk_chars: int = 16384,
+                                        on_chunk: Callable[[str], None] = None,
+                                        timeout: float = None) -> Dict[str, Any]:
+        """
+        分块导出蓝图属性
+        
+        编辑器每帧发送一个 chunk，on_chunk 可在完整结果到达前处理已收到的部分；
+        最终响应的 output 为所有 chunk 拼接后的完整文本。
+        """
+        return await self.send_request({
+            "type": "dump_stream",
+            "package_path": package_path,
+            "visible_only": visible_only,
+            "modified_only": modified_only,
+            "chunk_chars": chunk_chars
+        }, timeout=timeout, on_chunk=on_chunk or (lambda data: None))
+    
+    async def dump_table_rows(self, asset_path: str,
+                              row_filter: str = "",
+                              start_row: int = 0,
+                              max_rows: int = 0,
+                              chunk_rows: int = 200,
+                              on_chunk: Callable[[str], None] = None,
+                              timeout: float = None) -> Dict[str, Any]:
+        """
+        分块导出 DataTable/CurveTable 的行（列式：表头一次，每行一条制表符分隔记录）
+        
+        Args:
+            asset_path: 表资产路径
+            row_filter: 行名通配符过滤（如 "Sword_*"）
+            start_row: 起始行（在过滤后的行中计数）
+            max_rows: 最多返回的行数，0 表示全部
+            chunk_rows: 编辑器每帧发送的行数
+        """
+        return await self.send_request({
+            "type": "dump_stream",
+            "kind": "table",
+            "package_path": asset_path,
+            "row_filter": row_filter,
+            "start_row": start_row,
+            "max_rows": max_rows,
+            "chunk_rows": chunk_rows
+        }, timeout=timeout, on_chunk=on_chunk or (lambda data: None))
+    
+    async def native_request(self, msg_type: str, timeout: float = None, **params) -> Dict[str, Any]:
+        """
+        发送由编辑器 C++ 原生处理器执行的请求（不经过 Python 代码执行）
+        
+        支持的类型：
+            log_tail(lines=100, after=0, category="")  返回 output 和 next（下次作为 after）
+            captured_logs()                            MCP.LogCapture 捕获的日志
+            clear_captured_logs()                      返回并清空捕获的日志（在游戏线程执行）
+            find_assets(path="", class="", recursive=True, max_results=500)
+                                                        每行 "对象路径\t类"；UE5.1+ 的 class 为类路径；
+                                                        只包含磁盘上的资产，未保存的新建资产不在结果中
+            dump_object(path, visible_only=False, modified_only=False)
+            get_property(path, property)                property 可用 "." 访问嵌套结构体/对象
+            set_property(path, property, value)         value 为 UE 导出文本格式
+            tag_exists(tag)
+        
+        log_tail、captured_logs 以及 UE5 上的 find_assets 在编辑器的工作线程执行，游戏线程忙碌时也会立即返回。
+        """
+        request = {"type": msg_type}
+        request.update(params)
+        return await self.send_request(request, timeout=timeout)
+    
+    async def subscribe(self, topics: List[str], on_event: Callable[[Dict[str, Any]], None],
+                        timeout: float = 5.0, **filters) -> str:
+        """
+        订阅编辑器事件（仅原生端点），之后每帧的事件合并为一条消息推送给 on_event
+        
+        Args:
+            topics: log、transaction、selection、asset_saved、pie 的任意组合
+            on_event: 收到 {"type": "event", "subscription", "topic", "frame", "events": [...], "dropped"?} 时调用
+            filters: min_verbosity="Warning"、categories=["LogBlueprint"]、path_prefix="/Game/"、max_items=100
+        
+        Returns:
+            订阅ID，用于 unsubscribe；连接断开后订阅失效，需要重新订阅
+        """
+        request = {"type": "subscribe", "topics": list(topics)}
+        request.update(filters)
+        response = await self.send_request(request, timeout=timeout, on_event=on_event)
+        if not response.get("success"):
+            raise RuntimeError(response.get("error") or "subscribe failed")
+        return response.get("subscription") or request["id"]
+    
+    async def unsubscribe(self, subscription_id: str = None, timeout: float = 5.0) -> int:
+        """取消订阅，不指定 subscription_id 时取消本连接的全部订阅，返回取消的数量"""
+        request = {"type": "unsubscribe"}
+        if subscription_id:
+            request["target"] = subscription_id
+            self._event_callbacks.pop(subscription_id, None)
+        else:
+            self._event_callbacks.clear()
+        response = await self.send_request(request, timeout=timeout)
+        return int(response.get("removed", 0))
+    
+    async def send_batch(self, requests: List[Dict[str, Any]], stop_on_error: bool = False,
+                         timeout: float = None,
+                         on_progress: Callable[[Dict[str, Any]], None] = None) -> Dict[str, Any]:
+        """
+        在编辑器的同一帧内按顺序执行一组请求，只需一次往返
+        
+        Args:
+            requests: 子请求列表，格式与 send_request 相同（id 可省略）；
+                      不能包含 dump_stream、hello、cancel 和嵌套的 batch
+            stop_on_error: 为 True 时第一个失败之后的请求不再执行（结果中 "skipped": true）
+            timeout: 整个 batch 的超时时间（秒）
+            on_progress: 每执行一个子请求收到一次进度回调
+        
+        Returns:
+            {"success", "completed", "failed_index"?, "results": [...]}，results 与 requests 一一对应
+        """
+        return await self.send_request({
+            "type": "batch",
+            "requests": list(requests),
+            "stop_on_error": stop_on_error
+        }, timeout=timeout, on_progress=on_progress)
+    
+    async def _check_code_with_mypy(self, code: str, allow_undefined_names: bool = False) -> Dict[str, Any]:
         """
         使用mypy检查代码类型
         
         Args:
             code: 要检查的Python代码
+            allow_undefined_names: 不报告未定义的名称（会话中之前执行的代码定义的辅助函数对 mypy 不可见）
             
         Returns:
             检查结果字典 {"success": bool, "errors": List[str], "output": str}
@@ -579,6 +1026,8 @@ class EditorConnection:
                     '--no-error-summary',
                     '--show-error-codes',
                 ]
+                if allow_undefined_names:
+                    mypy_cmd.extend(['--disable-error-code', 'name-defined'])
                 
                 # 添加排除路径（如果有配置）
                 for exclude_path in self.mypy_exclude_paths:
@@ -676,19 +1125,23 @@ class EditorConnection:
                 "output": "Type check failed"
             }
     
-    async def execute_code(self, code: str, timeout: float = None) -> Dict[str, Any]:
+    async def execute_code(self, code: str, timeout: float = None,
+                           on_progress: Callable[[Dict[str, Any]], None] = None,
+                           session: str = None) -> Dict[str, Any]:
         """
         执行Python代码（自动进行mypy类型检查）
         
         Args:
             code: 要执行的Python代码
-            timeout: 执行超时时间
+            timeout: 执行超时时间（无进度消息的最长等待时间）
+            on_progress: 进度/部分输出回调，见 send_request
+            session: 会话名；同一会话的代码共享全局变量，之前定义的辅助函数无需重复发送
             
         Returns:
             执行结果字典
         """
         # 先进行mypy类型检查
-        type_check_result = await self._check_code_with_mypy(code)
+        type_check_result = await self._check_code_with_mypy(code, allow_undefined_names=bool(session))
         
         if not type_check_result["success"]:
             # 类型检查失败，直接返回错误，不执行代码
@@ -702,10 +1155,20 @@ class EditorConnection:
             }
         
         # 类型检查通过，执行代码
-        return await self.send_request({
+        request = {
             "type": "execute",
             "code": code
-        }, timeout=timeout)
+        }
+        if session:
+            request["session"] = session
+        return await self.send_request(request, timeout=timeout, on_progress=on_progress)
+    
+    async def reset_session(self, session: str = None, timeout: float = 5.0) -> Dict[str, Any]:
+        """丢弃会话（省略时为全部会话）在编辑器中保存的全局变量"""
+        request = {"type": "reset_session"}
+        if session:
+            request["session"] = session
+        return await self.send_request(request, timeout=timeout)
 
 
 class MCPStandaloneServer:
@@ -727,7 +1190,10 @@ class MCPStandaloneServer:
                  editor_host: str = "127.0.0.1",
                  editor_port: int = 8100,
                  debug: bool = False,
-                 mypy_exclude_paths: List[str] = None):
+                 mypy_exclude_paths: List[str] = None,
+                 encoding: str = "auto",
+                 compression: str = "auto",
+                 shared_memory: str = "auto"):
         """
         初始化MCP服务器
         
@@ -738,6 +1204,9 @@ class MCPStandaloneServer:
             editor_port: 编辑器转发服务器端口
             debug: 是否开启调试模式
             mypy_exclude_paths: MyPy检查时要排除的目录列表（绝对路径）
+            encoding: 与编辑器通信的消息编码（auto / json / msgpack）
+            compression: 编辑器响应的压缩算法（auto / lz4 / zlib / none）
+            shared_memory: 同机编辑器的共享内存传输（auto / off）
         """
         self.mcp_host = mcp_host
         self.mcp_port = mcp_port
@@ -757,6 +1226,7 @@ class MCPStandaloneServer:
         
         self.editor_connection = EditorConnection(
             editor_host, editor_port, 
+            config=ConnectionConfig(encoding=encoding, compression=compression, shared_memory=shared_memory),
             debug=debug,
             mypy_exclude_paths=mypy_exclude_paths
         )
@@ -773,6 +1243,9 @@ class MCPStandaloneServer:
             print("[MCPServer] WARNING: Editor disconnected (crashed or closed)")
         elif new_state == EditorState.CONNECTED:
             print("[MCPServer] Editor connected and ready")
+        elif new_state == EditorState.BUSY:
+            status = self.editor_connection.last_heartbeat or {}
+            print(f"[MCPServer] Editor busy ({status.get('state', 'unknown')}), requests will wait instead of timing out")
     
     def _on_editor_disconnected(self):
         """编辑器断连回调，触发重连"""
@@ -780,7 +1253,9 @@ class MCPStandaloneServer:
             self._reconnect_event.set()
     
     async def _reconnect_loop(self):
-        """重连循环"""
+        """重连循环，连续失败时重连间隔指数增长"""
+        config = self.editor_connection.config
+        interval = config.reconnect_interval
         while self._running:
             try:
                 await asyncio.wait_for(self._reconnect_event.wait(), timeout=1.0)
@@ -792,9 +1267,27 @@ class MCPStandaloneServer:
                 print("[MCPServer] Attempting to connect to editor...")
                 connected = await self.editor_connection.connect()
                 
-                if not connected:
-                    print(f"[MCPServer] Connection failed, retrying in {self.editor_connection.config.reconnect_interval}s...")
-                    await asyncio.sleep(self.editor_connection.config.reconnect_interval)
+                if connected:
+                    interval = config.reconnect_interval
+                else:
+                    print(f"[MCPServer] Connection failed, retrying in {interval:.0f}s...")
+                    await asyncio.sleep(interval)
+                    interval = min(interval * 2, config.max_reconnect_interval)
+    
+    async def _heartbeat_loop(self):
+        """
+        定期发送心跳，更新编辑器忙碌状态
+        
+        TCP 断开才视为编辑器崩溃；心跳无应答（Python 转发器在编辑器阻塞时无法 tick）不会触发重连，
+        避免把长时间的着色器编译或模态对话框误判为崩溃。
+        """
+        interval = self.editor_connection.config.heartbeat_interval
+        if interval <= 0:
+            return
+        while self._running:
+            await asyncio.sleep(interval)
+            if self.editor_connection.is_connected:
+                await self.editor_connection.heartbeat(timeout=interval)
     
     async def _handle_tool_call(self, name: str, arguments: dict) -> ExecutionResult:
         """
@@ -823,7 +1316,7 @@ class MCPStandaloneServer:
             if name == "execute_command":
                 code = arguments.get('code', '')
                 # 始终进行类型检查
-                result = await self.editor_connection.execute_code(code)
+                result = await self.editor_connection.execute_code(code, session=arguments.get('session'))
                 return self._parse_editor_response(result)
                 
             elif name == "excute_file":
@@ -833,9 +1326,16 @@ class MCPStandaloneServer:
             
             elif name == "get_editor_state":
                 state = self.editor_connection.state.value
+                output = f"Editor connection state: {state}"
+                status = await self.editor_connection.heartbeat()
+                if status and "frame" in status:
+                    output += (f"\nGame thread: {status.get('state')}, frame {status.get('frame'):.0f}, "
+                               f"{status.get('since_tick_ms', 0):.0f} ms since last tick, {status.get('queued', 0)} queued request(s)")
+                    if status.get("request_type"):
+                        output += f"\nExecuting: {status['request_type']} for {status.get('request_ms', 0):.0f} ms"
                 return ExecutionResult(
                     success=True,
-                    output=f"Editor connection state: {state}"
+                    output=output
                 )
             
             else:
@@ -957,6 +1457,7 @@ class MCPStandaloneServer:
         
         # 启动重连循环
         self._tasks.append(asyncio.create_task(self._reconnect_loop()))
+        self._tasks.append(asyncio.create_task(self._heartbeat_loop()))
         
         # 尝试初始连接
         print("[MCPServer] Attempting initial connection to editor...")
@@ -1082,7 +1583,10 @@ Note:
         mcp_port=mcp_port,
         editor_host=editor_host,
         editor_port=editor_port,
-        debug=debug
+        debug=debug,
+        encoding=config["editor_encoding"],
+        compression=config["editor_compression"],
+        shared_memory=config["editor_shared_memory"]
     )
     
     try:
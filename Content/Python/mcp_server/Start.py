@@ -14,6 +14,9 @@ Start.py - MCP服务启动入口
     
     # 强制UE4模式（转发器）
     Start.start_ue4()
+
+转发器默认为 MCPForwarder.py，.env 中设置 EDITOR_ENDPOINT=native 时改用C++原生端点（FMCPEndpoint）
+.env 中设置 NATIVE_MCP_PORT 时另外启动C++原生MCP端点（FMCPHttpServer），AI客户端可直接连接 http://127.0.0.1:<端口>/mcp
 """
 
 import importlib
@@ -28,6 +31,8 @@ modular_MCPForwarder = None
 mcp_server = None
 mcp_forwarder = None
 event_manager = None
+native_endpoint_running = False
+native_http_server_running = False
 
 
 def _get_log_function():
@@ -102,6 +107,8 @@ def start():
     
     log(f"[MCP] UE Version: {ue_version}, MCP Library Available: {mcp_available}")
     
+    start_native_http_server()
+    
     if ue_version >= 5 and mcp_available:
         # UE5 + MCP可用：使用完整MCP服务器
         log("[MCP] Starting full MCP server mode (UE5)")
@@ -164,6 +171,12 @@ def start_ue4(host: str = None, port: int = None):
     global modular_Manager, modular_MCPForwarder, mcp_forwarder, event_manager
     
     log = _get_log_function()
+    
+    if MCPConfig.get_editor_endpoint() == "native":
+        if start_native_endpoint(host, port):
+            return
+        log("[MCP] Native endpoint unavailable, falling back to Python forwarder")
+    
     log(f"[MCP] Starting UE4 forwarder mode on {host}:{port}")
     
     # 导入类（__init__.py已将类导出到包级别）
@@ -192,6 +205,70 @@ def start_ue4(host: str = None, port: int = None):
     event_manager.run_until_complete(forwarder_tick_loop(), use_heart=False)
 
 
+def start_native_endpoint(host: str, port: int) -> bool:
+    """
+    启动C++原生端点（FMCPEndpoint）
+    
+    socket 收发在独立I/O线程完成，无需Python tick循环；
+    需要Python执行的请求由 MCPEndpointBridge 在游戏线程处理
+    
+    Returns:
+        bool: 是否启动成功
+    """
+    global native_endpoint_running
+    
+    log = _get_log_function()
+    try:
+        import unreal
+        if not hasattr(unreal, "MCPEndpointLibrary"):
+            return False
+        if not unreal.MCPEndpointLibrary.start_endpoint(host, port):
+            return False
+    except Exception as e:
+        log(f"[MCP] Failed to start native endpoint: {e}")
+        return False
+    
+    native_endpoint_running = True
+    log(f"[MCP] Native endpoint started on {host}:{port}")
+    return True
+
+
+def start_native_http_server(port: int = None) -> bool:
+    """
+    启动C++原生MCP端点（FMCPHttpServer，Streamable HTTP）
+    
+    MCP 协议在C++中处理，工具调用不经过独立进程和Python事件循环；与Python MCP服务/转发器可同时运行
+    
+    Args:
+        port: 监听端口，默认从.env的 NATIVE_MCP_PORT 读取，0 表示不启动
+    
+    Returns:
+        bool: 是否启动成功
+    """
+    global native_http_server_running
+    
+    from . import MCPConfig
+    if port is None:
+        port = MCPConfig.get_native_mcp_port()
+    if port <= 0:
+        return False
+    
+    log = _get_log_function()
+    try:
+        import unreal
+        if not hasattr(unreal, "MCPEndpointLibrary") or not hasattr(unreal.MCPEndpointLibrary, "start_http_server"):
+            return False
+        if not unreal.MCPEndpointLibrary.start_http_server(port, "/mcp"):
+            return False
+    except Exception as e:
+        log(f"[MCP] Failed to start native MCP HTTP server: {e}")
+        return False
+    
+    native_http_server_running = True
+    log(f"[MCP] Native MCP HTTP server started: http://127.0.0.1:{port}/mcp")
+    return True
+
+
 def start_forwarder(host: str = None, port: int = None):
     """
     启动转发服务器的别名
@@ -247,11 +324,20 @@ def stop():
     """
     停止所有服务并清理资源
     """
-    global mcp_server, mcp_forwarder, event_manager
+    global mcp_server, mcp_forwarder, event_manager, native_endpoint_running, native_http_server_running
     
     log = _get_log_function()
     log("[MCP] Stopping service...")
     
+    # 停止原生MCP端点
+    if native_http_server_running:
+        try:
+            import unreal
+            unreal.MCPEndpointLibrary.stop_http_server()
+        except Exception as e:
+            log(f"[MCP] Error stopping native MCP HTTP server: {e}")
+        native_http_server_running = False
+    
     # 停止MCP服务器
     if mcp_server is not None:
         try:
@@ -266,6 +352,15 @@ def stop():
             log(f"[MCP] Error stopping MCP server: {e}")
         mcp_server = None
     
+    # 停止原生端点
+    if native_endpoint_running:
+        try:
+            import unreal
+            unreal.MCPEndpointLibrary.stop_endpoint()
+        except Exception as e:
+            log(f"[MCP] Error stopping native endpoint: {e}")
+        native_endpoint_running = False
+    
     # 停止转发服务器
     if mcp_forwarder is not None:
         try:
@@ -297,12 +392,19 @@ def get_status():
         "mcp_available": is_mcp_available(),
         "mode": None,
         "running": False,
-        "connected": False
+        "connected": False,
+        "native_http_server": native_http_server_running
     }
     
     if mcp_server is not None:
         status["mode"] = "ue5_full"
         status["running"] = True
+    elif native_endpoint_running:
+        import unreal
+        status["mode"] = "native_endpoint"
+        status["running"] = unreal.MCPEndpointLibrary.is_endpoint_running()
+        status["connected"] = unreal.MCPEndpointLibrary.is_endpoint_client_connected()
+        status["connections"] = unreal.MCPEndpointLibrary.get_endpoint_connection_count()
     elif mcp_forwarder is not None:
         status["mode"] = "ue4_forwarder"
         status["running"] = mcp_forwarder.is_running
@@ -323,6 +425,9 @@ def print_status():
     log(f"  MCP Library Available: {status['mcp_available']}")
     log(f"  Mode: {status['mode'] or 'Not started'}")
     log(f"  Running: {status['running']}")
-    if status['mode'] == 'ue4_forwarder':
+    log(f"  Native MCP HTTP Server: {status['native_http_server']}")
+    if status['mode'] in ('ue4_forwarder', 'native_endpoint'):
         log(f"  Client Connected: {status['connected']}")
+    if status['mode'] == 'native_endpoint':
+        log(f"  Connections: {status['connections']}")
     log("=" * 50)
@@ -7,7 +7,11 @@ mcp_server - UE Editor MCP Server 核心模块
 - Manager: 事件管理器
 - MCPServer: UE5完整MCP服务器（包含CodeExecutor，依赖unreal）
 - MCPForwarder: UE4转发服务器
+- MCPEndpointBridge: C++原生端点的Python桥接（依赖unreal，按需导入）
 - MCPStandalone: 独立进程MCP服务器
+- MCPBinaryDump: 二进制属性导出解码器 - 不依赖unreal
+- MCPMessagePack: 端点协议的 MessagePack 编解码 - 不依赖unreal
+- MCPSharedMemory: 同机端点的共享内存环形缓冲客户端 - 不依赖unreal
 - Start: 启动入口
 """
 
@@ -26,6 +30,9 @@ from .Manager import Manager
 from .MCPForwarder import MCPForwarder, ForwarderState
 from .MCPStandalone import MCPStandaloneServer, EditorConnection, EditorState, ConnectionConfig
 from .MCPServer import MCPServer, CodeExecutor
+from . import MCPBinaryDump
+from . import MCPMessagePack
+from . import MCPSharedMemory
 from . import Start
 
 __all__ = [
@@ -53,6 +60,12 @@ __all__ = [
     # MCPServer (依赖unreal)
     'MCPServer',
     'CodeExecutor',
+    # MCPBinaryDump (不依赖unreal)
+    'MCPBinaryDump',
+    # MCPMessagePack (不依赖unreal)
+    'MCPMessagePack',
+    # MCPSharedMemory (不依赖unreal)
+    'MCPSharedMemory',
     # Start
     'Start',
 ]
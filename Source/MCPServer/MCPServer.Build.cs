@@ -43,6 +43,13 @@ public class MCPServer : ModuleRules
 				"UnrealEd",
 				"Kismet",
 				"GameplayTags",
+				"AssetRegistry",
+				"Sockets",
+				"Networking",
+				"HTTPServer",
+				"Json",
+				"PythonScriptPlugin",
+				"Python3",
 				// ... add private dependencies that you statically link with here ...	
 			}
 		);
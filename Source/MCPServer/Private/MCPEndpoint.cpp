@@ -0,0 +1,1750 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPEndpoint.h"
+
+#include "MCPServer.h"
+#include "MCPMessagePack.h"
+#include "MCPNativeHandlers.h"
+#include "MCPObjectInformDumpLibrary.h"
+#include "MCPResultCache.h"
+#include "MCPSharedMemoryRing.h"
+#include "Async/Async.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "IPythonScriptPlugin.h"
+#include "Interfaces/IPv4/IPv4Address.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Misc/Compression.h"
+#include "Misc/OutputDeviceHelper.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+#if WITH_PYTHON
+THIRD_PARTY_INCLUDES_START
+#include "Python.h"
+THIRD_PARTY_INCLUDES_END
+#endif
+
+// UE 5.4 起 TArray 的 bool bAllowShrinking 重载已弃用
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+static constexpr EAllowShrinking MCPNoShrink = EAllowShrinking::No;
+#else
+static constexpr bool MCPNoShrink = false;
+#endif
+
+static TAutoConsoleVariable<int32> CVarMCPEndpointCompressionThreshold(
+	TEXT("MCP.Endpoint.CompressionThreshold"),
+	16 * 1024,
+	TEXT("Frames at least this many bytes are compressed for clients that negotiated compression in hello."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMCPEndpointSharedMemorySizeMB(
+	TEXT("MCP.Endpoint.SharedMemorySizeMB"),
+	64,
+	TEXT("Size (MB) of the shared-memory ring created for same-machine clients that request it in hello. 0 disables the shared-memory transport."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMCPEndpointSharedMemoryThreshold(
+	TEXT("MCP.Endpoint.SharedMemoryThreshold"),
+	64 * 1024,
+	TEXT("Frames at least this many bytes are passed through the shared-memory ring instead of the socket."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMCPEndpointWorkerRequests(
+	TEXT("MCP.Endpoint.WorkerRequests"),
+	4,
+	TEXT("Maximum number of thread-safe read-only requests (log_tail, captured_logs, ...) executed concurrently on worker threads. ")
+	TEXT("Further requests wait for the game thread. 0 runs everything on the game thread."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMCPEndpointStallThresholdMs(
+	TEXT("MCP.Endpoint.StallThresholdMs"),
+	1000,
+	TEXT("Heartbeats report the editor as stalled (busy) when the game thread has not ticked for this many milliseconds."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMCPEndpointSendQueueLimitKB(
+	TEXT("MCP.Endpoint.SendQueueLimitKB"),
+	8 * 1024,
+	TEXT("Per-connection limit (KB) of encoded bytes waiting to be sent. A connection over the limit stops reading new requests, ")
+	TEXT("keeps further messages unencoded and pauses its streaming dumps until the client catches up. 0 disables the limit."),
+	ECVF_Default);
+
+namespace
+{
+	/** 与 Python 的 time.time() 一致的 Unix 时间戳（秒） */
+	double GetUnixTimestamp()
+	{
+		return (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalSeconds();
+	}
+
+	FString SerializeJson(const TSharedRef<FJsonObject>& Object)
+	{
+		FString Output;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Output);
+		FJsonSerializer::Serialize(Object, Writer);
+		return Output;
+	}
+
+	TArray<uint8> ToUtf8(const FString& Text)
+	{
+		FTCHARToUTF8 Utf8(*Text);
+		return TArray<uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	/** 每次 recv 的最大读取量，大消息在一次唤醒内尽量读完 */
+	constexpr int32 RecvChunkSize = 1024 * 1024;
+
+	/** 请求日志转发的节流：间隔或累计大小达到其一即发送 */
+	constexpr double RequestLogFlushInterval = 0.1;
+	constexpr int32 RequestLogFlushSize = 16 * 1024;
+
+	/** 连接上未完成请求的取消标记达到该数量时清理已失效的条目 */
+	constexpr int32 InFlightPruneThreshold = 64;
+
+	/** 端点自身处理或发出的消息类型；Python 桥接处理的类型见 MCPForwarder.py */
+	const TSet<FString> BuiltinMessageTypes =
+	{
+		TEXT("ping"), TEXT("pong"), TEXT("heartbeat"), TEXT("hello"), TEXT("cancel"), TEXT("metrics"),
+		TEXT("get_state"), TEXT("dump_stream"), TEXT("batch"), TEXT("subscribe"), TEXT("unsubscribe"),
+		TEXT("execute"), TEXT("execute_file"), TEXT("reset_session"), TEXT("get_imported_modules"),
+		TEXT("result"), TEXT("progress"), TEXT("partial"), TEXT("chunk"), TEXT("event"),
+	};
+
+	/** 由 I/O 线程置位，Python 主线程（游戏线程）的 pending call 中消费 */
+	std::atomic<bool> bPythonInterruptRequested { false };
+
+#if WITH_PYTHON
+	/** Py_AddPendingCall 回调：在游戏线程执行的 Python 代码中抛出 KeyboardInterrupt */
+	int RaisePythonInterrupt(void*)
+	{
+		if (bPythonInterruptRequested.exchange(false))
+		{
+			PyErr_SetString(PyExc_KeyboardInterrupt, "MCP request cancelled");
+			return -1;
+		}
+		return 0;
+	}
+#endif
+}
+
+class FMCPEndpoint::FRequestLogDevice : public FOutputDevice
+{
+public:
+	explicit FRequestLogDevice(FMCPEndpoint& InEndpoint)
+		: Endpoint(InEndpoint)
+	{
+	}
+
+	virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override
+	{
+		Endpoint.CaptureRequestLog(V, Verbosity, Category);
+	}
+
+	virtual bool CanBeUsedOnAnyThread() const override
+	{
+		return true;
+	}
+
+private:
+	FMCPEndpoint& Endpoint;
+};
+
+FMCPEndpoint::FMCPEndpoint()
+{
+	Metrics.SetKnownTypeFilter([](const FString& Type)
+	{
+		return BuiltinMessageTypes.Contains(Type) || FMCPNativeHandlerRegistry::Get().HasHandler(Type);
+	});
+}
+
+FMCPEndpoint::~FMCPEndpoint()
+{
+	Shutdown();
+}
+
+bool FMCPEndpoint::Listen(const FString& BindAddress, int32 Port)
+{
+	if (IsRunning())
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("MCP endpoint already running on port %d"), ListenPort);
+		return false;
+	}
+
+	FIPv4Address Address;
+	if (!FIPv4Address::Parse(BindAddress, Address))
+	{
+		UE_LOG(LogMCPServer, Error, TEXT("MCP endpoint: invalid bind address %s"), *BindAddress);
+		return false;
+	}
+
+	ListenSocket = FTcpSocketBuilder(TEXT("MCPEndpoint"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToEndpoint(FIPv4Endpoint(Address, Port))
+		.Listening(8)
+		.Build();
+
+	if (!ListenSocket)
+	{
+		UE_LOG(LogMCPServer, Error, TEXT("MCP endpoint: failed to listen on %s:%d (port may be in use)"), *BindAddress, Port);
+		return false;
+	}
+
+	ListenPort = Port;
+	bStopRequested = false;
+	RequestLogDevice = MakeUnique<FRequestLogDevice>(*this);
+	GLog->AddOutputDevice(RequestLogDevice.Get());
+	Thread = FRunnableThread::Create(this, TEXT("MCPEndpointIO"), 0, TPri_AboveNormal);
+
+#if ENGINE_MAJOR_VERSION >= 5
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FMCPEndpoint::Tick));
+#else
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FMCPEndpoint::Tick));
+#endif
+
+	UE_LOG(LogMCPServer, Log, TEXT("MCP endpoint listening on %s:%d"), *BindAddress, Port);
+	return true;
+}
+
+void FMCPEndpoint::Shutdown()
+{
+	if (TickerHandle.IsValid())
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#endif
+		TickerHandle.Reset();
+	}
+
+	if (RequestLogDevice)
+	{
+		GLog->RemoveOutputDevice(RequestLogDevice.Get());
+		RequestLogDevice.Reset();
+	}
+
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	// I/O 线程停止后不会再派发新的工作线程请求，等待已派发的完成
+	while (NumWorkerRequests.load() > 0)
+	{
+		FPlatformProcess::SleepNoStats(0.001f);
+	}
+
+	CloseAllConnections();
+
+	if (ListenSocket)
+	{
+		ListenSocket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+		UE_LOG(LogMCPServer, Log, TEXT("MCP endpoint stopped"));
+	}
+
+	ActiveStreams.Empty();
+	NextStreamIndex = 0;
+	EventHub.Reset();
+	Scheduler = FMCPRequestScheduler();
+	IncomingEvents.Empty();
+	OutgoingMessages.Empty();
+	NumIncomingRequests = 0;
+	NumScheduledRequests = 0;
+	LastTickTime = 0.0;
+}
+
+void FMCPEndpoint::SendMessage(uint32 ConnectionId, const TSharedRef<FJsonObject>& Message)
+{
+	FOutgoingMessage Outgoing;
+	Outgoing.ConnectionId = ConnectionId;
+	Outgoing.Message = Message;
+	Outgoing.MetricsType = GetCurrentMetricsType();
+	OutgoingMessages.Enqueue(MoveTemp(Outgoing));
+}
+
+void FMCPEndpoint::SendRawMessage(uint32 ConnectionId, const FString& MessageJson)
+{
+	FOutgoingMessage Outgoing;
+	Outgoing.ConnectionId = ConnectionId;
+	Outgoing.Payload = ToUtf8(MessageJson);
+	Outgoing.MetricsType = GetCurrentMetricsType();
+	OutgoingMessages.Enqueue(MoveTemp(Outgoing));
+}
+
+FString FMCPEndpoint::GetCurrentMetricsType() const
+{
+	if (!IsInGameThread())
+	{
+		return FString();
+	}
+
+	FScopeLock Lock(&CurrentRequestMutex);
+	return CurrentRequest.bActive ? CurrentRequest.Type : FString();
+}
+
+uint32 FMCPEndpoint::Run()
+{
+	TArray<uint32> ClosedConnections;
+
+	while (!bStopRequested)
+	{
+		AcceptConnection();
+
+		if (Connections.Num() == 0)
+		{
+			// 无连接时丢弃残留的响应，等待新连接
+			QueueOutgoingMessages();
+			bool bHasPendingConnection = false;
+			ListenSocket->WaitForPendingConnection(bHasPendingConnection, FTimespan::FromMilliseconds(10));
+			continue;
+		}
+
+		// 单连接时可以阻塞等待该 socket；多连接没有跨 socket 的等待接口，短暂休眠后轮询
+		if (Connections.Num() == 1)
+		{
+			// 拥塞的连接暂停读取，改为等待 socket 可写
+			const FConnection& OnlyConnection = *Connections.CreateConstIterator().Value();
+			OnlyConnection.Socket->Wait(OnlyConnection.bCongested ? ESocketWaitConditions::WaitForWrite : ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(1));
+		}
+		else
+		{
+			FPlatformProcess::SleepNoStats(0.0005f);
+		}
+
+		QueueOutgoingMessages();
+
+		for (const TPair<uint32, TUniquePtr<FConnection>>& Pair : Connections)
+		{
+			FConnection& ClientConnection = *Pair.Value;
+			if ((!ClientConnection.bCongested && !ReceiveData(ClientConnection)) || !FlushSendBuffer(ClientConnection))
+			{
+				ClosedConnections.Add(Pair.Key);
+				continue;
+			}
+			DrainDeferredMessages(ClientConnection);
+			UpdateCongestion(ClientConnection);
+		}
+
+		for (uint32 ConnectionId : ClosedConnections)
+		{
+			CloseConnection(ConnectionId);
+		}
+		ClosedConnections.Reset();
+	}
+
+	return 0;
+}
+
+void FMCPEndpoint::Stop()
+{
+	bStopRequested = true;
+}
+
+void FMCPEndpoint::AcceptConnection()
+{
+	bool bHasPendingConnection = false;
+	while (ListenSocket && ListenSocket->HasPendingConnection(bHasPendingConnection) && bHasPendingConnection)
+	{
+		FSocket* ClientSocket = ListenSocket->Accept(TEXT("MCPEndpointClient"));
+		if (!ClientSocket)
+		{
+			return;
+		}
+
+		if (Connections.Num() >= MaxConnections)
+		{
+			UE_LOG(LogMCPServer, Warning, TEXT("MCP endpoint: connection limit (%d) reached, rejecting client"), MaxConnections);
+			ClientSocket->Close();
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ClientSocket);
+			continue;
+		}
+
+		ClientSocket->SetNonBlocking(true);
+		ClientSocket->SetNoDelay(true);
+		int32 ActualSize = 0;
+		ClientSocket->SetReceiveBufferSize(RecvChunkSize, ActualSize);
+		ClientSocket->SetSendBufferSize(RecvChunkSize, ActualSize);
+
+		TUniquePtr<FConnection> NewConnection = MakeUnique<FConnection>();
+		NewConnection->Id = NextConnectionId++;
+		NewConnection->Socket = ClientSocket;
+		UE_LOG(LogMCPServer, Log, TEXT("MCP endpoint: client connected (connection %u, %d open)"), NewConnection->Id, Connections.Num() + 1);
+		Connections.Add(NewConnection->Id, MoveTemp(NewConnection));
+		NumConnections = Connections.Num();
+	}
+}
+
+bool FMCPEndpoint::ReceiveData(FConnection& InConnection)
+{
+	// 前移的数据量不超过此前解析掉的数据量，许多小请求的总开销保持线性
+	if (InConnection.RecvOffset > 0 && InConnection.RecvOffset >= InConnection.RecvBuffer.Num() / 2)
+	{
+		InConnection.RecvBuffer.RemoveAt(0, InConnection.RecvOffset, MCPNoShrink);
+		InConnection.RecvOffset = 0;
+	}
+
+	bool bReceivedAny = false;
+	for (;;)
+	{
+		const int32 OldNum = InConnection.RecvBuffer.Num();
+		InConnection.RecvBuffer.AddUninitialized(RecvChunkSize);
+
+		int32 BytesRead = 0;
+		const bool bOk = InConnection.Socket->Recv(InConnection.RecvBuffer.GetData() + OldNum, RecvChunkSize, BytesRead);
+		InConnection.RecvBuffer.SetNum(OldNum + BytesRead, MCPNoShrink);
+
+		if (!bOk)
+		{
+			// 流式 socket 上 Recv 失败表示对端关闭或连接被重置
+			UE_LOG(LogMCPServer, Log, TEXT("MCP endpoint: client disconnected (connection %u)"), InConnection.Id);
+			return false;
+		}
+
+		if (BytesRead <= 0)
+		{
+			break;
+		}
+		bReceivedAny = true;
+
+		if (BytesRead < RecvChunkSize)
+		{
+			break;
+		}
+	}
+
+	return !bReceivedAny || ParseMessages(InConnection);
+}
+
+bool FMCPEndpoint::ParseMessages(FConnection& InConnection)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MCPEndpoint_ParseMessages);
+
+	TArray<uint8>& Buffer = InConnection.RecvBuffer;
+	int32 Offset = InConnection.RecvOffset;
+
+	while (Buffer.Num() - Offset >= 4)
+	{
+		const uint8* Header = Buffer.GetData() + Offset;
+		const uint32 MessageSize = (uint32(Header[0]) << 24) | (uint32(Header[1]) << 16) | (uint32(Header[2]) << 8) | uint32(Header[3]);
+		if (MessageSize > uint32(MaxMessageSize))
+		{
+			UE_LOG(LogMCPServer, Warning, TEXT("MCP endpoint: message size %u exceeds limit, closing connection"), MessageSize);
+			return false;
+		}
+
+		const int32 Missing = Offset + 4 + int32(MessageSize) - Buffer.Num();
+		if (Missing > 0)
+		{
+			// 按已收到的数据量成倍预留，而不是按头部声明的大小一次预留：
+			// 只发头部不发正文的客户端最多占用少量内存，大消息的扩容次数仍是对数级
+			const int32 Growth = FMath::Min(Missing, FMath::Max(Buffer.Num(), RecvChunkSize * 4));
+			Buffer.Reserve(Buffer.Num() + Growth + RecvChunkSize);
+			break;
+		}
+
+		const uint8* Body = Header + 4;
+		Offset += 4 + MessageSize;
+
+		const double DecodeStartTime = FPlatformTime::Seconds();
+		TSharedPtr<FJsonObject> Message;
+		if (FMCPMessagePack::IsMessagePackFrame(Body, MessageSize))
+		{
+			// 直接在接收缓冲区上解码
+			FString Error;
+			Message = FMCPMessagePack::Decode(Body, MessageSize, &Error);
+			if (!Message.IsValid())
+			{
+				UE_LOG(LogMCPServer, Warning, TEXT("MCP endpoint: MessagePack decode error: %s"), *Error);
+				continue;
+			}
+		}
+		else
+		{
+			FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Body), MessageSize);
+			FString MessageJson(Converted.Length(), Converted.Get());
+			TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(MessageJson);
+			if (!FJsonSerializer::Deserialize(Reader, Message) || !Message.IsValid())
+			{
+				UE_LOG(LogMCPServer, Warning, TEXT("MCP endpoint: JSON decode error"));
+				continue;
+			}
+		}
+
+		FString MessageType;
+		Message->TryGetStringField(TEXT("type"), MessageType);
+		Metrics.RecordReceived(MessageType, 4 + MessageSize, FPlatformTime::Seconds() - DecodeStartTime);
+
+		HandleIncomingMessage(InConnection, MoveTemp(Message));
+	}
+
+	InConnection.RecvOffset = Offset;
+	if (Offset == Buffer.Num())
+	{
+		// 全部解析完（常见情况）时直接清空，不搬动数据；大消息留下的分配不保留
+		if (Buffer.Max() > RecvChunkSize * 4)
+		{
+			Buffer.Empty();
+		}
+		else
+		{
+			Buffer.Reset();
+		}
+		InConnection.RecvOffset = 0;
+	}
+	return true;
+}
+
+void FMCPEndpoint::HandleIncomingMessage(FConnection& InConnection, TSharedPtr<FJsonObject> Message)
+{
+	FMCPEndpointRequest Request;
+	Request.ConnectionId = InConnection.Id;
+	Request.Message = Message;
+	Request.ReceiveTime = FPlatformTime::Seconds();
+	Message->TryGetStringField(TEXT("type"), Request.Type);
+	Message->TryGetStringField(TEXT("id"), Request.Id);
+
+	if (Request.Type == TEXT("ping") || Request.Type == TEXT("heartbeat"))
+	{
+		// 连接检测不经过游戏线程，编辑器卡顿时也能立即应答，并告知客户端游戏线程是否忙碌
+		SendMessage(InConnection.Id, MakeStateMessage(Request.Type == TEXT("ping") ? TEXT("pong") : TEXT("heartbeat"), Request.Id));
+		return;
+	}
+
+	if (Request.Type == TEXT("hello"))
+	{
+		HandleHello(InConnection, *Message, Request.Id);
+		return;
+	}
+
+	if (Request.Type == TEXT("cancel"))
+	{
+		// 取消在 I/O 线程处理，游戏线程忙于执行被取消的请求时也能生效
+		HandleCancel(InConnection, *Message, Request.Id);
+		return;
+	}
+
+	if (Request.Type == TEXT("metrics"))
+	{
+		// 统计查询不占用游戏线程，也不受排队延迟影响
+		HandleMetrics(InConnection, *Message, Request.Id);
+		return;
+	}
+
+	Request.Priority = FMCPRequestScheduler::GetRequestPriority(Request.Type, *Message);
+	double DeadlineMs = 0.0;
+	if (Message->TryGetNumberField(TEXT("deadline_ms"), DeadlineMs) && DeadlineMs > 0.0)
+	{
+		Request.Deadline = Request.ReceiveTime + DeadlineMs / 1000.0;
+	}
+
+	Request.CancelToken = MakeShared<FMCPCancellationToken, ESPMode::ThreadSafe>();
+	if (!Request.Id.IsEmpty())
+	{
+		if (InConnection.InFlightRequests.Num() >= InFlightPruneThreshold)
+		{
+			for (auto It = InConnection.InFlightRequests.CreateIterator(); It; ++It)
+			{
+				if (!It.Value().IsValid())
+				{
+					It.RemoveCurrent();
+				}
+			}
+		}
+		InConnection.InFlightRequests.Add(Request.Id, Request.CancelToken);
+	}
+
+	// 之后只通过 Request 持有消息，转交其他线程后 I/O 线程不再触碰其引用计数
+	Message.Reset();
+	if (DispatchToWorker(Request))
+	{
+		return;
+	}
+
+	FIncomingEvent Event;
+	Event.Request = MoveTemp(Request);
+	++NumIncomingRequests;
+	IncomingEvents.Enqueue(MoveTemp(Event));
+}
+
+void FMCPEndpoint::HandleCancel(FConnection& InConnection, const FJsonObject& Message, const FString& RequestId)
+{
+	FString TargetId;
+	Message.TryGetStringField(TEXT("target"), TargetId);
+
+	bool bCancelled = false;
+	TWeakPtr<FMCPCancellationToken, ESPMode::ThreadSafe> WeakToken;
+	if (!TargetId.IsEmpty() && InConnection.InFlightRequests.RemoveAndCopyValue(TargetId, WeakToken))
+	{
+		if (FMCPCancellationTokenPtr Token = WeakToken.Pin())
+		{
+			Token->Cancel();
+			InterruptPython(Token.Get());
+			bCancelled = true;
+		}
+	}
+
+	UE_LOG(LogMCPServer, Verbose, TEXT("MCP endpoint: cancel %s -> %s"), *TargetId, bCancelled ? TEXT("cancelled") : TEXT("not found"));
+
+	TSharedRef<FJsonObject> Reply = MakeShared<FJsonObject>();
+	Reply->SetStringField(TEXT("type"), TEXT("result"));
+	Reply->SetStringField(TEXT("id"), RequestId);
+	Reply->SetBoolField(TEXT("success"), true);
+	Reply->SetStringField(TEXT("target"), TargetId);
+	Reply->SetBoolField(TEXT("cancelled"), bCancelled);
+	SendMessage(InConnection.Id, Reply);
+}
+
+void FMCPEndpoint::HandleMetrics(FConnection& InConnection, const FJsonObject& Message, const FString& RequestId)
+{
+	TSharedRef<FJsonObject> Reply = Metrics.ToJson();
+	Reply->SetStringField(TEXT("type"), TEXT("metrics"));
+	Reply->SetStringField(TEXT("id"), RequestId);
+	Reply->SetBoolField(TEXT("success"), true);
+	Reply->SetNumberField(TEXT("connections"), NumConnections.load());
+
+	bool bReset = false;
+	if (Message.TryGetBoolField(TEXT("reset"), bReset) && bReset)
+	{
+		Metrics.Reset();
+	}
+	SendMessage(InConnection.Id, Reply);
+}
+
+bool FMCPEndpoint::DispatchToWorker(FMCPEndpointRequest& Request)
+{
+	const int32 MaxWorkerRequests = CVarMCPEndpointWorkerRequests.GetValueOnAnyThread();
+	if (MaxWorkerRequests <= 0 || !FMCPNativeHandlerRegistry::Get().IsThreadSafe(Request.Type))
+	{
+		return false;
+	}
+
+	// 工作线程已占满时交给游戏线程，避免大量请求占满后台线程池
+	if (NumWorkerRequests.fetch_add(1) >= MaxWorkerRequests)
+	{
+		NumWorkerRequests.fetch_sub(1);
+		return false;
+	}
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, Request = MoveTemp(Request)]()
+	{
+		ExecuteOnWorker(Request);
+		NumWorkerRequests.fetch_sub(1);
+	});
+	return true;
+}
+
+void FMCPEndpoint::ExecuteOnWorker(const FMCPEndpointRequest& Request)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MCPEndpoint_WorkerRequest);
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*Metrics.GetTypeKey(Request.Type));
+
+	if (Request.IsCancelled())
+	{
+		SendCancelled(Request.ConnectionId, Request.Id);
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	TSharedPtr<FJsonObject> Result;
+	{
+		FMCPCancellationScope CancellationScope(Request.CancelToken);
+		Result = FMCPNativeHandlerRegistry::Get().HandleRequest(*Request.Message);
+	}
+	Metrics.RecordExecuted(Request.Type, StartTime - Request.ReceiveTime, FPlatformTime::Seconds() - StartTime);
+
+	if (!Result.IsValid())
+	{
+		// 派发后处理器被注销
+		SendError(Request.ConnectionId, Request.Id, FString::Printf(TEXT("No native handler for '%s'"), *Request.Type));
+		return;
+	}
+
+	FOutgoingMessage Outgoing;
+	Outgoing.ConnectionId = Request.ConnectionId;
+	Outgoing.Message = Result;
+	Outgoing.MetricsType = Request.Type;
+	OutgoingMessages.Enqueue(MoveTemp(Outgoing));
+}
+
+void FMCPEndpoint::InterruptPython(const FMCPCancellationToken* Token)
+{
+#if WITH_PYTHON
+	FScopeLock Lock(&PythonInterruptMutex);
+	if (Token && Token == PythonCancelToken)
+	{
+		// Py_AddPendingCall 不需要 GIL，回调在解释器主线程（游戏线程）的下一次字节码检查时执行，与信号处理相同的机制
+		bPythonInterruptRequested = true;
+		Py_AddPendingCall(&RaisePythonInterrupt, nullptr);
+	}
+#endif
+}
+
+void FMCPEndpoint::HandleHello(FConnection& InConnection, const FJsonObject& Message, const FString& RequestId)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Encodings = nullptr;
+	bool bMessagePack = false;
+	if (Message.TryGetArrayField(TEXT("encodings"), Encodings))
+	{
+		for (const TSharedPtr<FJsonValue>& Encoding : *Encodings)
+		{
+			bMessagePack |= Encoding.IsValid() && Encoding->Type == EJson::String && Encoding->AsString() == TEXT("msgpack");
+		}
+	}
+
+	// 按客户端给出的偏好顺序选择第一个支持的压缩算法
+	const TArray<TSharedPtr<FJsonValue>>* Compressions = nullptr;
+	FString CompressionName = TEXT("none");
+	InConnection.Compression = NAME_None;
+	if (Message.TryGetArrayField(TEXT("compression"), Compressions))
+	{
+		for (const TSharedPtr<FJsonValue>& Compression : *Compressions)
+		{
+			const FString Name = Compression.IsValid() && Compression->Type == EJson::String ? Compression->AsString() : FString();
+			if (Name == TEXT("lz4") || Name == TEXT("zlib"))
+			{
+				CompressionName = Name;
+				InConnection.Compression = Name == TEXT("lz4") ? NAME_LZ4 : NAME_Zlib;
+				break;
+			}
+		}
+	}
+
+	InConnection.CompressionThreshold = FMath::Max(CVarMCPEndpointCompressionThreshold.GetValueOnAnyThread(), 1);
+	int32 RequestedThreshold = 0;
+	if (Message.TryGetNumberField(TEXT("compression_threshold"), RequestedThreshold) && RequestedThreshold > 0)
+	{
+		InConnection.CompressionThreshold = RequestedThreshold;
+	}
+
+	TSharedRef<FJsonObject> Reply = MakeShared<FJsonObject>();
+	Reply->SetStringField(TEXT("type"), TEXT("hello"));
+	Reply->SetStringField(TEXT("id"), RequestId);
+	Reply->SetStringField(TEXT("server"), TEXT("native"));
+	Reply->SetStringField(TEXT("encoding"), bMessagePack ? TEXT("msgpack") : TEXT("json"));
+	Reply->SetStringField(TEXT("compression"), CompressionName);
+	Reply->SetNumberField(TEXT("compression_threshold"), InConnection.CompressionThreshold);
+
+	bool bWantsSharedMemory = false;
+	if (Message.TryGetBoolField(TEXT("shm"), bWantsSharedMemory) && bWantsSharedMemory)
+	{
+		if (TSharedPtr<FJsonObject> SharedMemory = SetupSharedMemory(InConnection))
+		{
+			Reply->SetObjectField(TEXT("shm"), SharedMemory);
+		}
+	}
+
+	// 应答总是 JSON，直接写入发送缓冲区，确保在切换编码之前发出
+	AppendFrame(InConnection, ToUtf8(SerializeJson(Reply)));
+	InConnection.bMessagePack = bMessagePack;
+}
+
+void FMCPEndpoint::AppendFrame(FConnection& InConnection, const TArray<uint8>& Payload)
+{
+	const uint32 Size = Payload.Num();
+	const uint8 Header[4] = { uint8(Size >> 24), uint8(Size >> 16), uint8(Size >> 8), uint8(Size) };
+	InConnection.SendBuffer.Append(Header, 4);
+	InConnection.SendBuffer.Append(Payload);
+}
+
+void FMCPEndpoint::EncodeOutgoing(const FConnection& InConnection, FOutgoingMessage& Outgoing, TArray<uint8>& OutPayload) const
+{
+	if (!InConnection.bMessagePack)
+	{
+		OutPayload = Outgoing.Message.IsValid() ? ToUtf8(SerializeJson(Outgoing.Message.ToSharedRef())) : MoveTemp(Outgoing.Payload);
+		return;
+	}
+
+	TSharedPtr<FJsonObject> Message = Outgoing.Message;
+	if (!Message.IsValid())
+	{
+		// Python 桥接返回的是 JSON 文本，转成 MessagePack 发给协商过的客户端
+		FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Outgoing.Payload.GetData()), Outgoing.Payload.Num());
+		TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(FString(Converted.Length(), Converted.Get()));
+		if (!FJsonSerializer::Deserialize(Reader, Message) || !Message.IsValid())
+		{
+			OutPayload = MoveTemp(Outgoing.Payload);
+			return;
+		}
+	}
+
+	OutPayload.Reset();
+	FMCPMessagePack::Encode(*Message, OutPayload);
+}
+
+bool FMCPEndpoint::CompressPayload(const FConnection& InConnection, const TArray<uint8>& Payload, TArray<uint8>& OutCompressed) const
+{
+	if (InConnection.Compression.IsNone() || Payload.Num() < InConnection.CompressionThreshold)
+	{
+		return false;
+	}
+
+	constexpr int32 HeaderSize = 6;
+	int32 CompressedSize = FCompression::CompressMemoryBound(InConnection.Compression, Payload.Num());
+	OutCompressed.SetNumUninitialized(HeaderSize + CompressedSize, MCPNoShrink);
+	if (!FCompression::CompressMemory(InConnection.Compression, OutCompressed.GetData() + HeaderSize, CompressedSize, Payload.GetData(), Payload.Num()))
+	{
+		return false;
+	}
+
+	// 压缩后没有明显变小（已压缩的数据等）时直接发送原始帧
+	if (HeaderSize + CompressedSize >= Payload.Num() - Payload.Num() / 16)
+	{
+		return false;
+	}
+
+	const uint32 RawSize = Payload.Num();
+	OutCompressed[0] = CompressedFrameMarker;
+	OutCompressed[1] = InConnection.Compression == NAME_LZ4 ? CompressionLZ4 : CompressionZlib;
+	OutCompressed[2] = uint8(RawSize >> 24);
+	OutCompressed[3] = uint8(RawSize >> 16);
+	OutCompressed[4] = uint8(RawSize >> 8);
+	OutCompressed[5] = uint8(RawSize);
+	OutCompressed.SetNum(HeaderSize + CompressedSize, MCPNoShrink);
+	return true;
+}
+
+TSharedPtr<FJsonObject> FMCPEndpoint::SetupSharedMemory(FConnection& InConnection)
+{
+	const int32 SizeMB = CVarMCPEndpointSharedMemorySizeMB.GetValueOnAnyThread();
+	if (SizeMB <= 0)
+	{
+		return nullptr;
+	}
+
+	// 只对回环地址的客户端提供，远程客户端无法访问本机共享内存
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> PeerAddress = SocketSubsystem->CreateInternetAddr();
+	InConnection.Socket->GetPeerAddress(*PeerAddress);
+	const FString PeerIp = PeerAddress->ToString(false);
+	if (!PeerIp.StartsWith(TEXT("127.")) && PeerIp != TEXT("::1") && !PeerIp.StartsWith(TEXT("::ffff:127.")))
+	{
+		UE_LOG(LogMCPServer, Log, TEXT("MCP endpoint: shared memory refused for non-local client %s (connection %u)"), *PeerIp, InConnection.Id);
+		return nullptr;
+	}
+
+	const FString Name = FString::Printf(TEXT("MCPEndpoint_%u_%u"), FPlatformProcess::GetCurrentProcessId(), InConnection.Id);
+	InConnection.SharedMemory = FMCPSharedMemoryRing::Create(Name, FMath::Min(SizeMB, 1024) * 1024 * 1024);
+	if (!InConnection.SharedMemory)
+	{
+		return nullptr;
+	}
+	InConnection.SharedMemoryThreshold = FMath::Max(CVarMCPEndpointSharedMemoryThreshold.GetValueOnAnyThread(), 1);
+
+	TSharedRef<FJsonObject> Description = MakeShared<FJsonObject>();
+	Description->SetStringField(TEXT("name"), InConnection.SharedMemory->GetClientName());
+	Description->SetNumberField(TEXT("size"), InConnection.SharedMemory->GetCapacity());
+	Description->SetNumberField(TEXT("threshold"), InConnection.SharedMemoryThreshold);
+	UE_LOG(LogMCPServer, Log, TEXT("MCP endpoint: shared memory ring %s (%d MB) for connection %u"), *Name, SizeMB, InConnection.Id);
+	return Description;
+}
+
+bool FMCPEndpoint::SendViaSharedMemory(FConnection& InConnection, const TArray<uint8>& Payload)
+{
+	if (!InConnection.SharedMemory || Payload.Num() < InConnection.SharedMemoryThreshold)
+	{
+		return false;
+	}
+
+	if (!InConnection.SharedMemory->Write(Payload.GetData(), Payload.Num()))
+	{
+		// 客户端读取落后，这一帧仍走 socket；引用帧和普通帧在 socket 上保持顺序
+		return false;
+	}
+
+	const uint32 Size = Payload.Num();
+	const TArray<uint8> Reference = { CompressedFrameMarker, SharedMemoryReference, uint8(Size >> 24), uint8(Size >> 16), uint8(Size >> 8), uint8(Size) };
+	AppendFrame(InConnection, Reference);
+	return true;
+}
+
+void FMCPEndpoint::QueueOutgoingMessages()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MCPEndpoint_QueueOutgoingMessages);
+
+	FOutgoingMessage Outgoing;
+	while (OutgoingMessages.Dequeue(Outgoing))
+	{
+		TUniquePtr<FConnection>* Target = Connections.Find(Outgoing.ConnectionId);
+		if (!Target)
+		{
+			// 连接已断开
+			continue;
+		}
+
+		// 拥塞时消息保持未编码，已有积压时新消息排在后面以保持顺序
+		FConnection& TargetConnection = **Target;
+		if (TargetConnection.DeferredMessages.Num() > 0 || IsSendQueueFull(TargetConnection))
+		{
+			TargetConnection.DeferredMessages.Add(MoveTemp(Outgoing));
+			continue;
+		}
+		WriteOutgoing(TargetConnection, Outgoing);
+	}
+}
+
+void FMCPEndpoint::WriteOutgoing(FConnection& InConnection, FOutgoingMessage& Outgoing)
+{
+	if (Outgoing.MetricsType.IsEmpty() && Outgoing.Message.IsValid())
+	{
+		Outgoing.Message->TryGetStringField(TEXT("type"), Outgoing.MetricsType);
+	}
+
+	const double EncodeStartTime = FPlatformTime::Seconds();
+	TArray<uint8> Payload;
+	EncodeOutgoing(InConnection, Outgoing, Payload);
+	int32 BytesSent = Payload.Num();
+	if (!SendViaSharedMemory(InConnection, Payload))
+	{
+		TArray<uint8> Compressed;
+		const bool bCompressed = CompressPayload(InConnection, Payload, Compressed);
+		BytesSent = bCompressed ? Compressed.Num() : Payload.Num();
+		AppendFrame(InConnection, bCompressed ? Compressed : Payload);
+	}
+	Metrics.RecordSent(Outgoing.MetricsType, 4 + BytesSent, FPlatformTime::Seconds() - EncodeStartTime);
+}
+
+void FMCPEndpoint::DrainDeferredMessages(FConnection& InConnection)
+{
+	int32 NumWritten = 0;
+	while (NumWritten < InConnection.DeferredMessages.Num() && !IsSendQueueFull(InConnection))
+	{
+		WriteOutgoing(InConnection, InConnection.DeferredMessages[NumWritten++]);
+	}
+
+	if (NumWritten > 0)
+	{
+		InConnection.DeferredMessages.RemoveAt(0, NumWritten);
+	}
+}
+
+bool FMCPEndpoint::IsSendQueueFull(const FConnection& InConnection) const
+{
+	const int64 LimitBytes = int64(CVarMCPEndpointSendQueueLimitKB.GetValueOnAnyThread()) * 1024;
+	return LimitBytes > 0 && InConnection.GetPendingSendBytes() >= LimitBytes;
+}
+
+void FMCPEndpoint::UpdateCongestion(FConnection& InConnection)
+{
+	const bool bCongested = InConnection.DeferredMessages.Num() > 0 || IsSendQueueFull(InConnection);
+	if (bCongested == InConnection.bCongested)
+	{
+		return;
+	}
+
+	InConnection.bCongested = bCongested;
+	{
+		FScopeLock Lock(&CongestionMutex);
+		if (bCongested)
+		{
+			CongestedConnections.Add(InConnection.Id);
+		}
+		else
+		{
+			CongestedConnections.Remove(InConnection.Id);
+		}
+	}
+	UE_LOG(LogMCPServer, Verbose, TEXT("MCP endpoint: connection %u send queue %s (%d bytes pending)"),
+		InConnection.Id, bCongested ? TEXT("full, pausing producers") : TEXT("drained, resuming"), InConnection.GetPendingSendBytes());
+}
+
+bool FMCPEndpoint::FlushSendBuffer(FConnection& InConnection)
+{
+	int32 TotalSent = InConnection.SendOffset;
+	while (TotalSent < InConnection.SendBuffer.Num())
+	{
+		int32 BytesSent = 0;
+		if (!InConnection.Socket->Send(InConnection.SendBuffer.GetData() + TotalSent, InConnection.SendBuffer.Num() - TotalSent, BytesSent))
+		{
+			const ESocketErrors Error = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+			if (Error == SE_EWOULDBLOCK)
+			{
+				// 发送缓冲区满，剩余部分下次循环再发
+				break;
+			}
+
+			UE_LOG(LogMCPServer, Log, TEXT("MCP endpoint: send failed (connection %u)"), InConnection.Id);
+			return false;
+		}
+
+		if (BytesSent <= 0)
+		{
+			break;
+		}
+		TotalSent += BytesSent;
+	}
+
+	InConnection.SendOffset = TotalSent;
+	if (InConnection.SendOffset >= InConnection.SendBuffer.Num())
+	{
+		// 全部发出；超大帧留下的分配不保留
+		const int64 LimitBytes = int64(CVarMCPEndpointSendQueueLimitKB.GetValueOnAnyThread()) * 1024;
+		if (LimitBytes > 0 && InConnection.SendBuffer.Max() > LimitBytes)
+		{
+			InConnection.SendBuffer.Empty();
+		}
+		else
+		{
+			InConnection.SendBuffer.Reset();
+		}
+		InConnection.SendOffset = 0;
+	}
+	else if (InConnection.SendOffset >= InConnection.SendBuffer.Num() / 2)
+	{
+		// 已发送部分过半时才整体前移，部分写入不必每次搬动剩余数据
+		InConnection.SendBuffer.RemoveAt(0, InConnection.SendOffset, MCPNoShrink);
+		InConnection.SendOffset = 0;
+	}
+	return true;
+}
+
+void FMCPEndpoint::CloseConnection(uint32 ConnectionId)
+{
+	TUniquePtr<FConnection> Closed;
+	if (!Connections.RemoveAndCopyValue(ConnectionId, Closed))
+	{
+		return;
+	}
+
+	Closed->Socket->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Closed->Socket);
+	NumConnections = Connections.Num();
+	if (Closed->bCongested)
+	{
+		FScopeLock Lock(&CongestionMutex);
+		CongestedConnections.Remove(ConnectionId);
+	}
+
+	// 通知游戏线程清理该连接排队中的请求和分块导出
+	FIncomingEvent Event;
+	Event.Request.ConnectionId = ConnectionId;
+	Event.bConnectionClosed = true;
+	IncomingEvents.Enqueue(MoveTemp(Event));
+}
+
+void FMCPEndpoint::CloseAllConnections()
+{
+	TArray<uint32> ConnectionIds;
+	Connections.GetKeys(ConnectionIds);
+	for (uint32 ConnectionId : ConnectionIds)
+	{
+		CloseConnection(ConnectionId);
+	}
+}
+
+bool FMCPEndpoint::Tick(float DeltaTime)
+{
+	const double FrameStartTime = FPlatformTime::Seconds();
+	LastTickTime = FrameStartTime;
+	LastTickFrame = GFrameCounter;
+
+	FIncomingEvent Event;
+	while (IncomingEvents.Dequeue(Event))
+	{
+		if (Event.bConnectionClosed)
+		{
+			DropConnectionState(Event.Request.ConnectionId);
+		}
+		else
+		{
+			--NumIncomingRequests;
+			Scheduler.Enqueue(MoveTemp(Event.Request));
+		}
+	}
+	NumScheduledRequests = Scheduler.Num();
+
+	Scheduler.Execute(FrameStartTime,
+		[this](const FMCPEndpointRequest& Request)
+		{
+			if (Request.IsCancelled())
+			{
+				SendCancelled(Request.ConnectionId, Request.Id);
+				return;
+			}
+
+			TRACE_CPUPROFILER_EVENT_SCOPE(MCPEndpoint_Request);
+			TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*Metrics.GetTypeKey(Request.Type));
+			FMCPCancellationScope CancellationScope(Request.CancelToken);
+			const double StartTime = FPlatformTime::Seconds();
+			bGameThreadBusy = true;
+			BeginRequest(Request);
+			HandleRequest(Request);
+			EndRequest();
+			bGameThreadBusy = false;
+			Metrics.RecordExecuted(Request.Type, StartTime - Request.ReceiveTime, FPlatformTime::Seconds() - StartTime);
+		},
+		[this](const FMCPEndpointRequest& Request)
+		{
+			HandleExpiredRequest(Request);
+		});
+	NumScheduledRequests = Scheduler.Num();
+
+	AdvanceStreams(FrameStartTime);
+
+	// 本帧积压的事件合并推送，发送队列已满的连接留到之后的帧
+	EventHub.Flush(
+		[this](uint32 ConnectionId)
+		{
+			return IsConnectionCongested(ConnectionId);
+		},
+		[this](uint32 ConnectionId, const TSharedRef<FJsonObject>& Message)
+		{
+			SendMessage(ConnectionId, Message);
+		});
+	return true;
+}
+
+void FMCPEndpoint::BeginRequest(const FMCPEndpointRequest& Request)
+{
+	FScopeLock Lock(&CurrentRequestMutex);
+	CurrentRequest.bActive = true;
+	CurrentRequest.ConnectionId = Request.ConnectionId;
+	CurrentRequest.Id = Request.Id;
+	CurrentRequest.Type = Request.Type;
+	CurrentRequest.bStreamLogs = false;
+	CurrentRequest.StartTime = FPlatformTime::Seconds();
+	Request.Message->TryGetBoolField(TEXT("progress"), CurrentRequest.bStreamLogs);
+	PendingRequestLog.Reset();
+	LastRequestLogFlushTime = CurrentRequest.StartTime;
+}
+
+void FMCPEndpoint::EndRequest()
+{
+	FScopeLock Lock(&CurrentRequestMutex);
+	CurrentRequest = FCurrentRequest();
+	PendingRequestLog.Reset();
+}
+
+bool FMCPEndpoint::ReportProgress(const FString& Message, float Fraction)
+{
+	check(IsInGameThread());
+
+	uint32 ConnectionId = 0;
+	TSharedRef<FJsonObject> Progress = MakeShared<FJsonObject>();
+	{
+		FScopeLock Lock(&CurrentRequestMutex);
+		if (!CurrentRequest.bActive)
+		{
+			return false;
+		}
+		ConnectionId = CurrentRequest.ConnectionId;
+		Progress->SetStringField(TEXT("type"), TEXT("progress"));
+		Progress->SetStringField(TEXT("id"), CurrentRequest.Id);
+		Progress->SetStringField(TEXT("message"), Message);
+		Progress->SetNumberField(TEXT("elapsed"), FPlatformTime::Seconds() - CurrentRequest.StartTime);
+		if (Fraction >= 0.0f)
+		{
+			Progress->SetNumberField(TEXT("progress"), FMath::Clamp(Fraction, 0.0f, 1.0f));
+		}
+	}
+
+	// 先发出之前的日志，保持与进度的先后顺序
+	FlushRequestLog(true);
+	SendMessage(ConnectionId, Progress);
+	return true;
+}
+
+bool FMCPEndpoint::SendPartialOutput(const FString& Text)
+{
+	uint32 ConnectionId = 0;
+	TSharedRef<FJsonObject> Partial = MakeShared<FJsonObject>();
+	{
+		FScopeLock Lock(&CurrentRequestMutex);
+		if (!CurrentRequest.bActive)
+		{
+			return false;
+		}
+		ConnectionId = CurrentRequest.ConnectionId;
+		Partial->SetStringField(TEXT("type"), TEXT("partial"));
+		Partial->SetStringField(TEXT("id"), CurrentRequest.Id);
+		Partial->SetStringField(TEXT("stream"), TEXT("output"));
+		Partial->SetStringField(TEXT("data"), Text);
+	}
+
+	FlushRequestLog(true);
+	SendMessage(ConnectionId, Partial);
+	return true;
+}
+
+void FMCPEndpoint::CaptureRequestLog(const TCHAR* Text, ELogVerbosity::Type Verbosity, const FName& Category)
+{
+	if ((Verbosity & ELogVerbosity::VerbosityMask) > ELogVerbosity::Log)
+	{
+		return;
+	}
+
+	{
+		FScopeLock Lock(&CurrentRequestMutex);
+		if (!CurrentRequest.bActive || !CurrentRequest.bStreamLogs)
+		{
+			return;
+		}
+		PendingRequestLog += FOutputDeviceHelper::FormatLogLine(Verbosity, Category, Text);
+		PendingRequestLog += LINE_TERMINATOR;
+	}
+
+	// 发送只在游戏线程进行，其他线程的日志等下一次游戏线程日志或请求结束时一起发出
+	if (IsInGameThread())
+	{
+		FlushRequestLog(false);
+	}
+}
+
+void FMCPEndpoint::FlushRequestLog(bool bForce)
+{
+	uint32 ConnectionId = 0;
+	TSharedRef<FJsonObject> Partial = MakeShared<FJsonObject>();
+	{
+		FScopeLock Lock(&CurrentRequestMutex);
+		if (!CurrentRequest.bActive || PendingRequestLog.IsEmpty())
+		{
+			return;
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		if (!bForce && Now - LastRequestLogFlushTime < RequestLogFlushInterval && PendingRequestLog.Len() < RequestLogFlushSize)
+		{
+			return;
+		}
+
+		LastRequestLogFlushTime = Now;
+		ConnectionId = CurrentRequest.ConnectionId;
+		Partial->SetStringField(TEXT("type"), TEXT("partial"));
+		Partial->SetStringField(TEXT("id"), CurrentRequest.Id);
+		Partial->SetStringField(TEXT("stream"), TEXT("log"));
+		Partial->SetStringField(TEXT("data"), MoveTemp(PendingRequestLog));
+		PendingRequestLog.Reset();
+	}
+
+	SendMessage(ConnectionId, Partial);
+}
+
+void FMCPEndpoint::DropConnectionState(uint32 ConnectionId)
+{
+	Scheduler.RemoveConnection(ConnectionId);
+	EventHub.RemoveConnection(ConnectionId);
+	ActiveStreams.RemoveAll([ConnectionId](const FActiveStream& Stream)
+	{
+		return Stream.ConnectionId == ConnectionId;
+	});
+}
+
+bool FMCPEndpoint::IsConnectionCongested(uint32 ConnectionId) const
+{
+	FScopeLock Lock(&CongestionMutex);
+	return CongestedConnections.Contains(ConnectionId);
+}
+
+void FMCPEndpoint::HandleRequest(const FMCPEndpointRequest& Request)
+{
+	if (Request.Type == TEXT("get_state"))
+	{
+		SendMessage(Request.ConnectionId, MakeStateMessage(TEXT("state"), Request.Id));
+	}
+	else if (Request.Type == TEXT("dump_stream"))
+	{
+		StartStream(Request);
+	}
+	else if (Request.Type == TEXT("batch"))
+	{
+		HandleBatch(Request);
+	}
+	else if (Request.Type == TEXT("subscribe") || Request.Type == TEXT("unsubscribe"))
+	{
+		SendMessage(Request.ConnectionId, HandleSubscription(Request));
+	}
+	else if (TSharedPtr<FJsonObject> NativeResult = FMCPNativeHandlerRegistry::Get().HandleRequest(*Request.Message))
+	{
+		SendMessage(Request.ConnectionId, NativeResult.ToSharedRef());
+	}
+	else
+	{
+		DispatchToPython(Request);
+	}
+}
+
+void FMCPEndpoint::HandleBatch(const FMCPEndpointRequest& Request)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+	if (!Request.Message->TryGetArrayField(TEXT("requests"), Entries))
+	{
+		SendError(Request.ConnectionId, Request.Id, TEXT("batch requires a requests array"));
+		return;
+	}
+	if (Entries->Num() > MaxBatchSize)
+	{
+		SendError(Request.ConnectionId, Request.Id, FString::Printf(TEXT("batch has %d requests, the limit is %d"), Entries->Num(), MaxBatchSize));
+		return;
+	}
+
+	bool bStopOnError = false;
+	bool bReportProgress = false;
+	Request.Message->TryGetBoolField(TEXT("stop_on_error"), bStopOnError);
+	Request.Message->TryGetBoolField(TEXT("progress"), bReportProgress);
+
+	TArray<TSharedPtr<FJsonValue>> Results;
+	Results.Reserve(Entries->Num());
+	int32 Completed = 0;
+	int32 FailedIndex = INDEX_NONE;
+	bool bCancelled = false;
+
+	for (int32 Index = 0; Index < Entries->Num(); ++Index)
+	{
+		const TSharedPtr<FJsonObject>* EntryObject = nullptr;
+		const bool bValidEntry = (*Entries)[Index].IsValid() && (*Entries)[Index]->TryGetObject(EntryObject);
+
+		// 子请求没有 id 时按位置生成，便于客户端对应
+		FString EntryId = FString::Printf(TEXT("%s#%d"), *Request.Id, Index);
+		if (bValidEntry)
+		{
+			(*EntryObject)->TryGetStringField(TEXT("id"), EntryId);
+		}
+
+		TSharedPtr<FJsonObject> EntryResult;
+		if (bCancelled || (bStopOnError && FailedIndex != INDEX_NONE))
+		{
+			EntryResult = bCancelled ? MakeCancelledResult(EntryId) : MakeErrorResult(EntryId, TEXT("Skipped after an earlier request in the batch failed"));
+			EntryResult->SetBoolField(TEXT("skipped"), true);
+		}
+		else if (Request.IsCancelled())
+		{
+			bCancelled = true;
+			EntryResult = MakeCancelledResult(EntryId);
+			EntryResult->SetBoolField(TEXT("skipped"), true);
+		}
+		else if (!bValidEntry)
+		{
+			EntryResult = MakeErrorResult(EntryId, TEXT("batch entries must be request objects"));
+		}
+		else
+		{
+			if (bReportProgress)
+			{
+				FString EntryType;
+				(*EntryObject)->TryGetStringField(TEXT("type"), EntryType);
+				ReportProgress(FString::Printf(TEXT("%s (%d/%d)"), *EntryType, Index + 1, Entries->Num()), static_cast<float>(Index) / Entries->Num());
+			}
+
+			TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>(**EntryObject);
+			Entry->SetStringField(TEXT("id"), EntryId);
+			EntryResult = ExecuteBatchEntry(Request, Entry);
+			++Completed;
+		}
+
+		// Python 转发器的错误响应是 {"type": "error"}，没有 success 字段
+		bool bEntrySuccess = false;
+		if (!EntryResult->TryGetBoolField(TEXT("success"), bEntrySuccess))
+		{
+			FString ResultType;
+			EntryResult->TryGetStringField(TEXT("type"), ResultType);
+			bEntrySuccess = ResultType != TEXT("error");
+		}
+		if (!bEntrySuccess && FailedIndex == INDEX_NONE && !EntryResult->HasField(TEXT("skipped")))
+		{
+			FailedIndex = Index;
+		}
+
+		Results.Add(MakeShared<FJsonValueObject>(EntryResult));
+	}
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetStringField(TEXT("type"), TEXT("result"));
+	Result->SetStringField(TEXT("id"), Request.Id);
+	Result->SetBoolField(TEXT("success"), FailedIndex == INDEX_NONE && !bCancelled);
+	Result->SetNumberField(TEXT("completed"), Completed);
+	if (FailedIndex != INDEX_NONE)
+	{
+		Result->SetNumberField(TEXT("failed_index"), FailedIndex);
+	}
+	if (bCancelled)
+	{
+		Result->SetBoolField(TEXT("cancelled"), true);
+	}
+	Result->SetArrayField(TEXT("results"), Results);
+	SendMessage(Request.ConnectionId, Result);
+}
+
+TSharedRef<FJsonObject> FMCPEndpoint::HandleSubscription(const FMCPEndpointRequest& Request)
+{
+	if (Request.Type == TEXT("unsubscribe"))
+	{
+		FString TargetId;
+		Request.Message->TryGetStringField(TEXT("target"), TargetId);
+		const int32 Removed = EventHub.Unsubscribe(Request.ConnectionId, TargetId);
+
+		TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+		Result->SetStringField(TEXT("type"), TEXT("result"));
+		Result->SetStringField(TEXT("id"), Request.Id);
+		Result->SetBoolField(TEXT("success"), true);
+		Result->SetStringField(TEXT("target"), TargetId);
+		Result->SetNumberField(TEXT("removed"), Removed);
+		return Result;
+	}
+
+	FString Error;
+	TSharedPtr<FJsonObject> Result = EventHub.Subscribe(Request.ConnectionId, Request.Id, *Request.Message, Error);
+	return Result.IsValid() ? Result.ToSharedRef() : MakeErrorResult(Request.Id, Error);
+}
+
+TSharedRef<FJsonObject> FMCPEndpoint::ExecuteBatchEntry(const FMCPEndpointRequest& Batch, const TSharedRef<FJsonObject>& Entry)
+{
+	FMCPEndpointRequest SubRequest;
+	SubRequest.ConnectionId = Batch.ConnectionId;
+	SubRequest.Message = Entry;
+	SubRequest.ReceiveTime = Batch.ReceiveTime;
+	// 共用 batch 的取消标记，取消 batch 也会中断正在执行的子请求
+	SubRequest.CancelToken = Batch.CancelToken;
+	Entry->TryGetStringField(TEXT("type"), SubRequest.Type);
+	Entry->TryGetStringField(TEXT("id"), SubRequest.Id);
+
+	if (SubRequest.Type == TEXT("ping") || SubRequest.Type == TEXT("heartbeat"))
+	{
+		return MakeStateMessage(SubRequest.Type == TEXT("ping") ? TEXT("pong") : TEXT("heartbeat"), SubRequest.Id);
+	}
+	if (SubRequest.Type == TEXT("get_state"))
+	{
+		return MakeStateMessage(TEXT("state"), SubRequest.Id);
+	}
+	if (SubRequest.Type == TEXT("subscribe") || SubRequest.Type == TEXT("unsubscribe"))
+	{
+		return HandleSubscription(SubRequest);
+	}
+	if (SubRequest.Type == TEXT("batch") || SubRequest.Type == TEXT("dump_stream") || SubRequest.Type == TEXT("hello") || SubRequest.Type == TEXT("cancel"))
+	{
+		return MakeErrorResult(SubRequest.Id, FString::Printf(TEXT("'%s' cannot be used inside a batch"), *SubRequest.Type));
+	}
+	if (TSharedPtr<FJsonObject> NativeResult = FMCPNativeHandlerRegistry::Get().HandleRequest(*Entry))
+	{
+		return NativeResult.ToSharedRef();
+	}
+
+	if (!RunPythonBridge(SubRequest))
+	{
+		return MakeErrorResult(SubRequest.Id, FString::Printf(TEXT("Python is not available to handle '%s'"), *SubRequest.Type));
+	}
+
+	FString ResponseJson = MoveTemp(PendingPythonResponse);
+	PendingPythonResponse.Reset();
+	if (SubRequest.IsCancelled())
+	{
+		return MakeCancelledResult(SubRequest.Id);
+	}
+	if (ResponseJson.IsEmpty())
+	{
+		return MakeErrorResult(SubRequest.Id, FString::Printf(TEXT("Python handler returned no response for '%s'"), *SubRequest.Type));
+	}
+
+	TSharedPtr<FJsonObject> Response;
+	TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(ResponseJson);
+	if (!FJsonSerializer::Deserialize(Reader, Response) || !Response.IsValid())
+	{
+		return MakeErrorResult(SubRequest.Id, FString::Printf(TEXT("Python handler returned an invalid response for '%s'"), *SubRequest.Type));
+	}
+	return Response.ToSharedRef();
+}
+
+void FMCPEndpoint::HandleExpiredRequest(const FMCPEndpointRequest& Request)
+{
+	const double WaitedMs = (FPlatformTime::Seconds() - Request.ReceiveTime) * 1000.0;
+	Metrics.RecordExpired(Request.Type, WaitedMs / 1000.0);
+	UE_LOG(LogMCPServer, Verbose, TEXT("MCP endpoint: request %s (%s) expired after %.1f ms in queue"), *Request.Id, *Request.Type, WaitedMs);
+	SendError(Request.ConnectionId, Request.Id, FString::Printf(TEXT("Request '%s' expired after waiting %.0f ms in the editor queue"), *Request.Type, WaitedMs));
+}
+
+void FMCPEndpoint::StartStream(const FMCPEndpointRequest& Request)
+{
+	const FJsonObject& Message = *Request.Message;
+
+	FActiveStream Stream;
+	Stream.ConnectionId = Request.ConnectionId;
+	Stream.Id = Request.Id;
+	Stream.CancelToken = Request.CancelToken;
+	if (!Message.TryGetStringField(TEXT("package_path"), Stream.PackagePath) || Stream.PackagePath.IsEmpty())
+	{
+		SendError(Request.ConnectionId, Request.Id, TEXT("dump_stream requires package_path"));
+		return;
+	}
+
+	if (!Message.TryGetStringField(TEXT("kind"), Stream.Kind))
+	{
+		Stream.Kind = TEXT("blueprint");
+	}
+
+	if (Stream.Kind == TEXT("table"))
+	{
+		FString RowFilter;
+		int32 StartRow = 0;
+		int32 MaxRows = 0;
+		Message.TryGetStringField(TEXT("row_filter"), RowFilter);
+		Message.TryGetNumberField(TEXT("start_row"), StartRow);
+		Message.TryGetNumberField(TEXT("max_rows"), MaxRows);
+		Message.TryGetNumberField(TEXT("chunk_rows"), Stream.ChunkRows);
+
+		FString Error;
+		Stream.Table = UMCPObjectInformDumpLibrary::PrepareTableDump(Stream.PackagePath, RowFilter, Error);
+		if (!Stream.Table.IsValid())
+		{
+			SendError(Request.ConnectionId, Request.Id, Error);
+			return;
+		}
+
+		const int32 NumMatched = Stream.Table->MatchedRows.Num();
+		Stream.Cursor = FMath::Clamp(StartRow, 0, NumMatched);
+		Stream.EndRow = MaxRows > 0 ? FMath::Min(NumMatched, Stream.Cursor + MaxRows) : NumMatched;
+		Stream.ChunkRows = FMath::Max(Stream.ChunkRows, 1);
+	}
+	else
+	{
+		bool bVisibleOnly = false;
+		bool bModifiedOnly = false;
+		Message.TryGetBoolField(TEXT("visible_only"), bVisibleOnly);
+		Message.TryGetBoolField(TEXT("modified_only"), bModifiedOnly);
+		Message.TryGetNumberField(TEXT("chunk_chars"), Stream.ChunkChars);
+
+		FString Error;
+		Stream.Blueprint = UMCPObjectInformDumpLibrary::PrepareBlueprintDump(Stream.PackagePath, bVisibleOnly, bModifiedOnly, Error);
+		if (!Stream.Blueprint.IsValid())
+		{
+			SendError(Request.ConnectionId, Request.Id, Error);
+			return;
+		}
+	}
+
+	ActiveStreams.Add(MoveTemp(Stream));
+}
+
+void FMCPEndpoint::AdvanceStreams(double FrameStartTime)
+{
+	if (ActiveStreams.Num() == 0)
+	{
+		return;
+	}
+
+	// 导出与请求共用帧预算；每帧至少推进一个 chunk，避免预算被请求耗尽后导出永远停滞
+	const double BudgetEndTime = FrameStartTime + FMCPRequestScheduler::GetFrameBudgetSeconds();
+	const int32 NumStreams = ActiveStreams.Num();
+	const int32 StartIndex = NextStreamIndex % NumStreams;
+	TArray<int32> FinishedIndices;
+
+	int32 Visited = 0;
+	for (; Visited < NumStreams; ++Visited)
+	{
+		if (Visited > 0 && FPlatformTime::Seconds() >= BudgetEndTime)
+		{
+			break;
+		}
+
+		const int32 Index = (StartIndex + Visited) % NumStreams;
+		if (!AdvanceStream(ActiveStreams[Index]))
+		{
+			FinishedIndices.Add(Index);
+		}
+	}
+
+	FinishedIndices.Sort(TGreater<int32>());
+	for (int32 Index : FinishedIndices)
+	{
+		ActiveStreams.RemoveAt(Index);
+	}
+
+	// 下一帧从本帧未推进到的导出开始
+	NextStreamIndex = ActiveStreams.Num() > 0 ? (StartIndex + Visited - FinishedIndices.Num()) % ActiveStreams.Num() : 0;
+}
+
+bool FMCPEndpoint::AdvanceStream(FActiveStream& Stream)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MCPEndpoint_AdvanceStream);
+
+	if (Stream.CancelToken.IsValid() && Stream.CancelToken->IsCancelled())
+	{
+		SendCancelled(Stream.ConnectionId, Stream.Id);
+		return false;
+	}
+
+	if (IsConnectionCongested(Stream.ConnectionId))
+	{
+		// 客户端读取跟不上，等发送队列排空后再继续
+		return true;
+	}
+
+	FString Chunk;
+	int32 NextCursor = INDEX_NONE;
+
+	bGameThreadBusy = true;
+	if (Stream.Kind == TEXT("table"))
+	{
+		const int32 ChunkEnd = FMath::Min(Stream.Cursor + Stream.ChunkRows, Stream.EndRow);
+		if (Stream.Seq == 0)
+		{
+			Stream.Table->AppendHeader(Stream.Cursor, Stream.EndRow, Chunk);
+		}
+		for (int32 RowIndex = Stream.Cursor; RowIndex < ChunkEnd; ++RowIndex)
+		{
+			Stream.Table->AppendRow(RowIndex, Chunk);
+		}
+		NextCursor = ChunkEnd < Stream.EndRow ? ChunkEnd : INDEX_NONE;
+	}
+	else
+	{
+		NextCursor = Stream.Blueprint->AppendChunk(Stream.ChunkChars, Chunk) ? Stream.Blueprint->GetNextPropertyIndex() : INDEX_NONE;
+	}
+	bGameThreadBusy = false;
+
+	if (!Chunk.IsEmpty())
+	{
+		TSharedRef<FJsonObject> ChunkMessage = MakeShared<FJsonObject>();
+		ChunkMessage->SetStringField(TEXT("type"), TEXT("chunk"));
+		ChunkMessage->SetStringField(TEXT("id"), Stream.Id);
+		ChunkMessage->SetNumberField(TEXT("seq"), Stream.Seq);
+		ChunkMessage->SetStringField(TEXT("data"), Chunk);
+		SendMessage(Stream.ConnectionId, ChunkMessage);
+		Stream.Seq++;
+	}
+
+	if (NextCursor < 0)
+	{
+		TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+		Result->SetStringField(TEXT("type"), TEXT("result"));
+		Result->SetStringField(TEXT("id"), Stream.Id);
+		Result->SetBoolField(TEXT("success"), true);
+		Result->SetNumberField(TEXT("chunks"), Stream.Seq);
+		SendMessage(Stream.ConnectionId, Result);
+		return false;
+	}
+
+	Stream.Cursor = NextCursor;
+	return true;
+}
+
+void FMCPEndpoint::DispatchToPython(const FMCPEndpointRequest& Request)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MCPEndpoint_DispatchToPython);
+
+	if (!RunPythonBridge(Request))
+	{
+		SendError(Request.ConnectionId, Request.Id, FString::Printf(TEXT("Python is not available to handle '%s'"), *Request.Type));
+		return;
+	}
+
+	// 被中断的 Python 代码也会写回普通的失败响应（"Execution cancelled"），取消的请求统一回复 "cancelled": true
+	if (Request.IsCancelled())
+	{
+		PendingPythonResponse.Reset();
+		SendCancelled(Request.ConnectionId, Request.Id);
+		return;
+	}
+	if (PendingPythonResponse.IsEmpty())
+	{
+		SendError(Request.ConnectionId, Request.Id, FString::Printf(TEXT("Python handler returned no response for '%s'"), *Request.Type));
+		return;
+	}
+
+	SendRawMessage(Request.ConnectionId, PendingPythonResponse);
+	PendingPythonResponse.Reset();
+}
+
+bool FMCPEndpoint::RunPythonBridge(const FMCPEndpointRequest& Request)
+{
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+	{
+		return false;
+	}
+
+	PendingPythonRequest = SerializeJson(Request.Message.ToSharedRef());
+	PendingPythonResponse.Reset();
+
+	{
+		FScopeLock Lock(&PythonInterruptMutex);
+		PythonCancelToken = Request.CancelToken.Get();
+	}
+
+	// 桥接脚本通过 unreal.MCPEndpointLibrary 读取请求并写回响应
+	PythonPlugin->ExecPythonCommand(TEXT("import mcp_server.MCPEndpointBridge; mcp_server.MCPEndpointBridge.handle_pending()"));
+
+	{
+		// 清除未被消费的中断，避免落到之后无关的 Python 代码上
+		FScopeLock Lock(&PythonInterruptMutex);
+		PythonCancelToken = nullptr;
+		bPythonInterruptRequested = false;
+	}
+
+	// 任意 Python 代码都可能修改编辑器状态而不触发失效事件
+	FMCPResultCache::Get().Invalidate();
+
+	PendingPythonRequest.Reset();
+	FlushRequestLog(true);
+	return true;
+}
+
+void FMCPEndpoint::SendError(uint32 ConnectionId, const FString& RequestId, const FString& Error)
+{
+	SendMessage(ConnectionId, MakeErrorResult(RequestId, Error));
+}
+
+void FMCPEndpoint::SendCancelled(uint32 ConnectionId, const FString& RequestId)
+{
+	SendMessage(ConnectionId, MakeCancelledResult(RequestId));
+}
+
+TSharedRef<FJsonObject> FMCPEndpoint::MakeErrorResult(const FString& RequestId, const FString& Error)
+{
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetStringField(TEXT("type"), TEXT("result"));
+	Result->SetStringField(TEXT("id"), RequestId);
+	Result->SetBoolField(TEXT("success"), false);
+	Result->SetStringField(TEXT("error"), Error);
+	return Result;
+}
+
+TSharedRef<FJsonObject> FMCPEndpoint::MakeCancelledResult(const FString& RequestId)
+{
+	TSharedRef<FJsonObject> Result = MakeErrorResult(RequestId, TEXT("Request cancelled"));
+	Result->SetBoolField(TEXT("cancelled"), true);
+	return Result;
+}
+
+TSharedRef<FJsonObject> FMCPEndpoint::MakeStateMessage(const TCHAR* Type, const FString& RequestId) const
+{
+	TSharedRef<FJsonObject> Message = MakeShared<FJsonObject>();
+	Message->SetStringField(TEXT("type"), Type);
+	Message->SetStringField(TEXT("id"), RequestId);
+	Message->SetNumberField(TEXT("timestamp"), GetUnixTimestamp());
+
+	// 端点刚启动、游戏线程还没 tick 过时不算停滞
+	const double LastTick = LastTickTime.load();
+	const double SinceTickSeconds = LastTick > 0.0 ? FPlatformTime::Seconds() - LastTick : 0.0;
+	const bool bExecuting = bGameThreadBusy;
+	const bool bStalled = !bExecuting && SinceTickSeconds * 1000.0 >= CVarMCPEndpointStallThresholdMs.GetValueOnAnyThread();
+	Message->SetStringField(TEXT("state"), bExecuting ? TEXT("executing") : bStalled ? TEXT("stalled") : TEXT("idle"));
+	Message->SetBoolField(TEXT("busy"), bExecuting || bStalled);
+	Message->SetNumberField(TEXT("frame"), static_cast<double>(LastTickFrame.load()));
+	Message->SetNumberField(TEXT("since_tick_ms"), SinceTickSeconds * 1000.0);
+	Message->SetNumberField(TEXT("queued"), FMath::Max(NumIncomingRequests.load(), 0) + NumScheduledRequests.load());
+	Message->SetNumberField(TEXT("worker_requests"), NumWorkerRequests.load());
+
+	if (bExecuting)
+	{
+		FScopeLock Lock(&CurrentRequestMutex);
+		if (CurrentRequest.bActive)
+		{
+			Message->SetStringField(TEXT("request_type"), CurrentRequest.Type);
+			Message->SetNumberField(TEXT("request_ms"), (FPlatformTime::Seconds() - CurrentRequest.StartTime) * 1000.0);
+		}
+	}
+	return Message;
+}
@@ -0,0 +1,159 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPEndpointLibrary.h"
+#include "MCPServer.h"
+#include "MCPEndpoint.h"
+#include "MCPHttpServer.h"
+#include "MCPNativeHandlers.h"
+#include "MCPResultCache.h"
+#include "Dom/JsonObject.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+	FMCPServerModule* GetMCPModule()
+	{
+		return FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer");
+	}
+
+	TSharedPtr<FMCPEndpoint> GetEndpoint()
+	{
+		FMCPServerModule* MCPModule = GetMCPModule();
+		return MCPModule ? MCPModule->GetEndpoint() : nullptr;
+	}
+
+	/** 正在等待 Python 处理请求的 HTTP 服务器；两个端点都在游戏线程同步调用 Python，同一时刻只有一个在等待 */
+	TSharedPtr<FMCPHttpServer> GetHttpServerWaitingForPython()
+	{
+		FMCPServerModule* MCPModule = GetMCPModule();
+		TSharedPtr<FMCPHttpServer> HttpServer = MCPModule ? MCPModule->GetHttpServer() : nullptr;
+		return HttpServer.IsValid() && !HttpServer->GetPendingPythonRequest().IsEmpty() ? HttpServer : nullptr;
+	}
+}
+
+bool UMCPEndpointLibrary::StartEndpoint(const FString& BindAddress, int32 Port)
+{
+	FMCPServerModule* MCPModule = GetMCPModule();
+	return MCPModule && MCPModule->StartEndpoint(BindAddress, Port);
+}
+
+void UMCPEndpointLibrary::StopEndpoint()
+{
+	if (FMCPServerModule* MCPModule = GetMCPModule())
+	{
+		MCPModule->StopEndpoint();
+	}
+}
+
+bool UMCPEndpointLibrary::IsEndpointRunning()
+{
+	TSharedPtr<FMCPEndpoint> Endpoint = GetEndpoint();
+	return Endpoint.IsValid() && Endpoint->IsRunning();
+}
+
+bool UMCPEndpointLibrary::IsEndpointClientConnected()
+{
+	return GetEndpointConnectionCount() > 0;
+}
+
+int32 UMCPEndpointLibrary::GetEndpointConnectionCount()
+{
+	TSharedPtr<FMCPEndpoint> Endpoint = GetEndpoint();
+	return Endpoint.IsValid() ? Endpoint->GetConnectionCount() : 0;
+}
+
+bool UMCPEndpointLibrary::StartHttpServer(int32 Port, const FString& Path, const FString& BindAddress)
+{
+	FMCPServerModule* MCPModule = GetMCPModule();
+	return MCPModule && MCPModule->StartHttpServer(Port, Path, BindAddress);
+}
+
+void UMCPEndpointLibrary::StopHttpServer()
+{
+	if (FMCPServerModule* MCPModule = GetMCPModule())
+	{
+		MCPModule->StopHttpServer();
+	}
+}
+
+bool UMCPEndpointLibrary::IsHttpServerRunning()
+{
+	FMCPServerModule* MCPModule = GetMCPModule();
+	return MCPModule && MCPModule->GetHttpServer().IsValid() && MCPModule->GetHttpServer()->IsRunning();
+}
+
+FString UMCPEndpointLibrary::GetPendingPythonRequest()
+{
+	if (TSharedPtr<FMCPHttpServer> HttpServer = GetHttpServerWaitingForPython())
+	{
+		return HttpServer->GetPendingPythonRequest();
+	}
+
+	TSharedPtr<FMCPEndpoint> Endpoint = GetEndpoint();
+	return Endpoint.IsValid() ? Endpoint->GetPendingPythonRequest() : FString();
+}
+
+void UMCPEndpointLibrary::SetPendingPythonResponse(const FString& ResponseJson)
+{
+	if (TSharedPtr<FMCPHttpServer> HttpServer = GetHttpServerWaitingForPython())
+	{
+		HttpServer->SetPendingPythonResponse(ResponseJson);
+		return;
+	}
+
+	if (TSharedPtr<FMCPEndpoint> Endpoint = GetEndpoint())
+	{
+		Endpoint->SetPendingPythonResponse(ResponseJson);
+	}
+}
+
+FString UMCPEndpointLibrary::ExecuteNativeRequest(const FString& RequestJson)
+{
+	TSharedPtr<FJsonObject> Request;
+	TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(RequestJson);
+	if (!FJsonSerializer::Deserialize(Reader, Request) || !Request.IsValid())
+	{
+		return FString();
+	}
+
+	TSharedPtr<FJsonObject> Result = FMCPNativeHandlerRegistry::Get().HandleRequest(*Request);
+	if (!Result.IsValid())
+	{
+		return FString();
+	}
+
+	FString ResultJson;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ResultJson);
+	FJsonSerializer::Serialize(Result.ToSharedRef(), Writer);
+	return ResultJson;
+}
+
+TArray<FString> UMCPEndpointLibrary::GetNativeRequestTypes()
+{
+	return FMCPNativeHandlerRegistry::Get().GetHandlerTypes();
+}
+
+bool UMCPEndpointLibrary::ReportProgress(const FString& Message, float Fraction)
+{
+	TSharedPtr<FMCPEndpoint> Endpoint = GetEndpoint();
+	return Endpoint.IsValid() && Endpoint->ReportProgress(Message, Fraction);
+}
+
+bool UMCPEndpointLibrary::SendPartialOutput(const FString& Text)
+{
+	TSharedPtr<FMCPEndpoint> Endpoint = GetEndpoint();
+	return Endpoint.IsValid() && Endpoint->SendPartialOutput(Text);
+}
+
+bool UMCPEndpointLibrary::IsCurrentRequestCancelled()
+{
+	return FMCPCancellationScope::IsCancellationRequested();
+}
+
+void UMCPEndpointLibrary::InvalidateResultCache()
+{
+	FMCPResultCache::Get().Invalidate();
+}
@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPEndpointMetrics.h"
+
+#include "Dom/JsonObject.h"
+
+namespace MCPEndpointMetrics
+{
+	double ToMs(double Seconds)
+	{
+		return Seconds * 1000.0;
+	}
+}
+
+void FMCPLatencyHistogram::Add(double Seconds)
+{
+	const uint64 Micros = static_cast<uint64>(FMath::Max(Seconds, 0.0) * 1000000.0);
+	const int32 Bucket = Micros == 0 ? 0 : FMath::Min<int32>(FMath::FloorLog2_64(Micros) + 1, NumBuckets - 1);
+	++Buckets[Bucket];
+	++Count;
+	TotalSeconds += Seconds;
+	MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+}
+
+double FMCPLatencyHistogram::GetPercentileSeconds(double Fraction) const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+
+	const uint64 Target = FMath::Max<uint64>(static_cast<uint64>(FMath::CeilToDouble(Fraction * Count)), 1);
+	uint64 Cumulative = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Cumulative += Buckets[Bucket];
+		if (Cumulative >= Target)
+		{
+			// 桶上界不会超过实际最大值
+			return FMath::Min(static_cast<double>(1ull << Bucket) / 1000000.0, MaxSeconds);
+		}
+	}
+	return MaxSeconds;
+}
+
+TSharedRef<FJsonObject> FMCPLatencyHistogram::ToJson() const
+{
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("count"), static_cast<double>(Count));
+	Json->SetNumberField(TEXT("mean_ms"), MCPEndpointMetrics::ToMs(GetMeanSeconds()));
+	Json->SetNumberField(TEXT("p50_ms"), MCPEndpointMetrics::ToMs(GetPercentileSeconds(0.5)));
+	Json->SetNumberField(TEXT("p90_ms"), MCPEndpointMetrics::ToMs(GetPercentileSeconds(0.9)));
+	Json->SetNumberField(TEXT("p99_ms"), MCPEndpointMetrics::ToMs(GetPercentileSeconds(0.99)));
+	Json->SetNumberField(TEXT("max_ms"), MCPEndpointMetrics::ToMs(MaxSeconds));
+	return Json;
+}
+
+FMCPEndpointMetrics::FMCPEndpointMetrics()
+	: StartTime(FPlatformTime::Seconds())
+{
+}
+
+void FMCPEndpointMetrics::SetKnownTypeFilter(TFunction<bool(const FString& Type)> InIsKnownType)
+{
+	FScopeLock Lock(&Mutex);
+	IsKnownType = MoveTemp(InIsKnownType);
+}
+
+const FString& FMCPEndpointMetrics::GetTypeKey(const FString& Type) const
+{
+	static const FString Unknown(TEXT("(unknown)"));
+	// Record* 已持有 Mutex 时再次加锁（FCriticalSection 可重入）
+	FScopeLock Lock(&Mutex);
+	return Type.IsEmpty() || (IsKnownType && !IsKnownType(Type)) ? Unknown : Type;
+}
+
+void FMCPEndpointMetrics::RecordReceived(const FString& Type, int32 Bytes, double DecodeSeconds)
+{
+	FScopeLock Lock(&Mutex);
+	FMCPMessageTypeMetrics& Metrics = Types.FindOrAdd(GetTypeKey(Type));
+	++Metrics.MessagesIn;
+	Metrics.BytesIn += Bytes;
+	Metrics.Serialization.Add(DecodeSeconds);
+}
+
+void FMCPEndpointMetrics::RecordExecuted(const FString& Type, double QueueWaitSeconds, double ExecutionSeconds)
+{
+	FScopeLock Lock(&Mutex);
+	FMCPMessageTypeMetrics& Metrics = Types.FindOrAdd(GetTypeKey(Type));
+	++Metrics.Executed;
+	Metrics.QueueWait.Add(QueueWaitSeconds);
+	Metrics.Execution.Add(ExecutionSeconds);
+}
+
+void FMCPEndpointMetrics::RecordExpired(const FString& Type, double QueueWaitSeconds)
+{
+	FScopeLock Lock(&Mutex);
+	FMCPMessageTypeMetrics& Metrics = Types.FindOrAdd(GetTypeKey(Type));
+	++Metrics.Expired;
+	Metrics.QueueWait.Add(QueueWaitSeconds);
+}
+
+void FMCPEndpointMetrics::RecordSent(const FString& Type, int32 Bytes, double EncodeSeconds)
+{
+	FScopeLock Lock(&Mutex);
+	FMCPMessageTypeMetrics& Metrics = Types.FindOrAdd(GetTypeKey(Type));
+	++Metrics.MessagesOut;
+	Metrics.BytesOut += Bytes;
+	Metrics.Serialization.Add(EncodeSeconds);
+}
+
+void FMCPEndpointMetrics::Reset()
+{
+	FScopeLock Lock(&Mutex);
+	Types.Reset();
+	StartTime = FPlatformTime::Seconds();
+}
+
+TSharedRef<FJsonObject> FMCPEndpointMetrics::ToJson() const
+{
+	TSharedRef<FJsonObject> TypesJson = MakeShared<FJsonObject>();
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+
+	FScopeLock Lock(&Mutex);
+	for (const TPair<FString, FMCPMessageTypeMetrics>& Pair : Types)
+	{
+		const FMCPMessageTypeMetrics& Metrics = Pair.Value;
+		TSharedRef<FJsonObject> TypeJson = MakeShared<FJsonObject>();
+		TypeJson->SetNumberField(TEXT("executed"), static_cast<double>(Metrics.Executed));
+		TypeJson->SetNumberField(TEXT("expired"), static_cast<double>(Metrics.Expired));
+		TypeJson->SetNumberField(TEXT("messages_in"), static_cast<double>(Metrics.MessagesIn));
+		TypeJson->SetNumberField(TEXT("messages_out"), static_cast<double>(Metrics.MessagesOut));
+		TypeJson->SetNumberField(TEXT("bytes_in"), static_cast<double>(Metrics.BytesIn));
+		TypeJson->SetNumberField(TEXT("bytes_out"), static_cast<double>(Metrics.BytesOut));
+		TypeJson->SetObjectField(TEXT("queue_wait"), Metrics.QueueWait.ToJson());
+		TypeJson->SetObjectField(TEXT("execution"), Metrics.Execution.ToJson());
+		TypeJson->SetObjectField(TEXT("serialization"), Metrics.Serialization.ToJson());
+		TypesJson->SetObjectField(Pair.Key, TypeJson);
+	}
+
+	Json->SetNumberField(TEXT("uptime"), FPlatformTime::Seconds() - StartTime);
+	Json->SetObjectField(TEXT("types"), TypesJson);
+	return Json;
+}
+
+TArray<FString> FMCPEndpointMetrics::ToLines() const
+{
+	TArray<FString> Lines;
+
+	FScopeLock Lock(&Mutex);
+	Lines.Add(FString::Printf(TEXT("MCP endpoint stats over %.1f s (times in ms, p50/p99/max):"), FPlatformTime::Seconds() - StartTime));
+	Lines.Add(FString::Printf(TEXT("%-24s %8s %8s %24s %24s %24s %12s %12s"),
+		TEXT("Type"), TEXT("Exec"), TEXT("Expired"), TEXT("Queue wait"), TEXT("Execution"), TEXT("Serialization"), TEXT("Bytes in"), TEXT("Bytes out")));
+
+	TArray<FString> Keys;
+	Types.GetKeys(Keys);
+	Keys.Sort();
+	for (const FString& Key : Keys)
+	{
+		const FMCPMessageTypeMetrics& Metrics = Types[Key];
+		auto FormatHistogram = [](const FMCPLatencyHistogram& Histogram)
+		{
+			return FString::Printf(TEXT("%.2f/%.2f/%.2f"),
+				MCPEndpointMetrics::ToMs(Histogram.GetPercentileSeconds(0.5)),
+				MCPEndpointMetrics::ToMs(Histogram.GetPercentileSeconds(0.99)),
+				MCPEndpointMetrics::ToMs(Histogram.MaxSeconds));
+		};
+		Lines.Add(FString::Printf(TEXT("%-24s %8llu %8llu %24s %24s %24s %12llu %12llu"),
+			*Key, Metrics.Executed, Metrics.Expired,
+			*FormatHistogram(Metrics.QueueWait), *FormatHistogram(Metrics.Execution), *FormatHistogram(Metrics.Serialization),
+			Metrics.BytesIn, Metrics.BytesOut));
+	}
+	return Lines;
+}
@@ -0,0 +1,609 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPEventHub.h"
+
+#include "MCPServer.h"
+#include "Dom/JsonObject.h"
+#include "Editor.h"
+#include "Editor/TransBuffer.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Selection.h"
+#include "UObject/Package.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION >= 5
+#include "UObject/ObjectSaveContext.h"
+#endif
+
+static TAutoConsoleVariable<int32> CVarMCPEndpointMaxPendingEvents(
+	TEXT("MCP.Endpoint.MaxPendingEvents"),
+	1000,
+	TEXT("Maximum number of events buffered per subscription and topic between flushes. Further events are dropped and reported as \"dropped\"."),
+	ECVF_Default);
+
+namespace MCPEventHub
+{
+	static const TCHAR* const TopicNames[] =
+	{
+		TEXT("log"),
+		TEXT("transaction"),
+		TEXT("selection"),
+		TEXT("asset_saved"),
+		TEXT("pie"),
+	};
+	static_assert(UE_ARRAY_COUNT(TopicNames) == static_cast<int32>(EMCPEventTopic::Num), "Topic names must match EMCPEventTopic");
+
+	uint32 TopicBit(EMCPEventTopic Topic)
+	{
+		return 1u << static_cast<uint32>(Topic);
+	}
+
+	/** 与 Python 的 time.time() 一致的 Unix 时间戳（秒） */
+	double GetUnixTimestamp()
+	{
+		return (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalSeconds();
+	}
+}
+
+/** 把日志记录交给事件中心，任意线程都可能写日志 */
+class FMCPEventHub::FLogDevice : public FOutputDevice
+{
+public:
+	explicit FLogDevice(FMCPEventHub& InHub)
+		: Hub(InHub)
+	{
+	}
+
+	virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override
+	{
+		Hub.CaptureLog(V, Verbosity, Category);
+	}
+
+	virtual bool CanBeUsedOnAnyThread() const override
+	{
+		return true;
+	}
+
+private:
+	FMCPEventHub& Hub;
+};
+
+FMCPEventHub::FMCPEventHub()
+{
+}
+
+FMCPEventHub::~FMCPEventHub()
+{
+	Reset();
+}
+
+const TCHAR* FMCPEventHub::GetTopicName(EMCPEventTopic Topic)
+{
+	return MCPEventHub::TopicNames[static_cast<int32>(Topic)];
+}
+
+bool FMCPEventHub::ParseTopic(const FString& Name, EMCPEventTopic& OutTopic)
+{
+	for (int32 Index = 0; Index < static_cast<int32>(EMCPEventTopic::Num); ++Index)
+	{
+		if (Name == MCPEventHub::TopicNames[Index])
+		{
+			OutTopic = static_cast<EMCPEventTopic>(Index);
+			return true;
+		}
+	}
+	return false;
+}
+
+TSharedPtr<FJsonObject> FMCPEventHub::Subscribe(uint32 ConnectionId, const FString& SubscriptionId, const FJsonObject& Request, FString& OutError)
+{
+	check(IsInGameThread());
+
+	if (SubscriptionId.IsEmpty())
+	{
+		OutError = TEXT("subscribe requires an id, which becomes the subscription id");
+		return nullptr;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* TopicValues = nullptr;
+	if (!Request.TryGetArrayField(TEXT("topics"), TopicValues) || TopicValues->Num() == 0)
+	{
+		OutError = TEXT("subscribe requires a non-empty topics array (log, transaction, selection, asset_saved, pie)");
+		return nullptr;
+	}
+
+	FSubscription Subscription;
+	Subscription.ConnectionId = ConnectionId;
+	Subscription.Id = SubscriptionId;
+
+	TArray<TSharedPtr<FJsonValue>> AcceptedTopics;
+	for (const TSharedPtr<FJsonValue>& Value : *TopicValues)
+	{
+		EMCPEventTopic Topic;
+		FString Name;
+		if (!Value.IsValid() || !Value->TryGetString(Name) || !ParseTopic(Name, Topic))
+		{
+			OutError = FString::Printf(TEXT("Unknown event topic '%s'"), *Name);
+			return nullptr;
+		}
+		if (!Subscription.HasTopic(Topic))
+		{
+			Subscription.Topics |= MCPEventHub::TopicBit(Topic);
+			AcceptedTopics.Add(MakeShared<FJsonValueString>(Name));
+		}
+	}
+
+	FString VerbosityName;
+	if (Request.TryGetStringField(TEXT("min_verbosity"), VerbosityName))
+	{
+		Subscription.MinVerbosity = ParseLogVerbosityFromString(VerbosityName);
+		if (Subscription.MinVerbosity == ELogVerbosity::NoLogging)
+		{
+			OutError = FString::Printf(TEXT("Unknown log verbosity '%s'"), *VerbosityName);
+			return nullptr;
+		}
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* CategoryValues = nullptr;
+	if (Request.TryGetArrayField(TEXT("categories"), CategoryValues))
+	{
+		for (const TSharedPtr<FJsonValue>& Value : *CategoryValues)
+		{
+			FString Category;
+			if (Value.IsValid() && Value->TryGetString(Category) && !Category.IsEmpty())
+			{
+				Subscription.Categories.Add(FName(*Category));
+			}
+		}
+	}
+
+	Request.TryGetStringField(TEXT("path_prefix"), Subscription.PathPrefix);
+	Request.TryGetNumberField(TEXT("max_items"), Subscription.MaxItems);
+	Subscription.MaxItems = FMath::Max(Subscription.MaxItems, 0);
+
+	// 同一连接上重复使用订阅 ID 时替换旧订阅
+	Subscriptions.RemoveAll([ConnectionId, &SubscriptionId](const FSubscription& Existing)
+	{
+		return Existing.ConnectionId == ConnectionId && Existing.Id == SubscriptionId;
+	});
+	Subscriptions.Add(MoveTemp(Subscription));
+	UpdateListeners();
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetStringField(TEXT("type"), TEXT("result"));
+	Result->SetStringField(TEXT("id"), SubscriptionId);
+	Result->SetBoolField(TEXT("success"), true);
+	Result->SetStringField(TEXT("subscription"), SubscriptionId);
+	Result->SetArrayField(TEXT("topics"), AcceptedTopics);
+	return Result;
+}
+
+int32 FMCPEventHub::Unsubscribe(uint32 ConnectionId, const FString& SubscriptionId)
+{
+	check(IsInGameThread());
+
+	const int32 Removed = Subscriptions.RemoveAll([ConnectionId, &SubscriptionId](const FSubscription& Existing)
+	{
+		return Existing.ConnectionId == ConnectionId && (SubscriptionId.IsEmpty() || Existing.Id == SubscriptionId);
+	});
+	if (Removed > 0)
+	{
+		UpdateListeners();
+	}
+	return Removed;
+}
+
+void FMCPEventHub::RemoveConnection(uint32 ConnectionId)
+{
+	Unsubscribe(ConnectionId, FString());
+}
+
+void FMCPEventHub::Reset()
+{
+	Subscriptions.Empty();
+	UpdateListeners();
+}
+
+void FMCPEventHub::UpdateListeners()
+{
+	uint32 WantedTopics = 0;
+	int32 Verbosity = ELogVerbosity::NoLogging;
+	for (const FSubscription& Subscription : Subscriptions)
+	{
+		WantedTopics |= Subscription.Topics;
+		if (Subscription.HasTopic(EMCPEventTopic::Log))
+		{
+			Verbosity = FMath::Max<int32>(Verbosity, Subscription.MinVerbosity);
+		}
+	}
+	CaptureVerbosity = Verbosity;
+
+	for (int32 Index = 0; Index < static_cast<int32>(EMCPEventTopic::Num); ++Index)
+	{
+		const EMCPEventTopic Topic = static_cast<EMCPEventTopic>(Index);
+		const uint32 Bit = MCPEventHub::TopicBit(Topic);
+		if ((WantedTopics & Bit) && !(ListeningTopics & Bit))
+		{
+			StartListening(Topic);
+		}
+		else if (!(WantedTopics & Bit) && (ListeningTopics & Bit))
+		{
+			StopListening(Topic);
+		}
+	}
+	ListeningTopics = WantedTopics;
+}
+
+void FMCPEventHub::StartListening(EMCPEventTopic Topic)
+{
+	switch (Topic)
+	{
+	case EMCPEventTopic::Log:
+		LogDevice = MakeUnique<FLogDevice>(*this);
+		GLog->AddOutputDevice(LogDevice.Get());
+		break;
+
+	case EMCPEventTopic::Transaction:
+		if (UTransBuffer* TransBuffer = GEditor ? Cast<UTransBuffer>(GEditor->Trans) : nullptr)
+		{
+			TransactionStateHandle = TransBuffer->OnTransactionStateChanged().AddRaw(this, &FMCPEventHub::OnTransactionStateChanged);
+		}
+		break;
+
+	case EMCPEventTopic::Selection:
+		SelectionChangedHandle = USelection::SelectionChangedEvent.AddRaw(this, &FMCPEventHub::OnSelectionChanged);
+		SelectObjectHandle = USelection::SelectObjectEvent.AddRaw(this, &FMCPEventHub::OnSelectionChanged);
+		break;
+
+	case EMCPEventTopic::AssetSaved:
+#if ENGINE_MAJOR_VERSION >= 5
+		PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddLambda([this](const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext ObjectSaveContext)
+		{
+			if (Package && !ObjectSaveContext.IsProceduralSave())
+			{
+				OnPackageSaved(PackageFileName, Package->GetName());
+			}
+		});
+#else
+		PackageSavedHandle = UPackage::PackageSavedEvent.AddLambda([this](const FString& PackageFileName, UObject* PackageObject)
+		{
+			if (PackageObject)
+			{
+				OnPackageSaved(PackageFileName, PackageObject->GetName());
+			}
+		});
+#endif
+		break;
+
+	case EMCPEventTopic::PIE:
+		BeginPIEHandle = FEditorDelegates::BeginPIE.AddLambda([this](const bool bIsSimulating)
+		{
+			OnPIEStateChanged(TEXT("started"), bIsSimulating);
+		});
+		EndPIEHandle = FEditorDelegates::EndPIE.AddLambda([this](const bool bIsSimulating)
+		{
+			OnPIEStateChanged(TEXT("stopped"), bIsSimulating);
+		});
+		PausePIEHandle = FEditorDelegates::PausePIE.AddLambda([this](const bool bIsSimulating)
+		{
+			OnPIEStateChanged(TEXT("paused"), bIsSimulating);
+		});
+		ResumePIEHandle = FEditorDelegates::ResumePIE.AddLambda([this](const bool bIsSimulating)
+		{
+			OnPIEStateChanged(TEXT("resumed"), bIsSimulating);
+		});
+		break;
+
+	default:
+		break;
+	}
+}
+
+void FMCPEventHub::StopListening(EMCPEventTopic Topic)
+{
+	switch (Topic)
+	{
+	case EMCPEventTopic::Log:
+		if (LogDevice)
+		{
+			if (GLog)
+			{
+				GLog->RemoveOutputDevice(LogDevice.Get());
+			}
+			LogDevice.Reset();
+		}
+		{
+			FScopeLock Lock(&LogMutex);
+			PendingLogs.Empty();
+			DroppedLogs = 0;
+		}
+		break;
+
+	case EMCPEventTopic::Transaction:
+		if (UTransBuffer* TransBuffer = GEditor ? Cast<UTransBuffer>(GEditor->Trans) : nullptr)
+		{
+			TransBuffer->OnTransactionStateChanged().Remove(TransactionStateHandle);
+		}
+		TransactionStateHandle.Reset();
+		break;
+
+	case EMCPEventTopic::Selection:
+		USelection::SelectionChangedEvent.Remove(SelectionChangedHandle);
+		USelection::SelectObjectEvent.Remove(SelectObjectHandle);
+		bSelectionDirty = false;
+		break;
+
+	case EMCPEventTopic::AssetSaved:
+#if ENGINE_MAJOR_VERSION >= 5
+		UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+#else
+		UPackage::PackageSavedEvent.Remove(PackageSavedHandle);
+#endif
+		break;
+
+	case EMCPEventTopic::PIE:
+		FEditorDelegates::BeginPIE.Remove(BeginPIEHandle);
+		FEditorDelegates::EndPIE.Remove(EndPIEHandle);
+		FEditorDelegates::PausePIE.Remove(PausePIEHandle);
+		FEditorDelegates::ResumePIE.Remove(ResumePIEHandle);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void FMCPEventHub::AddPendingEvent(FSubscription& Subscription, EMCPEventTopic Topic, const TSharedPtr<FJsonValue>& Event)
+{
+	TArray<TSharedPtr<FJsonValue>>& Pending = Subscription.PendingEvents[static_cast<int32>(Topic)];
+	if (Pending.Num() >= CVarMCPEndpointMaxPendingEvents.GetValueOnGameThread())
+	{
+		++Subscription.Dropped[static_cast<int32>(Topic)];
+		return;
+	}
+	Pending.Add(Event);
+}
+
+void FMCPEventHub::Publish(EMCPEventTopic Topic, const TSharedRef<FJsonObject>& Event, TFunctionRef<bool(const FSubscription&)> Filter)
+{
+	// 同一事件对象由各订阅共享，序列化在 I/O 线程进行
+	const TSharedPtr<FJsonValue> Value = MakeShared<FJsonValueObject>(Event);
+	for (FSubscription& Subscription : Subscriptions)
+	{
+		if (Subscription.HasTopic(Topic) && Filter(Subscription))
+		{
+			AddPendingEvent(Subscription, Topic, Value);
+		}
+	}
+}
+
+void FMCPEventHub::CaptureLog(const TCHAR* Text, ELogVerbosity::Type Verbosity, const FName& Category)
+{
+	const ELogVerbosity::Type Level = static_cast<ELogVerbosity::Type>(Verbosity & ELogVerbosity::VerbosityMask);
+	if (Level > CaptureVerbosity.load(std::memory_order_relaxed) || Level == ELogVerbosity::NoLogging)
+	{
+		return;
+	}
+
+	FScopeLock Lock(&LogMutex);
+	// 游戏线程长时间不 Flush（停滞）时按所有订阅共用的上限丢弃
+	if (PendingLogs.Num() >= CVarMCPEndpointMaxPendingEvents.GetValueOnAnyThread())
+	{
+		++DroppedLogs;
+		return;
+	}
+
+	FLogRecord& Record = PendingLogs.AddDefaulted_GetRef();
+	Record.Category = Category;
+	Record.Verbosity = Level;
+	Record.Message = Text;
+	Record.Time = MCPEventHub::GetUnixTimestamp();
+}
+
+void FMCPEventHub::DistributeLogs()
+{
+	TArray<FLogRecord> Records;
+	int32 Dropped = 0;
+	{
+		FScopeLock Lock(&LogMutex);
+		Records = MoveTemp(PendingLogs);
+		PendingLogs.Reset();
+		Dropped = DroppedLogs;
+		DroppedLogs = 0;
+	}
+
+	if (Dropped > 0)
+	{
+		for (FSubscription& Subscription : Subscriptions)
+		{
+			if (Subscription.HasTopic(EMCPEventTopic::Log))
+			{
+				Subscription.Dropped[static_cast<int32>(EMCPEventTopic::Log)] += Dropped;
+			}
+		}
+	}
+
+	for (FLogRecord& Record : Records)
+	{
+		TSharedRef<FJsonObject> Event = MakeShared<FJsonObject>();
+		Event->SetStringField(TEXT("category"), Record.Category.ToString());
+		Event->SetStringField(TEXT("verbosity"), ToString(Record.Verbosity));
+		Event->SetStringField(TEXT("message"), MoveTemp(Record.Message));
+		Event->SetNumberField(TEXT("time"), Record.Time);
+
+		Publish(EMCPEventTopic::Log, Event, [&Record](const FSubscription& Subscription)
+		{
+			return Record.Verbosity <= Subscription.MinVerbosity
+				&& (Subscription.Categories.Num() == 0 || Subscription.Categories.Contains(Record.Category));
+		});
+	}
+}
+
+TSharedRef<FJsonObject> FMCPEventHub::MakeSelectionSnapshot(int32 MaxItems) const
+{
+	TSharedRef<FJsonObject> Snapshot = MakeShared<FJsonObject>();
+	TArray<TSharedPtr<FJsonValue>> Actors;
+	int32 Count = 0;
+
+	if (GEditor)
+	{
+		for (FSelectionIterator It(*GEditor->GetSelectedActors()); It; ++It)
+		{
+			const AActor* Actor = Cast<AActor>(*It);
+			if (!Actor)
+			{
+				continue;
+			}
+
+			++Count;
+			if (Actors.Num() < MaxItems)
+			{
+				TSharedRef<FJsonObject> Item = MakeShared<FJsonObject>();
+				Item->SetStringField(TEXT("label"), Actor->GetActorLabel());
+				Item->SetStringField(TEXT("path"), Actor->GetPathName());
+				Item->SetStringField(TEXT("class"), Actor->GetClass()->GetName());
+				Actors.Add(MakeShared<FJsonValueObject>(Item));
+			}
+		}
+		Snapshot->SetNumberField(TEXT("components"), GEditor->GetSelectedComponentCount());
+	}
+
+	Snapshot->SetNumberField(TEXT("count"), Count);
+	Snapshot->SetArrayField(TEXT("actors"), Actors);
+	return Snapshot;
+}
+
+void FMCPEventHub::OnTransactionStateChanged(const FTransactionContext& Context, ETransactionStateEventType EventType)
+{
+	const TCHAR* Kind = nullptr;
+	if (EventType == ETransactionStateEventType::TransactionFinalized)
+	{
+		Kind = TEXT("committed");
+	}
+	else if (EventType == ETransactionStateEventType::UndoRedoFinalized)
+	{
+		Kind = TEXT("undo_redo");
+	}
+	else
+	{
+		return;
+	}
+
+	const FString PrimaryObject = Context.PrimaryObject ? Context.PrimaryObject->GetPathName() : FString();
+	TSharedRef<FJsonObject> Event = MakeShared<FJsonObject>();
+	Event->SetStringField(TEXT("kind"), Kind);
+	Event->SetStringField(TEXT("title"), Context.Title.ToString());
+	Event->SetStringField(TEXT("context"), Context.Context);
+	Event->SetStringField(TEXT("transaction_id"), Context.TransactionId.ToString());
+	Event->SetStringField(TEXT("primary_object"), PrimaryObject);
+
+	Publish(EMCPEventTopic::Transaction, Event, [&PrimaryObject](const FSubscription& Subscription)
+	{
+		return Subscription.PathPrefix.IsEmpty() || PrimaryObject.StartsWith(Subscription.PathPrefix);
+	});
+}
+
+void FMCPEventHub::OnSelectionChanged(UObject* Object)
+{
+	// 框选等操作每帧可能触发上百次，只记下变化，Flush 时生成一次快照
+	bSelectionDirty = true;
+}
+
+void FMCPEventHub::OnPackageSaved(const FString& PackageFileName, const FString& PackageName)
+{
+	TSharedRef<FJsonObject> Event = MakeShared<FJsonObject>();
+	Event->SetStringField(TEXT("package"), PackageName);
+	Event->SetStringField(TEXT("file"), PackageFileName);
+
+	Publish(EMCPEventTopic::AssetSaved, Event, [&PackageName](const FSubscription& Subscription)
+	{
+		if (!Subscription.PathPrefix.IsEmpty() && !PackageName.StartsWith(Subscription.PathPrefix))
+		{
+			return false;
+		}
+
+		// 同一帧内多次保存同一个包只报告一次
+		for (const TSharedPtr<FJsonValue>& Pending : Subscription.PendingEvents[static_cast<int32>(EMCPEventTopic::AssetSaved)])
+		{
+			if (Pending->AsObject()->GetStringField(TEXT("package")) == PackageName)
+			{
+				return false;
+			}
+		}
+		return true;
+	});
+}
+
+void FMCPEventHub::OnPIEStateChanged(const TCHAR* State, bool bIsSimulating)
+{
+	TSharedRef<FJsonObject> Event = MakeShared<FJsonObject>();
+	Event->SetStringField(TEXT("state"), State);
+	Event->SetBoolField(TEXT("simulating"), bIsSimulating);
+
+	Publish(EMCPEventTopic::PIE, Event, [](const FSubscription&)
+	{
+		return true;
+	});
+}
+
+void FMCPEventHub::Flush(TFunctionRef<bool(uint32 ConnectionId)> IsPaused, TFunctionRef<void(uint32 ConnectionId, const TSharedRef<FJsonObject>& Message)> Send)
+{
+	if (Subscriptions.Num() == 0)
+	{
+		return;
+	}
+
+	if (ListeningTopics & MCPEventHub::TopicBit(EMCPEventTopic::Log))
+	{
+		DistributeLogs();
+	}
+
+	if (bSelectionDirty)
+	{
+		bSelectionDirty = false;
+		for (FSubscription& Subscription : Subscriptions)
+		{
+			if (Subscription.HasTopic(EMCPEventTopic::Selection))
+			{
+				// 只有最新的选择有意义，未发出的旧快照直接替换
+				TArray<TSharedPtr<FJsonValue>>& Pending = Subscription.PendingEvents[static_cast<int32>(EMCPEventTopic::Selection)];
+				Pending.Reset();
+				Pending.Add(MakeShared<FJsonValueObject>(MakeSelectionSnapshot(Subscription.MaxItems)));
+			}
+		}
+	}
+
+	for (FSubscription& Subscription : Subscriptions)
+	{
+		if (IsPaused(Subscription.ConnectionId))
+		{
+			continue;
+		}
+
+		for (int32 Index = 0; Index < static_cast<int32>(EMCPEventTopic::Num); ++Index)
+		{
+			TArray<TSharedPtr<FJsonValue>>& Pending = Subscription.PendingEvents[Index];
+			if (Pending.Num() == 0 && Subscription.Dropped[Index] == 0)
+			{
+				continue;
+			}
+
+			TSharedRef<FJsonObject> Message = MakeShared<FJsonObject>();
+			Message->SetStringField(TEXT("type"), TEXT("event"));
+			Message->SetStringField(TEXT("subscription"), Subscription.Id);
+			Message->SetStringField(TEXT("topic"), MCPEventHub::TopicNames[Index]);
+			Message->SetNumberField(TEXT("frame"), static_cast<double>(GFrameCounter));
+			Message->SetArrayField(TEXT("events"), MoveTemp(Pending));
+			if (Subscription.Dropped[Index] > 0)
+			{
+				Message->SetNumberField(TEXT("dropped"), Subscription.Dropped[Index]);
+			}
+			Send(Subscription.ConnectionId, Message);
+
+			Pending.Reset();
+			Subscription.Dropped[Index] = 0;
+		}
+	}
+}
@@ -0,0 +1,729 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPHttpServer.h"
+
+#include "MCPServer.h"
+#include "MCPEndpoint.h"
+#include "MCPNativeHandlers.h"
+#include "MCPResultCache.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "HttpPath.h"
+#include "HttpServerModule.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "IHttpRouter.h"
+#include "IPAddress.h"
+#include "IPythonScriptPlugin.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Guid.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+static TAutoConsoleVariable<bool> CVarMCPHttpServerAllowRemoteClients(
+	TEXT("MCP.HttpServer.AllowRemoteClients"),
+	false,
+	TEXT("Accept MCP HTTP requests from non-loopback peers. The HTTP server runs arbitrary Python without authentication, ")
+	TEXT("so only enable this on a trusted network together with a non-loopback bind address."),
+	ECVF_Default);
+
+namespace MCPHttpServer
+{
+	/** 支持的 MCP 协议版本，从新到旧；客户端请求的版本不在列表中时应答第一个 */
+	static const TCHAR* const SupportedProtocolVersions[] =
+	{
+		TEXT("2025-06-18"),
+		TEXT("2025-03-26"),
+		TEXT("2024-11-05"),
+	};
+
+	/** JSON-RPC 错误码 */
+	constexpr int32 ParseError = -32700;
+	constexpr int32 InvalidRequest = -32600;
+	constexpr int32 MethodNotFound = -32601;
+	constexpr int32 InvalidParams = -32602;
+
+	const TCHAR* const SessionHeader = TEXT("Mcp-Session-Id");
+
+	/** 单独统计的 JSON-RPC 方法和工具调用，其余计入 "(unknown)" */
+	const TSet<FString> KnownMetricsTypes =
+	{
+		TEXT("initialize"), TEXT("ping"), TEXT("tools/list"), TEXT("tools/call"), TEXT("batch"),
+		TEXT("notifications/initialized"), TEXT("notifications/cancelled"),
+		TEXT("tools/call:execute_command"), TEXT("tools/call:excute_file"),
+		TEXT("tools/call:get_editor_state"), TEXT("tools/call:native_request"),
+	};
+
+	/** HTTPServer 模块不规范化头名的大小写，按 HTTP 语义忽略大小写查找 */
+	FString FindHeader(const FHttpServerRequest& Request, const TCHAR* Name)
+	{
+		for (const TPair<FString, TArray<FString>>& Header : Request.Headers)
+		{
+			if (Header.Key.Equals(Name, ESearchCase::IgnoreCase) && Header.Value.Num() > 0)
+			{
+				return Header.Value[0];
+			}
+		}
+		return FString();
+	}
+
+	bool IsLoopbackAddress(const FString& Address)
+	{
+		return Address.StartsWith(TEXT("127.")) || Address.StartsWith(TEXT("::ffff:127.")) || Address == TEXT("::1") || Address == TEXT("localhost");
+	}
+
+	/**
+	 * 让 HTTPServer 模块在 Port 上的监听器绑定到 BindAddress（[HTTPServer.Listeners] ListenerOverrides），
+	 * 不受 DefaultBindAddress 影响；监听器启动时读取，已由其他模块启动的同端口监听器不受影响
+	 */
+	void SetListenerBindAddress(int32 Port, const FString& BindAddress)
+	{
+		const TCHAR* Section = TEXT("HTTPServer.Listeners");
+		TArray<FString> Overrides;
+		GConfig->GetArray(Section, TEXT("ListenerOverrides"), Overrides, GEngineIni);
+		Overrides.RemoveAll([Port](const FString& Override)
+		{
+			int32 OverridePort = 0;
+			return FParse::Value(*Override, TEXT("Port="), OverridePort) && OverridePort == Port;
+		});
+		Overrides.Add(FString::Printf(TEXT("(Port=%d,BindAddress=%s)"), Port, *BindAddress));
+		GConfig->SetArray(Section, TEXT("ListenerOverrides"), Overrides, GEngineIni);
+	}
+
+	/** 只接受本机页面发起的请求，其他 Origin 可能是 DNS 重绑定攻击 */
+	bool IsAllowedOrigin(const FString& Origin)
+	{
+		if (Origin.IsEmpty() || Origin == TEXT("null"))
+		{
+			return true;
+		}
+
+		FString Host = Origin;
+		Host.RemoveFromStart(TEXT("http://"));
+		Host.RemoveFromStart(TEXT("https://"));
+		int32 PortIndex = INDEX_NONE;
+		if (Host.StartsWith(TEXT("[")))
+		{
+			Host.FindChar(TEXT(']'), PortIndex);
+			Host = PortIndex != INDEX_NONE ? Host.Mid(1, PortIndex - 1) : Host;
+		}
+		else if (Host.FindChar(TEXT(':'), PortIndex))
+		{
+			Host.LeftInline(PortIndex);
+		}
+		return Host == TEXT("localhost") || Host == TEXT("127.0.0.1") || Host == TEXT("::1");
+	}
+
+	FString SerializeJson(const TSharedRef<FJsonObject>& Object)
+	{
+		FString Output;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Output);
+		FJsonSerializer::Serialize(Object, Writer);
+		return Output;
+	}
+
+	FString SerializeJson(const TArray<TSharedPtr<FJsonValue>>& Array)
+	{
+		FString Output;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Output);
+		FJsonSerializer::Serialize(Array, Writer);
+		return Output;
+	}
+
+	TSharedRef<FJsonObject> MakeStringProperty(const FString& Description)
+	{
+		TSharedRef<FJsonObject> Property = MakeShared<FJsonObject>();
+		Property->SetStringField(TEXT("type"), TEXT("string"));
+		Property->SetStringField(TEXT("description"), Description);
+		return Property;
+	}
+
+	TSharedRef<FJsonObject> MakeTool(const FString& Name, const FString& Description, const TSharedRef<FJsonObject>& Properties, const TArray<FString>& Required)
+	{
+		TSharedRef<FJsonObject> Schema = MakeShared<FJsonObject>();
+		Schema->SetStringField(TEXT("type"), TEXT("object"));
+		Schema->SetObjectField(TEXT("properties"), Properties);
+		if (Required.Num() > 0)
+		{
+			TArray<TSharedPtr<FJsonValue>> RequiredValues;
+			for (const FString& Field : Required)
+			{
+				RequiredValues.Add(MakeShared<FJsonValueString>(Field));
+			}
+			Schema->SetArrayField(TEXT("required"), RequiredValues);
+		}
+
+		TSharedRef<FJsonObject> Tool = MakeShared<FJsonObject>();
+		Tool->SetStringField(TEXT("name"), Name);
+		Tool->SetStringField(TEXT("description"), Description);
+		Tool->SetObjectField(TEXT("inputSchema"), Schema);
+		return Tool;
+	}
+
+	TUniquePtr<FHttpServerResponse> MakeJsonResponse(const FString& Json, const FString& SessionId)
+	{
+		TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(Json, TEXT("application/json"));
+		if (!SessionId.IsEmpty())
+		{
+			Response->Headers.Add(SessionHeader, { SessionId });
+		}
+		return Response;
+	}
+
+	TUniquePtr<FHttpServerResponse> MakeStatusResponse(EHttpServerResponseCodes Code)
+	{
+		TUniquePtr<FHttpServerResponse> Response = MakeUnique<FHttpServerResponse>();
+		Response->Code = Code;
+		return Response;
+	}
+}
+
+FMCPHttpServer::FMCPHttpServer()
+{
+	Metrics.SetKnownTypeFilter([](const FString& Type)
+	{
+		return MCPHttpServer::KnownMetricsTypes.Contains(Type);
+	});
+}
+
+FMCPHttpServer::~FMCPHttpServer()
+{
+	Stop();
+}
+
+bool FMCPHttpServer::Start(int32 Port, const FString& Path, const FString& BindAddress)
+{
+	if (IsRunning())
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("MCP HTTP server already running on port %d"), ListenPort);
+		return ListenPort == Port && RoutePath == Path;
+	}
+
+	if (!MCPHttpServer::IsLoopbackAddress(BindAddress) && !CVarMCPHttpServerAllowRemoteClients.GetValueOnGameThread())
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("MCP HTTP server: binding to %s, but requests from other machines are rejected until MCP.HttpServer.AllowRemoteClients is set"), *BindAddress);
+	}
+	MCPHttpServer::SetListenerBindAddress(Port, BindAddress);
+
+	FHttpServerModule& HttpServerModule = FHttpServerModule::Get();
+	Router = HttpServerModule.GetHttpRouter(Port);
+	if (!Router.IsValid())
+	{
+		UE_LOG(LogMCPServer, Error, TEXT("MCP HTTP server: failed to get an HTTP router for port %d"), Port);
+		return false;
+	}
+
+	const EHttpServerRequestVerbs Verbs = EHttpServerRequestVerbs::VERB_POST | EHttpServerRequestVerbs::VERB_GET | EHttpServerRequestVerbs::VERB_DELETE;
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 4)
+	RouteHandle = Router->BindRoute(FHttpPath(Path), Verbs, FHttpRequestHandler::CreateRaw(this, &FMCPHttpServer::HandleHttpRequest));
+#else
+	RouteHandle = Router->BindRoute(FHttpPath(Path), Verbs, [this](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		return HandleHttpRequest(Request, OnComplete);
+	});
+#endif
+	if (!RouteHandle.IsValid())
+	{
+		UE_LOG(LogMCPServer, Error, TEXT("MCP HTTP server: route %s is already bound on port %d"), *Path, Port);
+		Router.Reset();
+		return false;
+	}
+
+	HttpServerModule.StartAllListeners();
+	ListenPort = Port;
+	RoutePath = Path;
+	UE_LOG(LogMCPServer, Log, TEXT("MCP HTTP server listening on %s:%d at %s"), *BindAddress, Port, *Path);
+	return true;
+}
+
+void FMCPHttpServer::Stop()
+{
+	if (!IsRunning())
+	{
+		return;
+	}
+
+	// 监听器可能被其他模块共用，只解绑自己的路由
+	if (Router.IsValid())
+	{
+		Router->UnbindRoute(RouteHandle);
+	}
+	RouteHandle.Reset();
+	Router.Reset();
+	Sessions.Empty();
+	UE_LOG(LogMCPServer, Log, TEXT("MCP HTTP server stopped"));
+}
+
+bool FMCPHttpServer::HandleHttpRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MCPHttpServer_Request);
+
+	// 监听器可能在本端点之前已由其他模块按 DefaultBindAddress 启动，按对端地址再检查一次；
+	// Origin 检查只能拦住浏览器，拦不住同一网络上的其他客户端
+	const FString PeerAddress = Request.PeerAddress.IsValid() ? Request.PeerAddress->ToString(false) : FString();
+	if (!MCPHttpServer::IsLoopbackAddress(PeerAddress) && !CVarMCPHttpServerAllowRemoteClients.GetValueOnGameThread())
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("MCP HTTP server: rejected request from non-loopback peer %s"), PeerAddress.IsEmpty() ? TEXT("(unknown)") : *PeerAddress);
+		OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::Forbidden, TEXT("forbidden"), TEXT("Remote clients are not allowed")));
+		return true;
+	}
+
+	if (!MCPHttpServer::IsAllowedOrigin(MCPHttpServer::FindHeader(Request, TEXT("Origin"))))
+	{
+		OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::Forbidden, TEXT("forbidden"), TEXT("Origin not allowed")));
+		return true;
+	}
+
+	FString SessionId = MCPHttpServer::FindHeader(Request, MCPHttpServer::SessionHeader);
+	const bool bKnownSession = SessionId.IsEmpty() || Sessions.Contains(SessionId);
+
+	if (Request.Verb == EHttpServerRequestVerbs::VERB_GET)
+	{
+		// 不提供服务端主动推送的 SSE 流
+		OnComplete(MCPHttpServer::MakeStatusResponse(EHttpServerResponseCodes::BadMethod));
+		return true;
+	}
+
+	if (Request.Verb == EHttpServerRequestVerbs::VERB_DELETE)
+	{
+		Sessions.Remove(SessionId);
+		OnComplete(MCPHttpServer::MakeStatusResponse(bKnownSession ? EHttpServerResponseCodes::Ok : EHttpServerResponseCodes::NotFound));
+		return true;
+	}
+
+	const double DecodeStartTime = FPlatformTime::Seconds();
+	FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Request.Body.GetData()), Request.Body.Num());
+	const FString Body(Converter.Length(), Converter.Get());
+
+	TSharedPtr<FJsonValue> Root;
+	TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(Body);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || (Root->Type != EJson::Object && Root->Type != EJson::Array))
+	{
+		const FString Error = MCPHttpServer::SerializeJson(MakeErrorResponse(MakeShared<FJsonValueNull>(), MCPHttpServer::ParseError, TEXT("Parse error")));
+		TUniquePtr<FHttpServerResponse> Response = MCPHttpServer::MakeJsonResponse(Error, FString());
+		Response->Code = EHttpServerResponseCodes::BadRequest;
+		OnComplete(MoveTemp(Response));
+		return true;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Messages;
+	const bool bBatch = Root->Type == EJson::Array;
+	if (bBatch)
+	{
+		Messages = Root->AsArray();
+	}
+	else
+	{
+		Messages.Add(Root);
+	}
+
+	FString MetricsType = TEXT("batch");
+	if (!bBatch)
+	{
+		Root->AsObject()->TryGetStringField(TEXT("method"), MetricsType);
+	}
+	Metrics.RecordReceived(MetricsType, Request.Body.Num(), FPlatformTime::Seconds() - DecodeStartTime);
+
+	// 未知会话（过期或服务重启前的会话）返回 404，客户端应重新 initialize
+	if (!bKnownSession && MetricsType != TEXT("initialize"))
+	{
+		OnComplete(MCPHttpServer::MakeStatusResponse(EHttpServerResponseCodes::NotFound));
+		return true;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Responses;
+	for (const TSharedPtr<FJsonValue>& Message : Messages)
+	{
+		TSharedPtr<FJsonObject> Response;
+		if (!Message.IsValid() || Message->Type != EJson::Object)
+		{
+			Response = MakeErrorResponse(MakeShared<FJsonValueNull>(), MCPHttpServer::InvalidRequest, TEXT("Invalid request"));
+		}
+		else
+		{
+			Response = HandleMessage(*Message->AsObject(), SessionId);
+		}
+
+		if (Response.IsValid())
+		{
+			Responses.Add(MakeShared<FJsonValueObject>(Response));
+		}
+	}
+
+	if (Responses.Num() == 0)
+	{
+		// 只有通知或客户端应答
+		OnComplete(MCPHttpServer::MakeStatusResponse(EHttpServerResponseCodes::Accepted));
+		return true;
+	}
+
+	const double EncodeStartTime = FPlatformTime::Seconds();
+	const FString ResponseJson = bBatch
+		? MCPHttpServer::SerializeJson(Responses)
+		: MCPHttpServer::SerializeJson(Responses[0]->AsObject().ToSharedRef());
+	TUniquePtr<FHttpServerResponse> Response = MCPHttpServer::MakeJsonResponse(ResponseJson, SessionId);
+	Metrics.RecordSent(MetricsType, Response->Body.Num(), FPlatformTime::Seconds() - EncodeStartTime);
+	OnComplete(MoveTemp(Response));
+	return true;
+}
+
+TSharedPtr<FJsonObject> FMCPHttpServer::HandleMessage(const FJsonObject& Message, FString& InOutSessionId)
+{
+	FString Method;
+	if (!Message.TryGetStringField(TEXT("method"), Method))
+	{
+		// 客户端对服务端请求的应答，本端点不发起请求，忽略
+		return nullptr;
+	}
+
+	const TSharedPtr<FJsonValue> Id = Message.TryGetField(TEXT("id"));
+	const bool bNotification = !Id.IsValid();
+
+	const TSharedPtr<FJsonObject>* ParamsPtr = nullptr;
+	Message.TryGetObjectField(TEXT("params"), ParamsPtr);
+	const FJsonObject EmptyParams;
+	const FJsonObject& Params = ParamsPtr && ParamsPtr->IsValid() ? **ParamsPtr : EmptyParams;
+
+	if (bNotification)
+	{
+		// notifications/initialized、notifications/cancelled 等无需应答（工具调用同步执行，无法取消）
+		return nullptr;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*Metrics.GetTypeKey(Method));
+	const double StartTime = FPlatformTime::Seconds();
+	FString MetricsType = Method;
+	TSharedPtr<FJsonObject> Response;
+
+	if (Method == TEXT("initialize"))
+	{
+		Response = MakeResponse(Id, HandleInitialize(Params, InOutSessionId));
+	}
+	else if (Method == TEXT("ping"))
+	{
+		Response = MakeResponse(Id, MakeShared<FJsonObject>());
+	}
+	else if (Method == TEXT("tools/list"))
+	{
+		Response = MakeResponse(Id, HandleToolsList());
+	}
+	else if (Method == TEXT("tools/call"))
+	{
+		FString ToolName;
+		Params.TryGetStringField(TEXT("name"), ToolName);
+		MetricsType = FString::Printf(TEXT("tools/call:%s"), *ToolName);
+
+		FString Error;
+		TSharedPtr<FJsonObject> Result = HandleToolsCall(Params, Error);
+		Response = Result.IsValid() ? MakeResponse(Id, Result.ToSharedRef()) : MakeErrorResponse(Id, MCPHttpServer::InvalidParams, Error);
+	}
+	else
+	{
+		Response = MakeErrorResponse(Id, MCPHttpServer::MethodNotFound, FString::Printf(TEXT("Method not found: %s"), *Method));
+	}
+
+	Metrics.RecordExecuted(MetricsType, 0.0, FPlatformTime::Seconds() - StartTime);
+	return Response;
+}
+
+TSharedRef<FJsonObject> FMCPHttpServer::HandleInitialize(const FJsonObject& Params, FString& OutSessionId)
+{
+	FString RequestedVersion;
+	Params.TryGetStringField(TEXT("protocolVersion"), RequestedVersion);
+	FString ProtocolVersion = MCPHttpServer::SupportedProtocolVersions[0];
+	for (const TCHAR* Version : MCPHttpServer::SupportedProtocolVersions)
+	{
+		if (RequestedVersion == Version)
+		{
+			ProtocolVersion = Version;
+		}
+	}
+
+	OutSessionId = FGuid::NewGuid().ToString(EGuidFormats::DigitsWithHyphens);
+	Sessions.Add(OutSessionId);
+	if (Sessions.Num() > MaxSessions)
+	{
+		Sessions.RemoveAt(0, Sessions.Num() - MaxSessions);
+	}
+
+	TSharedRef<FJsonObject> Tools = MakeShared<FJsonObject>();
+	Tools->SetBoolField(TEXT("listChanged"), false);
+	TSharedRef<FJsonObject> Capabilities = MakeShared<FJsonObject>();
+	Capabilities->SetObjectField(TEXT("tools"), Tools);
+
+	TSharedRef<FJsonObject> ServerInfo = MakeShared<FJsonObject>();
+	ServerInfo->SetStringField(TEXT("name"), TEXT("UE-MCP-Native"));
+	ServerInfo->SetStringField(TEXT("version"), TEXT("1.0"));
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetStringField(TEXT("protocolVersion"), ProtocolVersion);
+	Result->SetObjectField(TEXT("capabilities"), Capabilities);
+	Result->SetObjectField(TEXT("serverInfo"), ServerInfo);
+	return Result;
+}
+
+TSharedRef<FJsonObject> FMCPHttpServer::HandleToolsList() const
+{
+	TArray<TSharedPtr<FJsonValue>> Tools;
+
+	// 与 mcp_server.MCPCore 中的工具定义保持一致
+	{
+		TSharedRef<FJsonObject> Properties = MakeShared<FJsonObject>();
+		Properties->SetObjectField(TEXT("code"), MCPHttpServer::MakeStringProperty(TEXT("Python code to execute in the editor")));
+		Properties->SetObjectField(TEXT("session"), MCPHttpServer::MakeStringProperty(
+			TEXT("Optional session name. Code run with the same session shares its globals, so helper functions and variables defined once can be reused by later calls without resending them.")));
+		Tools.Add(MakeShared<FJsonValueObject>(MCPHttpServer::MakeTool(TEXT("execute_command"),
+			TEXT("Execute Python code in Unreal Engine editor. The code runs in the editor's main thread."), Properties, { TEXT("code") })));
+	}
+	{
+		TSharedRef<FJsonObject> Properties = MakeShared<FJsonObject>();
+		Properties->SetObjectField(TEXT("file"), MCPHttpServer::MakeStringProperty(TEXT("Absolute path to the Python script file")));
+		Tools.Add(MakeShared<FJsonValueObject>(MCPHttpServer::MakeTool(TEXT("excute_file"),
+			TEXT("Execute a Python script file in Unreal Engine editor."), Properties, { TEXT("file") })));
+	}
+	Tools.Add(MakeShared<FJsonValueObject>(MCPHttpServer::MakeTool(TEXT("get_editor_state"),
+		TEXT("Get the current connection state with Unreal Editor."), MakeShared<FJsonObject>(), {})));
+	{
+		// 参数说明由注册表生成，与处理器执行前的参数校验使用同一份声明
+		const FMCPNativeHandlerRegistry& Registry = FMCPNativeHandlerRegistry::Get();
+		TArray<FString> HandlerTypes = Registry.GetHandlerTypes();
+		HandlerTypes.Sort();
+		TArray<TSharedPtr<FJsonValue>> Types;
+		TArray<FString> Signatures;
+		for (const FString& Type : HandlerTypes)
+		{
+			Types.Add(MakeShared<FJsonValueString>(Type));
+			Signatures.Add(Registry.DescribeParams(Type));
+		}
+		TSharedRef<FJsonObject> TypeProperty = MCPHttpServer::MakeStringProperty(TEXT("Native request type"));
+		TypeProperty->SetArrayField(TEXT("enum"), Types);
+
+		TSharedRef<FJsonObject> ParamsProperty = MakeShared<FJsonObject>();
+		ParamsProperty->SetStringField(TEXT("type"), TEXT("object"));
+		ParamsProperty->SetStringField(TEXT("description"), FString::Printf(
+			TEXT("Request parameters by type (optional ones end with '?'): %s. ")
+			TEXT("e.g. {\"path\": \"/Game/BP.BP_C:Default__BP_C\", \"property\": \"Health\"} for get_property."),
+			*FString::Join(Signatures, TEXT("; "))));
+
+		TSharedRef<FJsonObject> Properties = MakeShared<FJsonObject>();
+		Properties->SetObjectField(TEXT("type"), TypeProperty);
+		Properties->SetObjectField(TEXT("params"), ParamsProperty);
+		Tools.Add(MakeShared<FJsonValueObject>(MCPHttpServer::MakeTool(TEXT("native_request"),
+			TEXT("Run a built-in C++ editor query (log tail, asset search, object dump, property read/write, gameplay tag check) without executing Python."),
+			Properties, { TEXT("type") })));
+	}
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetArrayField(TEXT("tools"), Tools);
+	return Result;
+}
+
+TSharedPtr<FJsonObject> FMCPHttpServer::HandleToolsCall(const FJsonObject& Params, FString& OutError)
+{
+	FString Name;
+	Params.TryGetStringField(TEXT("name"), Name);
+	const TSharedPtr<FJsonObject>* ArgumentsPtr = nullptr;
+	Params.TryGetObjectField(TEXT("arguments"), ArgumentsPtr);
+	const TSharedRef<FJsonObject> Arguments = ArgumentsPtr && ArgumentsPtr->IsValid() ? ArgumentsPtr->ToSharedRef() : MakeShared<FJsonObject>();
+
+	const FString RequestId = FString::Printf(TEXT("http_%d"), NextRequestId++);
+
+	if (Name == TEXT("execute_command") || Name == TEXT("excute_file"))
+	{
+		const bool bFile = Name == TEXT("excute_file");
+		const TCHAR* ArgumentName = bFile ? TEXT("file") : TEXT("code");
+		FString Source;
+		if (!Arguments->TryGetStringField(ArgumentName, Source))
+		{
+			return MakeToolResult(FString::Printf(TEXT("Error: missing '%s' argument"), ArgumentName), true);
+		}
+
+		TSharedRef<FJsonObject> Request = MakeShared<FJsonObject>();
+		Request->SetStringField(TEXT("type"), bFile ? TEXT("execute_file") : TEXT("execute"));
+		Request->SetStringField(TEXT("id"), RequestId);
+		Request->SetStringField(ArgumentName, Source);
+		FString Session;
+		if (Arguments->TryGetStringField(TEXT("session"), Session))
+		{
+			Request->SetStringField(TEXT("session"), Session);
+		}
+
+		FString Error;
+		TSharedPtr<FJsonObject> Response = RunPython(Request, Error);
+		if (!Response.IsValid())
+		{
+			return MakeToolResult(FString::Printf(TEXT("Error: %s"), *Error), true);
+		}
+
+		// 与 mcp_server.MCPCore.ExecutionResult.to_text 的格式一致
+		bool bSuccess = false;
+		Response->TryGetBoolField(TEXT("success"), bSuccess);
+		FString Text;
+		if (bSuccess)
+		{
+			if (!Response->TryGetStringField(TEXT("output"), Text) || Text.IsEmpty())
+			{
+				Text = TEXT("Execution completed successfully.");
+			}
+		}
+		else
+		{
+			FString ResponseError;
+			Text = Response->TryGetStringField(TEXT("error"), ResponseError) && !ResponseError.IsEmpty()
+				? FString::Printf(TEXT("Error: %s"), *ResponseError)
+				: FString(TEXT("Execution failed."));
+		}
+		FString Logs;
+		if (Response->TryGetStringField(TEXT("logs"), Logs) && !Logs.IsEmpty())
+		{
+			Text += TEXT("\n\nCaptured Logs:\n") + Logs;
+		}
+		return MakeToolResult(Text, !bSuccess);
+	}
+
+	if (Name == TEXT("get_editor_state"))
+	{
+		return MakeToolResult(DescribeEditorState(), false);
+	}
+
+	if (Name == TEXT("native_request"))
+	{
+		FString Type;
+		if (!Arguments->TryGetStringField(TEXT("type"), Type) || !FMCPNativeHandlerRegistry::Get().HasHandler(Type))
+		{
+			return MakeToolResult(FString::Printf(TEXT("Error: unknown native request type '%s'"), *Type), true);
+		}
+
+		TSharedRef<FJsonObject> Request = MakeShared<FJsonObject>();
+		const TSharedPtr<FJsonObject>* RequestParams = nullptr;
+		if (Arguments->TryGetObjectField(TEXT("params"), RequestParams) && RequestParams->IsValid())
+		{
+			Request->Values = (*RequestParams)->Values;
+		}
+		Request->SetStringField(TEXT("type"), Type);
+		Request->SetStringField(TEXT("id"), RequestId);
+
+		TSharedPtr<FJsonObject> Result = FMCPNativeHandlerRegistry::Get().HandleRequest(*Request);
+		if (!Result.IsValid())
+		{
+			return MakeToolResult(FString::Printf(TEXT("Error: no native handler for '%s'"), *Type), true);
+		}
+
+		bool bSuccess = false;
+		Result->TryGetBoolField(TEXT("success"), bSuccess);
+		if (!bSuccess)
+		{
+			FString ResultError;
+			Result->TryGetStringField(TEXT("error"), ResultError);
+			return MakeToolResult(FString::Printf(TEXT("Error: %s"), *ResultError), true);
+		}
+
+		// 只有 output 时直接返回文本，否则返回处理器写入的全部字段
+		FString Output;
+		Result->RemoveField(TEXT("type"));
+		Result->RemoveField(TEXT("id"));
+		Result->RemoveField(TEXT("success"));
+		if (Result->Values.Num() == 1 && Result->TryGetStringField(TEXT("output"), Output))
+		{
+			return MakeToolResult(Output, false);
+		}
+		return MakeToolResult(MCPHttpServer::SerializeJson(Result.ToSharedRef()), false);
+	}
+
+	OutError = FString::Printf(TEXT("Unknown tool: %s"), *Name);
+	return nullptr;
+}
+
+TSharedPtr<FJsonObject> FMCPHttpServer::RunPython(const TSharedRef<FJsonObject>& Request, FString& OutError)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MCPHttpServer_Python);
+
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+	{
+		OutError = TEXT("Python is not available in this editor");
+		return nullptr;
+	}
+	if (!PendingPythonRequest.IsEmpty())
+	{
+		// 工具执行的 Python 代码又发起了 HTTP 请求
+		OutError = TEXT("Another Python tool call is already running");
+		return nullptr;
+	}
+
+	PendingPythonRequest = MCPHttpServer::SerializeJson(Request);
+	PendingPythonResponse.Reset();
+
+	// 与原生端点共用桥接脚本，UMCPEndpointLibrary 优先返回本端点挂起的请求
+	PythonPlugin->ExecPythonCommand(TEXT("import mcp_server.MCPEndpointBridge; mcp_server.MCPEndpointBridge.handle_pending()"));
+
+	// 任意 Python 代码都可能修改编辑器状态而不触发失效事件
+	FMCPResultCache::Get().Invalidate();
+
+	PendingPythonRequest.Reset();
+	const FString ResponseJson = MoveTemp(PendingPythonResponse);
+	PendingPythonResponse.Reset();
+
+	TSharedPtr<FJsonObject> Response;
+	TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(ResponseJson);
+	if (ResponseJson.IsEmpty() || !FJsonSerializer::Deserialize(Reader, Response) || !Response.IsValid())
+	{
+		OutError = TEXT("Python handler returned no response");
+		return nullptr;
+	}
+	return Response;
+}
+
+FString FMCPHttpServer::DescribeEditorState() const
+{
+	// 请求在游戏线程上处理，能应答就说明编辑器空闲
+	FString State = FString::Printf(TEXT("Editor connection state: connected (native MCP HTTP endpoint on port %d)\nFrame: %llu"),
+		ListenPort, static_cast<uint64>(GFrameCounter));
+
+	FMCPServerModule* Module = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer");
+	TSharedPtr<FMCPEndpoint> Endpoint = Module ? Module->GetEndpoint() : nullptr;
+	if (Endpoint.IsValid() && Endpoint->IsRunning())
+	{
+		State += FString::Printf(TEXT("\nNative endpoint: port %d, %d connection(s)"), Endpoint->GetPort(), Endpoint->GetConnectionCount());
+	}
+	return State;
+}
+
+TSharedRef<FJsonObject> FMCPHttpServer::MakeResponse(const TSharedPtr<FJsonValue>& Id, const TSharedRef<FJsonObject>& Result)
+{
+	TSharedRef<FJsonObject> Response = MakeShared<FJsonObject>();
+	Response->SetStringField(TEXT("jsonrpc"), TEXT("2.0"));
+	Response->SetField(TEXT("id"), Id);
+	Response->SetObjectField(TEXT("result"), Result);
+	return Response;
+}
+
+TSharedRef<FJsonObject> FMCPHttpServer::MakeErrorResponse(const TSharedPtr<FJsonValue>& Id, int32 Code, const FString& Message)
+{
+	TSharedRef<FJsonObject> Error = MakeShared<FJsonObject>();
+	Error->SetNumberField(TEXT("code"), Code);
+	Error->SetStringField(TEXT("message"), Message);
+
+	TSharedRef<FJsonObject> Response = MakeShared<FJsonObject>();
+	Response->SetStringField(TEXT("jsonrpc"), TEXT("2.0"));
+	Response->SetField(TEXT("id"), Id);
+	Response->SetObjectField(TEXT("error"), Error);
+	return Response;
+}
+
+TSharedRef<FJsonObject> FMCPHttpServer::MakeToolResult(const FString& Text, bool bIsError)
+{
+	TSharedRef<FJsonObject> Content = MakeShared<FJsonObject>();
+	Content->SetStringField(TEXT("type"), TEXT("text"));
+	Content->SetStringField(TEXT("text"), Text);
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetArrayField(TEXT("content"), { MakeShared<FJsonValueObject>(Content) });
+	Result->SetBoolField(TEXT("isError"), bIsError);
+	return Result;
+}
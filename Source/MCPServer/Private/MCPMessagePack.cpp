@@ -0,0 +1,422 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPMessagePack.h"
+
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+namespace MCPMessagePack
+{
+	class FWriter
+	{
+	public:
+		explicit FWriter(TArray<uint8>& InBytes)
+			: Bytes(InBytes)
+		{
+		}
+
+		void WriteValue(const TSharedPtr<FJsonValue>& Value)
+		{
+			if (!Value.IsValid())
+			{
+				Bytes.Add(0xc0);
+				return;
+			}
+
+			switch (Value->Type)
+			{
+			case EJson::String:
+				WriteString(Value->AsString());
+				break;
+			case EJson::Number:
+				WriteNumber(Value->AsNumber());
+				break;
+			case EJson::Boolean:
+				Bytes.Add(Value->AsBool() ? 0xc3 : 0xc2);
+				break;
+			case EJson::Array:
+			{
+				const TArray<TSharedPtr<FJsonValue>>& Items = Value->AsArray();
+				WriteHeader(Items.Num(), 0x90, 0xdc, 0xdd, 16);
+				for (const TSharedPtr<FJsonValue>& Item : Items)
+				{
+					WriteValue(Item);
+				}
+				break;
+			}
+			case EJson::Object:
+				WriteObject(*Value->AsObject());
+				break;
+			default:
+				Bytes.Add(0xc0);
+				break;
+			}
+		}
+
+		void WriteObject(const FJsonObject& Object)
+		{
+			WriteHeader(Object.Values.Num(), 0x80, 0xde, 0xdf, 16);
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Object.Values)
+			{
+				WriteString(Pair.Key);
+				WriteValue(Pair.Value);
+			}
+		}
+
+	private:
+		void WriteString(const FString& Text)
+		{
+			FTCHARToUTF8 Utf8(*Text);
+			const int32 Length = Utf8.Length();
+			if (Length < 32)
+			{
+				Bytes.Add(uint8(0xa0 | Length));
+			}
+			else if (Length <= 0xff)
+			{
+				Bytes.Add(0xd9);
+				Bytes.Add(uint8(Length));
+			}
+			else
+			{
+				WriteHeader(Length, 0, 0xda, 0xdb, 0);
+			}
+			Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Length);
+		}
+
+		void WriteNumber(double Value)
+		{
+			const bool bIntegral = FMath::IsFinite(Value) && Value == FMath::FloorToDouble(Value) && FMath::Abs(Value) < 9007199254740992.0;
+			if (!bIntegral)
+			{
+				uint64 Bits;
+				FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+				Bytes.Add(0xcb);
+				WriteBigEndian(Bits, 8);
+				return;
+			}
+
+			const int64 IntValue = int64(Value);
+			if (IntValue >= 0 && IntValue <= 0x7f)
+			{
+				Bytes.Add(uint8(IntValue));
+			}
+			else if (IntValue < 0 && IntValue >= -32)
+			{
+				Bytes.Add(uint8(int8(IntValue)));
+			}
+			else if (IntValue >= MIN_int32 && IntValue <= MAX_int32)
+			{
+				Bytes.Add(0xd2);
+				WriteBigEndian(uint64(uint32(int32(IntValue))), 4);
+			}
+			else
+			{
+				Bytes.Add(0xd3);
+				WriteBigEndian(uint64(IntValue), 8);
+			}
+		}
+
+		/** fix 格式的长度上限为 FixLimit，0 表示没有 fix 格式（长字符串） */
+		void WriteHeader(int32 Count, uint8 FixTag, uint8 Tag16, uint8 Tag32, int32 FixLimit)
+		{
+			if (Count < FixLimit)
+			{
+				Bytes.Add(uint8(FixTag | Count));
+			}
+			else if (Count <= 0xffff)
+			{
+				Bytes.Add(Tag16);
+				WriteBigEndian(uint64(Count), 2);
+			}
+			else
+			{
+				Bytes.Add(Tag32);
+				WriteBigEndian(uint64(Count), 4);
+			}
+		}
+
+		void WriteBigEndian(uint64 Value, int32 NumBytes)
+		{
+			for (int32 Shift = (NumBytes - 1) * 8; Shift >= 0; Shift -= 8)
+			{
+				Bytes.Add(uint8(Value >> Shift));
+			}
+		}
+
+		TArray<uint8>& Bytes;
+	};
+
+	class FReader
+	{
+	public:
+		FReader(const uint8* InData, int32 InSize)
+			: Data(InData)
+			, Size(InSize)
+		{
+		}
+
+		TSharedPtr<FJsonValue> ReadValue(int32 Depth)
+		{
+			if (Depth > FMCPMessagePack::MaxDepth)
+			{
+				return Fail(TEXT("nesting too deep"));
+			}
+
+			uint8 Tag = 0;
+			if (!ReadByte(Tag))
+			{
+				return nullptr;
+			}
+
+			if (Tag <= 0x7f)
+			{
+				return MakeShared<FJsonValueNumber>(Tag);
+			}
+			if (Tag >= 0xe0)
+			{
+				return MakeShared<FJsonValueNumber>(int8(Tag));
+			}
+			if ((Tag & 0xf0) == 0x80)
+			{
+				return ReadMap(Tag & 0x0f, Depth);
+			}
+			if ((Tag & 0xf0) == 0x90)
+			{
+				return ReadArray(Tag & 0x0f, Depth);
+			}
+			if ((Tag & 0xe0) == 0xa0)
+			{
+				return ReadString(Tag & 0x1f);
+			}
+
+			uint64 Value = 0;
+			switch (Tag)
+			{
+			case 0xc0: return MakeShared<FJsonValueNull>();
+			case 0xc2: return MakeShared<FJsonValueBoolean>(false);
+			case 0xc3: return MakeShared<FJsonValueBoolean>(true);
+			case 0xc4: case 0xd9: return ReadBigEndian(1, Value) ? ReadString(Value) : nullptr;
+			case 0xc5: case 0xda: return ReadBigEndian(2, Value) ? ReadString(Value) : nullptr;
+			case 0xc6: case 0xdb: return ReadBigEndian(4, Value) ? ReadString(Value) : nullptr;
+			case 0xc7: return ReadBigEndian(1, Value) && Skip(Value + 1) ? MakeNull() : nullptr;
+			case 0xc8: return ReadBigEndian(2, Value) && Skip(Value + 1) ? MakeNull() : nullptr;
+			case 0xc9: return ReadBigEndian(4, Value) && Skip(Value + 1) ? MakeNull() : nullptr;
+			case 0xca:
+			{
+				if (!ReadBigEndian(4, Value))
+				{
+					return nullptr;
+				}
+				const uint32 Bits = uint32(Value);
+				float Float;
+				FMemory::Memcpy(&Float, &Bits, sizeof(Float));
+				return MakeShared<FJsonValueNumber>(Float);
+			}
+			case 0xcb:
+			{
+				if (!ReadBigEndian(8, Value))
+				{
+					return nullptr;
+				}
+				double Double;
+				FMemory::Memcpy(&Double, &Value, sizeof(Double));
+				return MakeShared<FJsonValueNumber>(Double);
+			}
+			case 0xcc: return ReadBigEndian(1, Value) ? MakeNumber(double(Value)) : nullptr;
+			case 0xcd: return ReadBigEndian(2, Value) ? MakeNumber(double(Value)) : nullptr;
+			case 0xce: return ReadBigEndian(4, Value) ? MakeNumber(double(Value)) : nullptr;
+			case 0xcf: return ReadBigEndian(8, Value) ? MakeNumber(double(Value)) : nullptr;
+			case 0xd0: return ReadBigEndian(1, Value) ? MakeNumber(int8(Value)) : nullptr;
+			case 0xd1: return ReadBigEndian(2, Value) ? MakeNumber(int16(Value)) : nullptr;
+			case 0xd2: return ReadBigEndian(4, Value) ? MakeNumber(int32(Value)) : nullptr;
+			case 0xd3: return ReadBigEndian(8, Value) ? MakeNumber(double(int64(Value))) : nullptr;
+			case 0xd4: return Skip(2) ? MakeNull() : nullptr;
+			case 0xd5: return Skip(3) ? MakeNull() : nullptr;
+			case 0xd6: return Skip(5) ? MakeNull() : nullptr;
+			case 0xd7: return Skip(9) ? MakeNull() : nullptr;
+			case 0xd8: return Skip(17) ? MakeNull() : nullptr;
+			case 0xdc: return ReadBigEndian(2, Value) ? ReadArray(Value, Depth) : nullptr;
+			case 0xdd: return ReadBigEndian(4, Value) ? ReadArray(Value, Depth) : nullptr;
+			case 0xde: return ReadBigEndian(2, Value) ? ReadMap(Value, Depth) : nullptr;
+			case 0xdf: return ReadBigEndian(4, Value) ? ReadMap(Value, Depth) : nullptr;
+			default:
+				return Fail(FString::Printf(TEXT("invalid tag 0x%02x at offset %d"), Tag, Offset - 1));
+			}
+		}
+
+		bool IsAtEnd() const { return Offset == Size; }
+
+		FString Error;
+
+	private:
+		static TSharedPtr<FJsonValue> MakeNumber(double Value)
+		{
+			return MakeShared<FJsonValueNumber>(Value);
+		}
+
+		/** 不支持的 ext 类型解码为 null */
+		static TSharedPtr<FJsonValue> MakeNull()
+		{
+			return MakeShared<FJsonValueNull>();
+		}
+
+		TSharedPtr<FJsonValue> ReadMap(uint64 Count, int32 Depth)
+		{
+			// 每个键值对至少 2 字节，先检查长度避免按伪造的数量预分配
+			if (Count > uint64(Size - Offset) / 2)
+			{
+				return Fail(TEXT("map size exceeds message"));
+			}
+
+			TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+			for (uint64 Index = 0; Index < Count; ++Index)
+			{
+				TSharedPtr<FJsonValue> Key = ReadValue(Depth + 1);
+				if (!Key.IsValid())
+				{
+					return nullptr;
+				}
+				if (Key->Type != EJson::String)
+				{
+					return Fail(TEXT("map keys must be strings"));
+				}
+
+				TSharedPtr<FJsonValue> Value = ReadValue(Depth + 1);
+				if (!Value.IsValid())
+				{
+					return nullptr;
+				}
+				Object->SetField(Key->AsString(), Value);
+			}
+			return MakeShared<FJsonValueObject>(Object);
+		}
+
+		TSharedPtr<FJsonValue> ReadArray(uint64 Count, int32 Depth)
+		{
+			if (Count > uint64(Size - Offset))
+			{
+				return Fail(TEXT("array size exceeds message"));
+			}
+
+			TArray<TSharedPtr<FJsonValue>> Items;
+			Items.Reserve(int32(Count));
+			for (uint64 Index = 0; Index < Count; ++Index)
+			{
+				TSharedPtr<FJsonValue> Item = ReadValue(Depth + 1);
+				if (!Item.IsValid())
+				{
+					return nullptr;
+				}
+				Items.Add(Item);
+			}
+			return MakeShared<FJsonValueArray>(Items);
+		}
+
+		TSharedPtr<FJsonValue> ReadString(uint64 Length)
+		{
+			if (Length > uint64(Size - Offset))
+			{
+				return Fail(TEXT("string exceeds message"));
+			}
+
+			// 直接从接收缓冲区转换，不复制 UTF-8 字节
+			FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Data + Offset), int32(Length));
+			Offset += int32(Length);
+			return MakeShared<FJsonValueString>(FString(Converted.Length(), Converted.Get()));
+		}
+
+		bool ReadByte(uint8& OutByte)
+		{
+			if (Offset >= Size)
+			{
+				Fail(TEXT("unexpected end of message"));
+				return false;
+			}
+			OutByte = Data[Offset++];
+			return true;
+		}
+
+		bool ReadBigEndian(int32 NumBytes, uint64& OutValue)
+		{
+			if (Size - Offset < NumBytes)
+			{
+				Fail(TEXT("unexpected end of message"));
+				return false;
+			}
+			OutValue = 0;
+			for (int32 Index = 0; Index < NumBytes; ++Index)
+			{
+				OutValue = (OutValue << 8) | Data[Offset++];
+			}
+			return true;
+		}
+
+		bool Skip(uint64 NumBytes)
+		{
+			if (NumBytes > uint64(Size - Offset))
+			{
+				Fail(TEXT("unexpected end of message"));
+				return false;
+			}
+			Offset += int32(NumBytes);
+			return true;
+		}
+
+		TSharedPtr<FJsonValue> Fail(const FString& InError)
+		{
+			if (Error.IsEmpty())
+			{
+				Error = InError;
+			}
+			return nullptr;
+		}
+
+		const uint8* Data;
+		int32 Size;
+		int32 Offset = 0;
+	};
+}
+
+void FMCPMessagePack::Encode(const FJsonObject& Object, TArray<uint8>& OutBytes)
+{
+	MCPMessagePack::FWriter Writer(OutBytes);
+	Writer.WriteObject(Object);
+}
+
+TSharedPtr<FJsonObject> FMCPMessagePack::Decode(const uint8* Data, int32 Size, FString* OutError)
+{
+	MCPMessagePack::FReader Reader(Data, Size);
+	TSharedPtr<FJsonValue> Value = Reader.ReadValue(0);
+
+	if (Value.IsValid() && Value->Type != EJson::Object)
+	{
+		Reader.Error = TEXT("top-level value is not a map");
+		Value.Reset();
+	}
+	else if (Value.IsValid() && !Reader.IsAtEnd())
+	{
+		Reader.Error = TEXT("trailing bytes after message");
+		Value.Reset();
+	}
+
+	if (!Value.IsValid())
+	{
+		if (OutError)
+		{
+			*OutError = Reader.Error;
+		}
+		return nullptr;
+	}
+	return Value->AsObject();
+}
+
+bool FMCPMessagePack::IsMessagePackFrame(const uint8* Data, int32 Size)
+{
+	if (Size <= 0)
+	{
+		return false;
+	}
+	const uint8 First = Data[0];
+	return (First & 0xf0) == 0x80 || First == 0xde || First == 0xdf;
+}
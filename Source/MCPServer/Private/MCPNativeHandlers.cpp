@@ -0,0 +1,751 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPNativeHandlers.h"
+
+#include "MCPServer.h"
+#include "Algo/Find.h"
+#include "Algo/Reverse.h"
+#include "MCPEditorLibrary.h"
+#include "MCPObjectInformDumpLibrary.h"
+#include "MCPResultCache.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Blueprint.h"
+#include "Engine/World.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "ScopedTransaction.h"
+#include "UObject/UnrealType.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+namespace MCPNativeHandlers
+{
+	/** 保留最近的日志行供 log_tail 查询，Serialize 可能在任意线程调用 */
+	class FLogTailDevice : public FOutputDevice
+	{
+	public:
+		struct FLine
+		{
+			uint64 Seq = 0;
+			FName Category;
+			ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+			FString Text;
+		};
+
+		virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override
+		{
+			FScopeLock ScopeLock(&Mutex);
+			FLine* Line = nullptr;
+			if (Lines.Num() < FMCPNativeHandlerRegistry::MaxLogTailLines)
+			{
+				Line = &Lines.AddDefaulted_GetRef();
+			}
+			else
+			{
+				// 缓冲已满，覆盖最旧的一行
+				Line = &Lines[Head];
+				Head = (Head + 1) % Lines.Num();
+			}
+			Line->Seq = ++LastSeq;
+			Line->Category = Category;
+			Line->Verbosity = ELogVerbosity::Type(Verbosity & ELogVerbosity::VerbosityMask);
+			Line->Text = V;
+		}
+
+		virtual bool CanBeUsedOnAnyThread() const override
+		{
+			return true;
+		}
+
+		/** 返回序号大于 AfterSeq 的最后 MaxLines 行（按时间顺序） */
+		TArray<FLine> GetLines(uint64 AfterSeq, int32 MaxLines, const FName& CategoryFilter, uint64& OutLastSeq) const
+		{
+			FScopeLock ScopeLock(&Mutex);
+			OutLastSeq = LastSeq;
+
+			TArray<FLine> Result;
+			for (int32 Offset = Lines.Num() - 1; Offset >= 0 && Result.Num() < MaxLines; --Offset)
+			{
+				const FLine& Line = Lines[(Head + Offset) % Lines.Num()];
+				if (Line.Seq <= AfterSeq)
+				{
+					break;
+				}
+				if (CategoryFilter.IsNone() || Line.Category == CategoryFilter)
+				{
+					Result.Add(Line);
+				}
+			}
+
+			Algo::Reverse(Result);
+			return Result;
+		}
+
+	private:
+		mutable FCriticalSection Mutex;
+		TArray<FLine> Lines;
+		/** 缓冲写满后最旧一行的位置 */
+		int32 Head = 0;
+		uint64 LastSeq = 0;
+	};
+
+	TUniquePtr<FLogTailDevice> LogTailDevice;
+
+	/** 先查找已加载的对象（关卡中的 Actor 等），找不到再按资源路径加载 */
+	UObject* FindOrLoadObject(const FString& Path)
+	{
+		UObject* Object = StaticFindObject(UObject::StaticClass(), nullptr, *Path);
+		return Object ? Object : LoadObject<UObject>(nullptr, *Path);
+	}
+
+	/** 按路径查找对象，蓝图资源取其生成类的 CDO */
+	UObject* ResolveTargetObject(const FString& Path, FString& OutError)
+	{
+		UObject* Object = FindOrLoadObject(Path);
+		if (!Object)
+		{
+			OutError = FString::Printf(TEXT("Object not found: %s"), *Path);
+			return nullptr;
+		}
+
+		if (UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+		{
+			if (!Blueprint->GeneratedClass)
+			{
+				OutError = FString::Printf(TEXT("Blueprint has no generated class: %s"), *Path);
+				return nullptr;
+			}
+			return Blueprint->GeneratedClass->GetDefaultObject();
+		}
+		return Object;
+	}
+
+	/**
+	 * path 指向的对象的读取结果能否缓存：只缓存资产和 CDO（蓝图资源解析为其 CDO）。
+	 * 关卡、PIE 中的 Actor 及其子对象每帧都可能变化而不触发失效事件；尚未加载的对象本次会被加载，
+	 * 无法预先判断，同样不缓存，加载后的下一次请求再缓存
+	 */
+	bool CanCacheObjectPath(const FJsonObject& Request)
+	{
+		FString Path;
+		if (!Request.TryGetStringField(TEXT("path"), Path))
+		{
+			return false;
+		}
+
+		const UObject* Object = StaticFindObject(UObject::StaticClass(), nullptr, *Path);
+		if (!Object || Object->IsA<UWorld>() || Object->GetTypedOuter<UWorld>())
+		{
+			return false;
+		}
+		return Object->IsA<UBlueprint>() || Object->HasAnyFlags(RF_ClassDefaultObject) || Object->IsAsset();
+	}
+
+	/**
+	 * 解析以 "." 分隔的属性路径，可穿过结构体和对象引用
+	 * @param OutOwner 最终属性所属的对象，用于 Modify/PostEditChange
+	 */
+	bool ResolvePropertyPath(UObject* Object, const FString& PropertyPath, FProperty*& OutProperty, void*& OutValuePtr, UObject*& OutOwner, FString& OutError)
+	{
+		TArray<FString> Segments;
+		PropertyPath.ParseIntoArray(Segments, TEXT("."));
+		if (Segments.Num() == 0)
+		{
+			OutError = TEXT("Empty property path");
+			return false;
+		}
+
+		const UStruct* Struct = Object->GetClass();
+		void* Container = Object;
+		OutOwner = Object;
+
+		for (int32 Index = 0; Index < Segments.Num(); ++Index)
+		{
+			FProperty* Property = FindFProperty<FProperty>(Struct, FName(*Segments[Index]));
+			if (!Property)
+			{
+				OutError = FString::Printf(TEXT("Property '%s' not found on %s"), *Segments[Index], *Struct->GetName());
+				return false;
+			}
+
+			void* ValuePtr = Property->ContainerPtrToValuePtr<void>(Container);
+			if (Index == Segments.Num() - 1)
+			{
+				OutProperty = Property;
+				OutValuePtr = ValuePtr;
+				return true;
+			}
+
+			if (FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+			{
+				Struct = StructProperty->Struct;
+				Container = ValuePtr;
+			}
+			else if (FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+			{
+				UObject* Inner = ObjectProperty->GetObjectPropertyValue(ValuePtr);
+				if (!Inner)
+				{
+					OutError = FString::Printf(TEXT("Property '%s' is null"), *Segments[Index]);
+					return false;
+				}
+				Struct = Inner->GetClass();
+				Container = Inner;
+				OutOwner = Inner;
+			}
+			else
+			{
+				OutError = FString::Printf(TEXT("Property '%s' is not a struct or object"), *Segments[Index]);
+				return false;
+			}
+		}
+		return false;
+	}
+
+	FString ExportPropertyText(FProperty* Property, const void* ValuePtr)
+	{
+		FString Value;
+#if ENGINE_MAJOR_VERSION >= 5
+		Property->ExportTextItem_Direct(Value, ValuePtr, nullptr, nullptr, PPF_None);
+#else
+		Property->ExportTextItem(Value, ValuePtr, nullptr, nullptr, PPF_None);
+#endif
+		return Value;
+	}
+
+	bool HandleLogTail(const FJsonObject& Request, FJsonObject& Result, FString& OutError)
+	{
+		if (!LogTailDevice)
+		{
+			OutError = TEXT("Log tail is not available");
+			return false;
+		}
+
+		int32 MaxLines = 100;
+		double After = 0.0;
+		FString Category;
+		Request.TryGetNumberField(TEXT("lines"), MaxLines);
+		Request.TryGetNumberField(TEXT("after"), After);
+		Request.TryGetStringField(TEXT("category"), Category);
+		MaxLines = FMath::Clamp(MaxLines, 1, FMCPNativeHandlerRegistry::MaxLogTailLines);
+
+		uint64 LastSeq = 0;
+		const TArray<FLogTailDevice::FLine> Lines = LogTailDevice->GetLines(uint64(FMath::Max(After, 0.0)), MaxLines, Category.IsEmpty() ? NAME_None : FName(*Category), LastSeq);
+
+		FString Output;
+		for (const FLogTailDevice::FLine& Line : Lines)
+		{
+			Output += FString::Printf(TEXT("%s: %s: %s\n"), *Line.Category.ToString(), ToString(Line.Verbosity), *Line.Text);
+		}
+
+		Result.SetStringField(TEXT("output"), Output);
+		Result.SetNumberField(TEXT("lines"), Lines.Num());
+		// 客户端把 next 作为下一次的 after，只取新增日志
+		Result.SetNumberField(TEXT("next"), double(LastSeq));
+		return true;
+	}
+
+	bool HandleCapturedLogs(const FJsonObject& Request, FJsonObject& Result, FString& OutError)
+	{
+		// captured_logs 在工作线程执行，只读；清空会抹掉游戏线程上正在执行的 Python 请求的日志，由 clear_captured_logs 负责
+		Result.SetStringField(TEXT("output"), FMCPServerModule::GetCapturedLogs());
+		Result.SetBoolField(TEXT("capturing"), FMCPServerModule::IsLogCaptureEnabled());
+		return true;
+	}
+
+	bool HandleClearCapturedLogs(const FJsonObject& Request, FJsonObject& Result, FString& OutError)
+	{
+		Result.SetStringField(TEXT("output"), FMCPServerModule::GetCapturedLogs());
+		FMCPServerModule::ClearCapturedLogs();
+		return true;
+	}
+
+	/**
+	 * 按包路径和/或类查询资产注册表，只返回磁盘上的资产（未保存的新建资产不在结果中）
+	 * class 在 UE5.1+ 为类路径（/Script/Engine.Blueprint），之前的版本为类名（Blueprint）
+	 */
+	bool HandleFindAssets(const FJsonObject& Request, FJsonObject& Result, FString& OutError)
+	{
+		FString Path;
+		FString ClassName;
+		bool bRecursive = true;
+		int32 MaxResults = 500;
+		Request.TryGetStringField(TEXT("path"), Path);
+		Request.TryGetStringField(TEXT("class"), ClassName);
+		Request.TryGetBoolField(TEXT("recursive"), bRecursive);
+		Request.TryGetNumberField(TEXT("max_results"), MaxResults);
+		if (Path.IsEmpty() && ClassName.IsEmpty())
+		{
+			OutError = TEXT("find_assets requires path or class");
+			return false;
+		}
+
+		FARFilter Filter;
+		if (!Path.IsEmpty())
+		{
+			Filter.PackagePaths.Add(FName(*Path));
+			Filter.bRecursivePaths = bRecursive;
+		}
+		if (!ClassName.IsEmpty())
+		{
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+			Filter.ClassPaths.Add(FTopLevelAssetPath(ClassName));
+#else
+			Filter.ClassNames.Add(FName(*ClassName));
+#endif
+			Filter.bRecursiveClasses = true;
+		}
+		// 内存中资产的查询需要遍历 UObject，只能在游戏线程进行；工作线程满或经 HTTP 调用时请求会回到游戏线程，
+		// 统一只查磁盘资产，同一请求无论在哪个线程执行（以及缓存的结果）都相同
+		Filter.bIncludeOnlyOnDiskAssets = true;
+
+#if ENGINE_MAJOR_VERSION >= 5
+		IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+#else
+		IAssetRegistry* AssetRegistry = &FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+#endif
+		if (!AssetRegistry)
+		{
+			OutError = TEXT("Asset registry is not available");
+			return false;
+		}
+
+		TArray<FAssetData> Assets;
+		AssetRegistry->GetAssets(Filter, Assets);
+
+		MaxResults = FMath::Max(MaxResults, 1);
+		FString Output;
+		for (int32 Index = 0; Index < Assets.Num() && Index < MaxResults; ++Index)
+		{
+			const FAssetData& Asset = Assets[Index];
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+			Output += FString::Printf(TEXT("%s\t%s\n"), *Asset.GetObjectPathString(), *Asset.AssetClassPath.ToString());
+#else
+			Output += FString::Printf(TEXT("%s\t%s\n"), *Asset.ObjectPath.ToString(), *Asset.AssetClass.ToString());
+#endif
+		}
+
+		Result.SetStringField(TEXT("output"), Output);
+		Result.SetNumberField(TEXT("count"), FMath::Min(Assets.Num(), MaxResults));
+		Result.SetNumberField(TEXT("total"), Assets.Num());
+		return true;
+	}
+
+	bool HandleDumpObject(const FJsonObject& Request, FJsonObject& Result, FString& OutError)
+	{
+		FString Path;
+		bool bVisibleOnly = false;
+		bool bModifiedOnly = false;
+		if (!Request.TryGetStringField(TEXT("path"), Path) || Path.IsEmpty())
+		{
+			OutError = TEXT("dump_object requires path");
+			return false;
+		}
+		Request.TryGetBoolField(TEXT("visible_only"), bVisibleOnly);
+		Request.TryGetBoolField(TEXT("modified_only"), bModifiedOnly);
+
+		if (Cast<UBlueprint>(FindOrLoadObject(Path)))
+		{
+			Result.SetStringField(TEXT("output"), UMCPObjectInformDumpLibrary::DumpBlueprintProperties(Path, bVisibleOnly, bModifiedOnly));
+			return true;
+		}
+
+		UObject* Object = ResolveTargetObject(Path, OutError);
+		if (!Object)
+		{
+			return false;
+		}
+
+		FString Output = TEXT("=== Object Property Dump ===\n");
+		Output += FString::Printf(TEXT("Object Path: %s\n"), *Object->GetPathName());
+		Output += FString::Printf(TEXT("Class: %s\n"), *Object->GetClass()->GetName());
+
+		TSet<const UObject*> VisitedObjects;
+		VisitedObjects.Add(Object);
+		const UObject* DefaultObject = Object->HasAnyFlags(RF_ClassDefaultObject) ? nullptr : Object->GetClass()->GetDefaultObject();
+		Output += UMCPObjectInformDumpLibrary::DumpObjectProperties(Object, 0, VisitedObjects, bVisibleOnly, bModifiedOnly, DefaultObject);
+
+		Result.SetStringField(TEXT("output"), Output);
+		return true;
+	}
+
+	bool HandleGetProperty(const FJsonObject& Request, FJsonObject& Result, FString& OutError)
+	{
+		FString Path;
+		FString PropertyPath;
+		if (!Request.TryGetStringField(TEXT("path"), Path) || !Request.TryGetStringField(TEXT("property"), PropertyPath))
+		{
+			OutError = TEXT("get_property requires path and property");
+			return false;
+		}
+
+		UObject* Object = ResolveTargetObject(Path, OutError);
+		FProperty* Property = nullptr;
+		void* ValuePtr = nullptr;
+		UObject* Owner = nullptr;
+		if (!Object || !ResolvePropertyPath(Object, PropertyPath, Property, ValuePtr, Owner, OutError))
+		{
+			return false;
+		}
+
+		const FString Value = ExportPropertyText(Property, ValuePtr);
+		Result.SetStringField(TEXT("output"), Value);
+		Result.SetStringField(TEXT("value"), Value);
+		Result.SetStringField(TEXT("cpp_type"), Property->GetCPPType());
+		return true;
+	}
+
+	bool HandleSetProperty(const FJsonObject& Request, FJsonObject& Result, FString& OutError)
+	{
+		FString Path;
+		FString PropertyPath;
+		FString Value;
+		if (!Request.TryGetStringField(TEXT("path"), Path) || !Request.TryGetStringField(TEXT("property"), PropertyPath) || !Request.TryGetStringField(TEXT("value"), Value))
+		{
+			OutError = TEXT("set_property requires path, property and value (in exported text form)");
+			return false;
+		}
+
+		UObject* Object = ResolveTargetObject(Path, OutError);
+		FProperty* Property = nullptr;
+		void* ValuePtr = nullptr;
+		UObject* Owner = nullptr;
+		if (!Object || !ResolvePropertyPath(Object, PropertyPath, Property, ValuePtr, Owner, OutError))
+		{
+			return false;
+		}
+
+		// 先导入到临时值，格式错误时不修改对象也不产生事务
+		void* TempValue = FMemory::Malloc(Property->GetSize(), Property->GetMinAlignment());
+		Property->InitializeValue(TempValue);
+#if ENGINE_MAJOR_VERSION >= 5
+		const TCHAR* ImportEnd = Property->ImportText_Direct(*Value, TempValue, Owner, PPF_None);
+#else
+		const TCHAR* ImportEnd = Property->ImportText(*Value, TempValue, PPF_None, Owner);
+#endif
+		if (!ImportEnd)
+		{
+			Property->DestroyValue(TempValue);
+			FMemory::Free(TempValue);
+			OutError = FString::Printf(TEXT("Failed to import '%s' into %s (%s)"), *Value, *PropertyPath, *Property->GetCPPType());
+			return false;
+		}
+
+		{
+			const FScopedTransaction Transaction(FText::FromString(FString::Printf(TEXT("MCP Set %s"), *PropertyPath)));
+			Owner->Modify();
+			Owner->PreEditChange(Property);
+			Property->CopyCompleteValue(ValuePtr, TempValue);
+			FPropertyChangedEvent ChangedEvent(Property, EPropertyChangeType::ValueSet);
+			Owner->PostEditChangeProperty(ChangedEvent);
+		}
+
+		Property->DestroyValue(TempValue);
+		FMemory::Free(TempValue);
+
+		const FString NewValue = ExportPropertyText(Property, ValuePtr);
+		Result.SetStringField(TEXT("output"), NewValue);
+		Result.SetStringField(TEXT("value"), NewValue);
+		return true;
+	}
+
+	bool HandleTagExists(const FJsonObject& Request, FJsonObject& Result, FString& OutError)
+	{
+		FString TagName;
+		if (!Request.TryGetStringField(TEXT("tag"), TagName) || TagName.IsEmpty())
+		{
+			OutError = TEXT("tag_exists requires tag");
+			return false;
+		}
+
+		const bool bExists = UMCPEditorLibrary::DoesGameplayTagExist(TagName);
+		Result.SetStringField(TEXT("output"), bExists ? TEXT("true") : TEXT("false"));
+		Result.SetBoolField(TEXT("exists"), bExists);
+		return true;
+	}
+}
+
+FMCPNativeHandlerRegistry& FMCPNativeHandlerRegistry::Get()
+{
+	static FMCPNativeHandlerRegistry Registry;
+	return Registry;
+}
+
+void FMCPNativeHandlerRegistry::Register(const FString& Type, FMCPNativeHandler Handler)
+{
+	FWriteScopeLock WriteLock(Lock);
+	Handlers.Add(Type, MoveTemp(Handler));
+}
+
+void FMCPNativeHandlerRegistry::Unregister(const FString& Type)
+{
+	FWriteScopeLock WriteLock(Lock);
+	Handlers.Remove(Type);
+}
+
+bool FMCPNativeHandlerRegistry::HasHandler(const FString& Type) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Handlers.Contains(Type);
+}
+
+bool FMCPNativeHandlerRegistry::GetPriority(const FString& Type, EMCPRequestPriority& OutPriority) const
+{
+	FReadScopeLock ReadLock(Lock);
+	if (const FMCPNativeHandler* Handler = Handlers.Find(Type))
+	{
+		OutPriority = Handler->Priority;
+		return true;
+	}
+	return false;
+}
+
+bool FMCPNativeHandlerRegistry::IsReadOnly(const FString& Type) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const FMCPNativeHandler* Handler = Handlers.Find(Type);
+	return Handler && Handler->bReadOnly;
+}
+
+bool FMCPNativeHandlerRegistry::IsCacheable(const FString& Type) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const FMCPNativeHandler* Handler = Handlers.Find(Type);
+	return Handler && Handler->bReadOnly && Handler->bCacheable;
+}
+
+bool FMCPNativeHandlerRegistry::IsCacheableRequest(const FString& Type, const FJsonObject& Request) const
+{
+	TFunction<bool(const FJsonObject&)> CanCache;
+	{
+		FReadScopeLock ReadLock(Lock);
+		const FMCPNativeHandler* Handler = Handlers.Find(Type);
+		if (!Handler || !Handler->bReadOnly || !Handler->bCacheable)
+		{
+			return false;
+		}
+		CanCache = Handler->CanCache;
+	}
+	return !CanCache || CanCache(Request);
+}
+
+bool FMCPNativeHandlerRegistry::IsThreadSafe(const FString& Type) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const FMCPNativeHandler* Handler = Handlers.Find(Type);
+	return Handler && Handler->bReadOnly && Handler->bThreadSafe;
+}
+
+TArray<FString> FMCPNativeHandlerRegistry::GetHandlerTypes() const
+{
+	FReadScopeLock ReadLock(Lock);
+	TArray<FString> Types;
+	Handlers.GetKeys(Types);
+	return Types;
+}
+
+TArray<FMCPNativeParam> FMCPNativeHandlerRegistry::GetParams(const FString& Type) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const FMCPNativeHandler* Handler = Handlers.Find(Type);
+	return Handler ? Handler->Params : TArray<FMCPNativeParam>();
+}
+
+FString FMCPNativeHandlerRegistry::DescribeParams(const FString& Type) const
+{
+	TArray<FString> Names;
+	for (const FMCPNativeParam& Param : GetParams(Type))
+	{
+		Names.Add(Param.bRequired ? Param.Name : Param.Name + TEXT("?"));
+	}
+	return FString::Printf(TEXT("%s(%s)"), *Type, *FString::Join(Names, TEXT(", ")));
+}
+
+bool FMCPNativeHandlerRegistry::ValidateParams(const FString& Type, const FJsonObject& Request, FString& OutError) const
+{
+	// 协议字段，任何请求都可能带有
+	static const TCHAR* const EnvelopeFields[] = { TEXT("type"), TEXT("id"), TEXT("priority"), TEXT("deadline_ms"), TEXT("progress") };
+
+	const TArray<FMCPNativeParam> Params = GetParams(Type);
+	TArray<FString> Problems;
+	for (const FMCPNativeParam& Param : Params)
+	{
+		const TSharedPtr<FJsonValue> Value = Request.TryGetField(Param.Name);
+		if (!Value.IsValid() || Value->IsNull())
+		{
+			if (Param.bRequired)
+			{
+				Problems.Add(FString::Printf(TEXT("missing required parameter '%s' (%s)"), *Param.Name, *Param.Type));
+			}
+			continue;
+		}
+
+		const bool bTypeMatches = (Param.Type == TEXT("string") && Value->Type == EJson::String)
+			|| (Param.Type == TEXT("number") && Value->Type == EJson::Number)
+			|| (Param.Type == TEXT("boolean") && Value->Type == EJson::Boolean);
+		if (!bTypeMatches)
+		{
+			Problems.Add(FString::Printf(TEXT("parameter '%s' must be a %s"), *Param.Name, *Param.Type));
+		}
+	}
+
+	if (Problems.Num() == 0)
+	{
+		return true;
+	}
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Request.Values)
+	{
+		const bool bKnown = Params.ContainsByPredicate([&Field](const FMCPNativeParam& Param) { return Param.Name == Field.Key; })
+			|| Algo::Find(EnvelopeFields, Field.Key) != nullptr;
+		if (!bKnown)
+		{
+			Problems.Add(FString::Printf(TEXT("unknown parameter '%s'"), *Field.Key));
+		}
+	}
+	OutError = FString::Printf(TEXT("%s; expected %s"), *FString::Join(Problems, TEXT(", ")), *DescribeParams(Type));
+	return false;
+}
+
+bool FMCPNativeHandlerRegistry::Execute(const FString& Type, const FJsonObject& Request, FJsonObject& Result, FString& OutError) const
+{
+	// 复制处理函数后释放锁，处理器内部可以注册/注销其他处理器
+	TFunction<bool(const FJsonObject&, FJsonObject&, FString&)> Handler;
+	{
+		FReadScopeLock ReadLock(Lock);
+		const FMCPNativeHandler* Found = Handlers.Find(Type);
+		if (!Found)
+		{
+			OutError = FString::Printf(TEXT("No native handler for '%s'"), *Type);
+			return false;
+		}
+		check(IsInGameThread() || (Found->bReadOnly && Found->bThreadSafe));
+		Handler = Found->Execute;
+	}
+
+	if (!ValidateParams(Type, Request, OutError))
+	{
+		return false;
+	}
+
+	return Handler(Request, Result, OutError);
+}
+
+TSharedPtr<FJsonObject> FMCPNativeHandlerRegistry::HandleRequest(const FJsonObject& Request) const
+{
+	FString Type;
+	FString Id;
+	if (!Request.TryGetStringField(TEXT("type"), Type) || !HasHandler(Type))
+	{
+		return nullptr;
+	}
+	Request.TryGetStringField(TEXT("id"), Id);
+
+	// 结果缓存只在游戏线程使用
+	const bool bCacheable = IsInGameThread() && IsCacheableRequest(Type, Request);
+	if (bCacheable)
+	{
+		if (TSharedPtr<FJsonObject> Cached = FMCPResultCache::Get().Find(Type, Request))
+		{
+			return Cached;
+		}
+	}
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	FString Error;
+	const bool bSuccess = Execute(Type, Request, *Result, Error);
+
+	Result->SetStringField(TEXT("type"), TEXT("result"));
+	Result->SetStringField(TEXT("id"), Id);
+	Result->SetBoolField(TEXT("success"), bSuccess);
+	if (!bSuccess)
+	{
+		Result->SetStringField(TEXT("error"), Error);
+	}
+
+	if (bCacheable)
+	{
+		FMCPResultCache::Get().Add(Type, Request, Result);
+	}
+	else if (IsInGameThread() && !IsReadOnly(Type))
+	{
+		// 修改操作之后之前缓存的结果可能失效（即使没有触发事务等事件）
+		FMCPResultCache::Get().Invalidate();
+	}
+	return Result;
+}
+
+void FMCPNativeHandlerRegistry::RegisterBuiltinHandlers()
+{
+	using namespace MCPNativeHandlers;
+
+	if (!LogTailDevice)
+	{
+		LogTailDevice = MakeUnique<FLogTailDevice>();
+		GLog->AddOutputDevice(LogTailDevice.Get());
+	}
+
+	auto MakeHandler = [](decltype(FMCPNativeHandler::Execute) Execute, TArray<FMCPNativeParam> Params, EMCPRequestPriority Priority, bool bReadOnly, bool bCacheable = true, bool bThreadSafe = false)
+	{
+		FMCPNativeHandler Handler;
+		Handler.Execute = MoveTemp(Execute);
+		Handler.Params = MoveTemp(Params);
+		Handler.Priority = Priority;
+		Handler.bReadOnly = bReadOnly;
+		Handler.bCacheable = bCacheable;
+		Handler.bThreadSafe = bThreadSafe;
+		return Handler;
+	};
+
+	// 参数与各处理器中 TryGet*Field 读取的字段一一对应
+	// 日志随时间增长，不缓存；日志缓冲自带锁，可在工作线程读取
+	Register(TEXT("log_tail"), MakeHandler(&HandleLogTail,
+		{ { TEXT("lines"), TEXT("number") }, { TEXT("after"), TEXT("number") }, { TEXT("category") } },
+		EMCPRequestPriority::High, true, false, true));
+	Register(TEXT("captured_logs"), MakeHandler(&HandleCapturedLogs,
+		{},
+		EMCPRequestPriority::High, true, false, true));
+	// 清空与游戏线程上的 Python 执行共用的捕获缓冲，按修改操作排队，不进入工作线程
+	Register(TEXT("clear_captured_logs"), MakeHandler(&HandleClearCapturedLogs,
+		{},
+		EMCPRequestPriority::Normal, false, false, false));
+	// UE5 的资产注册表查询是线程安全的；UE4 只能在游戏线程查询
+	Register(TEXT("find_assets"), MakeHandler(&HandleFindAssets,
+		{ { TEXT("path") }, { TEXT("class") }, { TEXT("recursive"), TEXT("boolean") }, { TEXT("max_results"), TEXT("number") } },
+		EMCPRequestPriority::Normal, true, true, ENGINE_MAJOR_VERSION >= 5));
+	Register(TEXT("tag_exists"), MakeHandler(&HandleTagExists,
+		{ { TEXT("tag"), TEXT("string"), true } },
+		EMCPRequestPriority::High, true));
+	FMCPNativeHandler GetPropertyHandler = MakeHandler(&HandleGetProperty,
+		{ { TEXT("path"), TEXT("string"), true }, { TEXT("property"), TEXT("string"), true } },
+		EMCPRequestPriority::Normal, true);
+	GetPropertyHandler.CanCache = &CanCacheObjectPath;
+	Register(TEXT("get_property"), MoveTemp(GetPropertyHandler));
+	Register(TEXT("set_property"), MakeHandler(&HandleSetProperty,
+		{ { TEXT("path"), TEXT("string"), true }, { TEXT("property"), TEXT("string"), true }, { TEXT("value"), TEXT("string"), true } },
+		EMCPRequestPriority::Normal, false));
+	FMCPNativeHandler DumpObjectHandler = MakeHandler(&HandleDumpObject,
+		{ { TEXT("path"), TEXT("string"), true }, { TEXT("visible_only"), TEXT("boolean") }, { TEXT("modified_only"), TEXT("boolean") } },
+		EMCPRequestPriority::Normal, true);
+	DumpObjectHandler.CanCache = &CanCacheObjectPath;
+	Register(TEXT("dump_object"), MoveTemp(DumpObjectHandler));
+}
+
+void FMCPNativeHandlerRegistry::Reset()
+{
+	using namespace MCPNativeHandlers;
+
+	{
+		FWriteScopeLock WriteLock(Lock);
+		Handlers.Empty();
+	}
+
+	if (LogTailDevice)
+	{
+		if (GLog)
+		{
+			GLog->RemoveOutputDevice(LogTailDevice.Get());
+		}
+		LogTailDevice.Reset();
+	}
+}
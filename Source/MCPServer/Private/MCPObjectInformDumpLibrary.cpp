@@ -1,11 +1,477 @@
 ﻿// Fill out your copyright notice in the Description page of Project Settings.
 
 #include "MCPObjectInformDumpLibrary.h"
+#include "MCPServer.h"
+#include "MCPRequestScheduler.h"
 #include "Engine/Blueprint.h"
 #include "Engine/BlueprintGeneratedClass.h"
 #include "UObject/UnrealType.h"
 #include "UObject/PropertyIterator.h"
 #include "Runtime/Launch/Resources/Version.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Engine/DataTable.h"
+#include "Engine/CurveTable.h"
+#include "DataTableUtils.h"
+
+namespace MCPTableDump
+{
+	/** Keep one row per line and cells separated by tabs */
+	static FString EscapeCell(const FString& Value)
+	{
+		return Value.Replace(TEXT("\\"), TEXT("\\\\"))
+			.Replace(TEXT("\t"), TEXT("\\t"))
+			.Replace(TEXT("\r"), TEXT("\\r"))
+			.Replace(TEXT("\n"), TEXT("\\n"));
+	}
+
+	static void FilterRowNames(const TArray<FName>& RowNames, const FString& RowNameFilter, TArray<FName>& OutRowNames)
+	{
+		for (const FName& RowName : RowNames)
+		{
+			if (RowNameFilter.IsEmpty() || RowName.ToString().MatchesWildcard(RowNameFilter))
+			{
+				OutRowNames.Add(RowName);
+			}
+		}
+	}
+}
+
+namespace MCPBinaryDump
+{
+	/** File magic "MCPB" and format version, must match mcp_server/MCPBinaryDump.py */
+	static const uint8 Magic[4] = { 'M', 'C', 'P', 'B' };
+	static constexpr uint8 Version = 1;
+	static constexpr uint8 FlagCompressed = 1 << 0;
+
+	/** Value tags */
+	enum class ETag : uint8
+	{
+		Null = 0,
+		False = 1,
+		True = 2,
+		Int = 3,
+		Double = 4,
+		String = 5,
+		Enum = 6,
+		Struct = 7,
+		Array = 8,
+		Set = 9,
+		Map = 10,
+		Object = 11,
+		Reference = 12,
+		Circular = 13,
+	};
+
+	/**
+	 * Writes the binary export format.
+	 * Values are written first into a scratch buffer while the string table and schema are collected,
+	 * then the sections are assembled in order: strings, schema, metadata, root struct.
+	 */
+	class FWriter
+	{
+	public:
+		FWriter(bool bInBlueprintVisibleOnly, bool bInModifiedOnly, int32 InMaxContainerElements)
+			: bBlueprintVisibleOnly(bInBlueprintVisibleOnly)
+			, bModifiedOnly(bInModifiedOnly)
+			, MaxContainerElements(InMaxContainerElements)
+		{
+		}
+
+		void WriteMetadata(const FString& PackagePath, const FString& BlueprintName, const FString& GeneratedClass, const FString& ParentClass)
+		{
+			WriteVarUInt(Metadata, AddString(PackagePath));
+			WriteVarUInt(Metadata, AddString(BlueprintName));
+			WriteVarUInt(Metadata, AddString(GeneratedClass));
+			WriteVarUInt(Metadata, AddString(ParentClass));
+		}
+
+		void WriteRootObject(const UObject* Object, const UObject* DefaultObject)
+		{
+			VisitedObjects.Add(Object);
+			WriteStruct(Object->GetClass(), Object, DefaultObject);
+		}
+
+		void Finish(TArray<uint8>& OutBytes, bool bCompress) const
+		{
+			TArray<uint8> Payload;
+			WriteVarUInt(Payload, Strings.Num());
+			for (const FString& String : Strings)
+			{
+				FTCHARToUTF8 Utf8(*String);
+				WriteVarUInt(Payload, Utf8.Length());
+				Payload.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+			}
+			WriteVarUInt(Payload, SchemaCount);
+			Payload.Append(SchemaEntries);
+			Payload.Append(Metadata);
+			Payload.Append(Values);
+
+			OutBytes.Reset();
+			OutBytes.Append(Magic, UE_ARRAY_COUNT(Magic));
+			OutBytes.Add(Version);
+
+			if (bCompress)
+			{
+				int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Payload.Num());
+				TArray<uint8> Compressed;
+				Compressed.SetNumUninitialized(CompressedSize);
+				if (FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num()))
+				{
+					OutBytes.Add(FlagCompressed);
+					WriteVarUInt(OutBytes, Payload.Num());
+					OutBytes.Append(Compressed.GetData(), CompressedSize);
+					return;
+				}
+			}
+
+			OutBytes.Add(0);
+			OutBytes.Append(Payload);
+		}
+
+	private:
+		static void WriteVarUInt(TArray<uint8>& Out, uint64 Value)
+		{
+			do
+			{
+				uint8 Byte = Value & 0x7F;
+				Value >>= 7;
+				if (Value != 0)
+				{
+					Byte |= 0x80;
+				}
+				Out.Add(Byte);
+			} while (Value != 0);
+		}
+
+		static void WriteVarInt(TArray<uint8>& Out, int64 Value)
+		{
+			// ZigZag so small negative numbers stay small
+			WriteVarUInt(Out, (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63));
+		}
+
+		uint32 AddString(const FString& String)
+		{
+			if (const uint32* Existing = StringIndices.Find(String))
+			{
+				return *Existing;
+			}
+			const uint32 Index = Strings.Add(String);
+			StringIndices.Add(String, Index);
+			return Index;
+		}
+
+		uint32 AddSchema(const FProperty* Property)
+		{
+			if (const uint32* Existing = SchemaIndices.Find(Property))
+			{
+				return *Existing;
+			}
+			const uint32 Index = SchemaIndices.Num();
+			SchemaIndices.Add(Property, Index);
+			SchemaCount++;
+			WriteVarUInt(SchemaEntries, AddString(Property->GetName()));
+			WriteVarUInt(SchemaEntries, AddString(Property->GetCPPType()));
+			WriteVarUInt(SchemaEntries, AddString(Property->GetClass()->GetName()));
+			return Index;
+		}
+
+		void WriteTag(ETag Tag)
+		{
+			Values.Add(static_cast<uint8>(Tag));
+		}
+
+		void WriteStringValue(const FString& String)
+		{
+			WriteTag(ETag::String);
+			WriteVarUInt(Values, AddString(String));
+		}
+
+		void WriteReference(const TCHAR* Kind, const FString& Path)
+		{
+			WriteTag(ETag::Reference);
+			WriteVarUInt(Values, AddString(Kind));
+			WriteVarUInt(Values, AddString(Path));
+		}
+
+		int32 GetElementLimit(int32 Num) const
+		{
+			return MaxContainerElements > 0 ? FMath::Min(Num, MaxContainerElements) : Num;
+		}
+
+		void WriteStruct(const UStruct* Struct, const void* StructPtr, const void* DefaultStructPtr)
+		{
+			// Field count is not known until filters ran, so fields go to a temporary buffer
+			TArray<uint8> SavedValues = MoveTemp(Values);
+			Values.Reset();
+			uint32 FieldCount = 0;
+
+			for (TFieldIterator<FProperty> PropIt(Struct); PropIt; ++PropIt)
+			{
+				FProperty* Property = *PropIt;
+				if (bBlueprintVisibleOnly && !UMCPObjectInformDumpLibrary::IsBlueprintEditable(Property))
+				{
+					continue;
+				}
+
+				const void* ValuePtr = Property->ContainerPtrToValuePtr<void>(StructPtr);
+				const void* DefaultValuePtr = DefaultStructPtr ? Property->ContainerPtrToValuePtr<void>(DefaultStructPtr) : nullptr;
+				if (bModifiedOnly && DefaultValuePtr && !UMCPObjectInformDumpLibrary::IsPropertyModified(Property, ValuePtr, DefaultValuePtr))
+				{
+					continue;
+				}
+
+				WriteVarUInt(Values, AddSchema(Property));
+				WriteValue(Property, ValuePtr, DefaultValuePtr);
+				FieldCount++;
+			}
+
+			TArray<uint8> Fields = MoveTemp(Values);
+			Values = MoveTemp(SavedValues);
+			WriteTag(ETag::Struct);
+			WriteVarUInt(Values, FieldCount);
+			Values.Append(Fields);
+		}
+
+		void WriteValue(FProperty* Property, const void* ValuePtr, const void* DefaultValuePtr)
+		{
+			if (!Property || !ValuePtr)
+			{
+				WriteTag(ETag::Null);
+				return;
+			}
+
+			if (FBoolProperty* BoolProp = CastField<FBoolProperty>(Property))
+			{
+				WriteTag(BoolProp->GetPropertyValue(ValuePtr) ? ETag::True : ETag::False);
+			}
+			else if (FEnumProperty* EnumProp = CastField<FEnumProperty>(Property))
+			{
+				const int64 EnumValue = EnumProp->GetUnderlyingProperty()->GetSignedIntPropertyValue(ValuePtr);
+				UEnum* EnumDef = EnumProp->GetEnum();
+				WriteTag(ETag::Enum);
+				WriteVarUInt(Values, AddString(EnumDef ? EnumDef->GetNameStringByValue(EnumValue) : FString()));
+				WriteVarInt(Values, EnumValue);
+			}
+			else if (CastField<FByteProperty>(Property) && CastField<FByteProperty>(Property)->Enum)
+			{
+				FByteProperty* ByteProp = CastField<FByteProperty>(Property);
+				const uint8 ByteValue = ByteProp->GetPropertyValue(ValuePtr);
+				WriteTag(ETag::Enum);
+				WriteVarUInt(Values, AddString(ByteProp->Enum->GetNameStringByValue(ByteValue)));
+				WriteVarInt(Values, ByteValue);
+			}
+			else if (FNumericProperty* NumericProp = CastField<FNumericProperty>(Property))
+			{
+				if (NumericProp->IsFloatingPoint())
+				{
+					double Value = NumericProp->GetFloatingPointPropertyValue(ValuePtr);
+					WriteTag(ETag::Double);
+					Values.Append(reinterpret_cast<const uint8*>(&Value), sizeof(double));
+				}
+				else
+				{
+					WriteTag(ETag::Int);
+					WriteVarInt(Values, NumericProp->GetSignedIntPropertyValue(ValuePtr));
+				}
+			}
+			else if (FStrProperty* StrProp = CastField<FStrProperty>(Property))
+			{
+				WriteStringValue(StrProp->GetPropertyValue(ValuePtr));
+			}
+			else if (FNameProperty* NameProp = CastField<FNameProperty>(Property))
+			{
+				WriteStringValue(NameProp->GetPropertyValue(ValuePtr).ToString());
+			}
+			else if (FTextProperty* TextProp = CastField<FTextProperty>(Property))
+			{
+				WriteStringValue(TextProp->GetPropertyValue(ValuePtr).ToString());
+			}
+			else if (FStructProperty* StructProp = CastField<FStructProperty>(Property))
+			{
+				WriteStruct(StructProp->Struct, ValuePtr, DefaultValuePtr);
+			}
+			else if (FClassProperty* ClassProp = CastField<FClassProperty>(Property))
+			{
+				UObject* ClassValue = ClassProp->GetObjectPropertyValue(ValuePtr);
+				if (ClassValue)
+				{
+					WriteReference(TEXT("Class"), ClassValue->GetPathName());
+				}
+				else
+				{
+					WriteTag(ETag::Null);
+				}
+			}
+			else if (FObjectProperty* ObjectProp = CastField<FObjectProperty>(Property))
+			{
+				WriteObject(ObjectProp->GetObjectPropertyValue(ValuePtr));
+			}
+			else if (Property->IsA<FSoftClassProperty>())
+			{
+				WriteReference(TEXT("SoftClass"), reinterpret_cast<const FSoftObjectPtr*>(ValuePtr)->ToString());
+			}
+			else if (Property->IsA<FSoftObjectProperty>())
+			{
+				WriteReference(TEXT("SoftObject"), reinterpret_cast<const FSoftObjectPtr*>(ValuePtr)->ToString());
+			}
+			else if (Property->IsA<FWeakObjectProperty>())
+			{
+				UObject* Object = reinterpret_cast<const FWeakObjectPtr*>(ValuePtr)->Get();
+				if (Object)
+				{
+					WriteReference(TEXT("WeakRef"), Object->GetPathName());
+				}
+				else
+				{
+					WriteTag(ETag::Null);
+				}
+			}
+			else if (Property->IsA<FLazyObjectProperty>())
+			{
+				UObject* Object = reinterpret_cast<const FLazyObjectPtr*>(ValuePtr)->Get();
+				if (Object)
+				{
+					WriteReference(TEXT("LazyRef"), Object->GetPathName());
+				}
+				else
+				{
+					WriteTag(ETag::Null);
+				}
+			}
+			else if (Property->IsA<FInterfaceProperty>())
+			{
+				UObject* Object = reinterpret_cast<const FScriptInterface*>(ValuePtr)->GetObject();
+				if (Object)
+				{
+					WriteReference(TEXT("Interface"), Object->GetPathName());
+				}
+				else
+				{
+					WriteTag(ETag::Null);
+				}
+			}
+			else if (FArrayProperty* ArrayProp = CastField<FArrayProperty>(Property))
+			{
+				FScriptArrayHelper ArrayHelper(ArrayProp, ValuePtr);
+				const int32 Num = ArrayHelper.Num();
+				const int32 Limit = GetElementLimit(Num);
+				WriteTag(ETag::Array);
+				WriteVarUInt(Values, Num);
+				WriteVarUInt(Values, Limit);
+				for (int32 Index = 0; Index < Limit; ++Index)
+				{
+					WriteValue(ArrayProp->Inner, ArrayHelper.GetRawPtr(Index), nullptr);
+				}
+			}
+			else if (FSetProperty* SetProp = CastField<FSetProperty>(Property))
+			{
+				FScriptSetHelper SetHelper(SetProp, ValuePtr);
+				const int32 Limit = GetElementLimit(SetHelper.Num());
+				WriteTag(ETag::Set);
+				WriteVarUInt(Values, SetHelper.Num());
+				WriteVarUInt(Values, Limit);
+				for (int32 Index = 0, Written = 0; Written < Limit && Index < SetHelper.GetMaxIndex(); ++Index)
+				{
+					if (SetHelper.IsValidIndex(Index))
+					{
+						WriteValue(SetProp->ElementProp, SetHelper.GetElementPtr(Index), nullptr);
+						++Written;
+					}
+				}
+			}
+			else if (FMapProperty* MapProp = CastField<FMapProperty>(Property))
+			{
+				FScriptMapHelper MapHelper(MapProp, ValuePtr);
+				const int32 Limit = GetElementLimit(MapHelper.Num());
+				WriteTag(ETag::Map);
+				WriteVarUInt(Values, MapHelper.Num());
+				WriteVarUInt(Values, Limit);
+				for (int32 Index = 0, Written = 0; Written < Limit && Index < MapHelper.GetMaxIndex(); ++Index)
+				{
+					if (MapHelper.IsValidIndex(Index))
+					{
+						WriteValue(MapProp->KeyProp, MapHelper.GetKeyPtr(Index), nullptr);
+						WriteValue(MapProp->ValueProp, MapHelper.GetValuePtr(Index), nullptr);
+						++Written;
+					}
+				}
+			}
+			else if (Property->IsA<FFieldPathProperty>())
+			{
+				WriteReference(TEXT("FieldPath"), reinterpret_cast<const FFieldPath*>(ValuePtr)->ToString());
+			}
+			else
+			{
+				// Delegates and anything else fall back to the exported text form
+				FString ExportedValue;
+#if ENGINE_MAJOR_VERSION >= 5
+				Property->ExportTextItem_Direct(ExportedValue, ValuePtr, ValuePtr, nullptr, PPF_None);
+#else
+				Property->ExportTextItem(ExportedValue, ValuePtr, ValuePtr, nullptr, PPF_None);
+#endif
+				WriteStringValue(ExportedValue);
+			}
+		}
+
+		void WriteObject(const UObject* Object)
+		{
+			if (!Object)
+			{
+				WriteTag(ETag::Null);
+				return;
+			}
+
+			if (Object->IsA<UClass>() || Object->IsA<UBlueprint>() || Object->IsA<UPackage>())
+			{
+				WriteReference(TEXT("Object"), Object->GetPathName());
+				return;
+			}
+
+			if (VisitedObjects.Contains(Object))
+			{
+				WriteTag(ETag::Circular);
+				WriteVarUInt(Values, AddString(Object->GetPathName()));
+				return;
+			}
+
+			WriteTag(ETag::Object);
+			WriteVarUInt(Values, AddString(Object->GetPathName()));
+			WriteVarUInt(Values, AddString(Object->GetClass()->GetName()));
+
+			// Same rule as the text dump: only inline small subobjects
+			int32 PropertyCount = 0;
+			for (TFieldIterator<FProperty> It(Object->GetClass(), EFieldIteratorFlags::ExcludeSuper); It && PropertyCount <= 20; ++It)
+			{
+				PropertyCount++;
+			}
+
+			if (PropertyCount > 0 && PropertyCount <= 20)
+			{
+				VisitedObjects.Add(Object);
+				WriteStruct(Object->GetClass(), Object, nullptr);
+			}
+			else
+			{
+				WriteTag(ETag::Null);
+			}
+		}
+
+	private:
+		bool bBlueprintVisibleOnly;
+		bool bModifiedOnly;
+		int32 MaxContainerElements;
+
+		TArray<FString> Strings;
+		TMap<FString, uint32> StringIndices;
+		TMap<const FProperty*, uint32> SchemaIndices;
+		uint32 SchemaCount = 0;
+		TArray<uint8> SchemaEntries;
+		TArray<uint8> Metadata;
+		TArray<uint8> Values;
+		TSet<const UObject*> VisitedObjects;
+	};
+}
 
 FString UMCPObjectInformDumpLibrary::GetIndent(int32 Indent)
 {
@@ -80,60 +546,408 @@ bool UMCPObjectInformDumpLibrary::IsPropertyModified(const FProperty* Property,
 FString UMCPObjectInformDumpLibrary::DumpBlueprintProperties(const FString& PackagePath, bool bBlueprintVisibleOnly, bool bModifiedOnly)
 {
 	FString Result;
-	
+	DumpBlueprintPropertiesStreamed(PackagePath, [&Result](const FString& Chunk)
+	{
+		Result += Chunk;
+		return true;
+	}, MAX_int32, bBlueprintVisibleOnly, bModifiedOnly);
+	return Result;
+}
+
+bool FMCPBlueprintDump::AppendChunk(int32 MaxChunkChars, FString& Out)
+{
+	const int32 StartLen = Out.Len();
+	if (!bHeaderWritten)
+	{
+		// Resuming in the middle of the properties (DumpBlueprintPropertiesChunk) does not repeat the header
+		if (NextPropertyIndex == 0)
+		{
+			Out += Header;
+		}
+		bHeaderWritten = true;
+	}
+
+	while (NextPropertyIndex < Properties.Num() && !FMCPCancellationScope::IsCancellationRequested())
+	{
+		UMCPObjectInformDumpLibrary::DumpPropertyEntry(Properties[NextPropertyIndex++], DefaultObject, ParentDefaultObject, 0, VisitedObjects, bBlueprintVisibleOnly, bModifiedOnly, Out);
+		if (Out.Len() - StartLen >= MaxChunkChars)
+		{
+			break;
+		}
+	}
+	return NextPropertyIndex < Properties.Num();
+}
+
+TSharedPtr<FMCPBlueprintDump> UMCPObjectInformDumpLibrary::PrepareBlueprintDump(const FString& PackagePath, bool bBlueprintVisibleOnly, bool bModifiedOnly, FString& OutError)
+{
 	// Try to load the Blueprint asset
 	UBlueprint* Blueprint = LoadObject<UBlueprint>(nullptr, *PackagePath);
 	if (!Blueprint)
 	{
-		return FString::Printf(TEXT("Error: Failed to load Blueprint from path: %s"), *PackagePath);
+		OutError = FString::Printf(TEXT("Error: Failed to load Blueprint from path: %s"), *PackagePath);
+		return nullptr;
 	}
 
-	Result += FString::Printf(TEXT("=== Blueprint Property Dump ===\n"));
-	Result += FString::Printf(TEXT("Package Path: %s\n"), *PackagePath);
-	Result += FString::Printf(TEXT("Blueprint Name: %s\n"), *Blueprint->GetName());
-	
+	FString Header;
+	Header += FString::Printf(TEXT("=== Blueprint Property Dump ===\n"));
+	Header += FString::Printf(TEXT("Package Path: %s\n"), *PackagePath);
+	Header += FString::Printf(TEXT("Blueprint Name: %s\n"), *Blueprint->GetName());
+
 	// Get the generated class from the Blueprint
 	UClass* GeneratedClass = Blueprint->GeneratedClass;
 	if (!GeneratedClass)
 	{
-		return Result + TEXT("Error: Blueprint has no generated class\n");
+		OutError = Header + TEXT("Error: Blueprint has no generated class\n");
+		return nullptr;
 	}
 
-	Result += FString::Printf(TEXT("Generated Class: %s\n"), *GeneratedClass->GetName());
-	
 	// Check parent class
 	UClass* ParentClass = GeneratedClass->GetSuperClass();
+	Header += FString::Printf(TEXT("Generated Class: %s\n"), *GeneratedClass->GetName());
 	if (ParentClass)
 	{
-		Result += FString::Printf(TEXT("Parent Class: %s\n"), *ParentClass->GetName());
+		Header += FString::Printf(TEXT("Parent Class: %s\n"), *ParentClass->GetName());
 	}
 
 	// Create default object to read default values
 	UObject* DefaultObject = GeneratedClass->GetDefaultObject();
 	if (!DefaultObject)
 	{
-		return Result + TEXT("Error: Failed to get default object\n");
+		OutError = Header + TEXT("Error: Failed to get default object\n");
+		return nullptr;
 	}
 
-	Result += FString::Printf(TEXT("Filter: BlueprintVisibleOnly=%s, ModifiedOnly=%s\n"),
+	Header += FString::Printf(TEXT("Filter: BlueprintVisibleOnly=%s, ModifiedOnly=%s\n"),
 		bBlueprintVisibleOnly ? TEXT("true") : TEXT("false"),
 		bModifiedOnly ? TEXT("true") : TEXT("false"));
+	Header += TEXT("\n=== Properties ===\n");
 
-	Result += TEXT("\n=== Properties ===\n");
-	
+	TSharedPtr<FMCPBlueprintDump> Dump = MakeShared<FMCPBlueprintDump>();
+	Dump->Blueprint.Reset(Blueprint);
+	Dump->GeneratedClass.Reset(GeneratedClass);
+	Dump->DefaultObject = DefaultObject;
 	// Get parent class default object for comparison
-	const UObject* ParentDefaultObject = nullptr;
-	if (bModifiedOnly && ParentClass)
+	Dump->ParentDefaultObject = bModifiedOnly && ParentClass ? ParentClass->GetDefaultObject() : nullptr;
+	Dump->Header = MoveTemp(Header);
+	Dump->bBlueprintVisibleOnly = bBlueprintVisibleOnly;
+	Dump->bModifiedOnly = bModifiedOnly;
+	Dump->VisitedObjects.Add(DefaultObject);
+
+	// Same walk as DumpStructProperties, split into chunks between top-level properties
+	for (TFieldIterator<FProperty> PropIt(GeneratedClass); PropIt; ++PropIt)
+	{
+		Dump->Properties.Add(*PropIt);
+	}
+	return Dump;
+}
+
+bool UMCPObjectInformDumpLibrary::DumpBlueprintPropertiesStreamed(const FString& PackagePath, TFunctionRef<bool(const FString& Chunk)> Sink, int32 MaxChunkChars, bool bBlueprintVisibleOnly, bool bModifiedOnly, int32 StartPropertyIndex, int32* OutNextPropertyIndex)
+{
+	if (OutNextPropertyIndex)
 	{
-		ParentDefaultObject = ParentClass->GetDefaultObject();
+		*OutNextPropertyIndex = INDEX_NONE;
 	}
 
-	TSet<const UObject*> VisitedObjects;
-	Result += DumpObjectProperties(DefaultObject, 0, VisitedObjects, bBlueprintVisibleOnly, bModifiedOnly, ParentDefaultObject);
+	FString Error;
+	TSharedPtr<FMCPBlueprintDump> Dump = PrepareBlueprintDump(PackagePath, bBlueprintVisibleOnly, bModifiedOnly, Error);
+	if (!Dump.IsValid())
+	{
+		Sink(Error);
+		return false;
+	}
+	Dump->NextPropertyIndex = FMath::Clamp(StartPropertyIndex, 0, Dump->Properties.Num());
+
+	while (true)
+	{
+		FString Buffer;
+		const bool bMore = Dump->AppendChunk(MaxChunkChars, Buffer);
+		if (FMCPCancellationScope::IsCancellationRequested())
+		{
+			Sink(TEXT("Error: Request cancelled"));
+			return false;
+		}
+
+		if (!bMore)
+		{
+			if (!Buffer.IsEmpty())
+			{
+				Sink(Buffer);
+			}
+			return true;
+		}
+
+		if (!Sink(Buffer))
+		{
+			if (OutNextPropertyIndex)
+			{
+				*OutNextPropertyIndex = Dump->GetNextPropertyIndex();
+			}
+			return true;
+		}
+	}
+}
 
+FString UMCPObjectInformDumpLibrary::DumpBlueprintPropertiesChunk(const FString& PackagePath, int32 Cursor, int32& OutNextCursor, bool& bOutSuccess, int32 MaxChunkChars, bool bBlueprintVisibleOnly, bool bModifiedOnly)
+{
+	FString Result;
+	int32 NextPropertyIndex = INDEX_NONE;
+	bOutSuccess = DumpBlueprintPropertiesStreamed(PackagePath, [&Result](const FString& Chunk)
+	{
+		Result = Chunk;
+		return false;
+	}, MaxChunkChars, bBlueprintVisibleOnly, bModifiedOnly, FMath::Max(Cursor, 0), &NextPropertyIndex);
+
+	OutNextCursor = NextPropertyIndex;
+	return Result;
+}
+
+FString UMCPObjectInformDumpLibrary::DumpTableRows(const FString& AssetPath, int32& OutNextRow, const FString& RowNameFilter, int32 StartRow, int32 MaxRows, bool bIncludeHeader)
+{
+	FString Result;
+	DumpTableRowsStreamed(AssetPath, [&Result](const FString& Chunk)
+	{
+		Result += Chunk;
+		return true;
+	}, RowNameFilter, StartRow, MaxRows, bIncludeHeader, MAX_int32, &OutNextRow);
 	return Result;
 }
 
+void FMCPTableDump::AppendHeader(int32 FirstRow, int32 EndRow, FString& Out) const
+{
+	Out += FString::Printf(TEXT("=== %s Dump ===\n"), *TableType);
+	Out += FString::Printf(TEXT("Asset Path: %s\n"), *AssetPath);
+	Out += FString::Printf(TEXT("Row Type: %s\n"), *RowType);
+	Out += FString::Printf(TEXT("Rows: %d matched of %d (filter: %s), showing %d-%d\n"),
+		MatchedRows.Num(), TotalRows, RowNameFilter.IsEmpty() ? TEXT("none") : *RowNameFilter, FirstRow, EndRow);
+	Out += TEXT("Columns: RowName");
+	for (const FString& Column : Columns)
+	{
+		Out += TEXT("\t");
+		Out += MCPTableDump::EscapeCell(Column);
+	}
+	Out += TEXT("\n");
+}
+
+void FMCPTableDump::AppendRow(int32 RowIndex, FString& Out) const
+{
+	Out += MCPTableDump::EscapeCell(MatchedRows[RowIndex].ToString());
+	AppendRowCells(MatchedRows[RowIndex], Out);
+	Out += TEXT("\n");
+}
+
+TSharedPtr<FMCPTableDump> UMCPObjectInformDumpLibrary::PrepareTableDump(const FString& AssetPath, const FString& RowNameFilter, FString& OutError)
+{
+	UObject* Asset = LoadObject<UObject>(nullptr, *AssetPath);
+	if (!Asset)
+	{
+		OutError = FString::Printf(TEXT("Error: Failed to load table from path: %s"), *AssetPath);
+		return nullptr;
+	}
+
+	TSharedPtr<FMCPTableDump> Dump = MakeShared<FMCPTableDump>();
+	Dump->AssetPath = AssetPath;
+	Dump->RowNameFilter = RowNameFilter;
+	Dump->Table.Reset(Asset);
+
+	if (UDataTable* DataTable = Cast<UDataTable>(Asset))
+	{
+		const UScriptStruct* RowStruct = DataTable->GetRowStruct();
+		if (!RowStruct)
+		{
+			OutError = TEXT("Error: DataTable has no row struct\n");
+			return nullptr;
+		}
+
+		Dump->TableType = TEXT("DataTable");
+		Dump->RowType = RowStruct->GetName();
+		Dump->TotalRows = DataTable->GetRowMap().Num();
+
+		TArray<FName> RowNames;
+		DataTable->GetRowMap().GenerateKeyArray(RowNames);
+		MCPTableDump::FilterRowNames(RowNames, RowNameFilter, Dump->MatchedRows);
+
+		TArray<const FProperty*> ColumnProperties;
+		for (TFieldIterator<FProperty> PropIt(RowStruct); PropIt; ++PropIt)
+		{
+			ColumnProperties.Add(*PropIt);
+			Dump->Columns.Add(DataTableUtils::GetPropertyExportName(*PropIt));
+		}
+
+		// Same text form as the DataTable CSV/JSON export
+		Dump->AppendRowCells = [DataTable, ColumnProperties](FName RowName, FString& Out)
+		{
+			const uint8* RowData = DataTable->FindRowUnchecked(RowName);
+			for (const FProperty* Property : ColumnProperties)
+			{
+				Out += TEXT("\t");
+				if (RowData)
+				{
+					Out += MCPTableDump::EscapeCell(DataTableUtils::GetPropertyValueAsString(Property, RowData, EDataTableExportFlags::None));
+				}
+			}
+		};
+	}
+	else if (UCurveTable* CurveTable = Cast<UCurveTable>(Asset))
+	{
+		Dump->TableType = TEXT("CurveTable");
+		Dump->RowType = CurveTable->GetCurveTableMode() == ECurveTableMode::SimpleCurves ? TEXT("SimpleCurve") : TEXT("RichCurve");
+		Dump->TotalRows = CurveTable->GetRowMap().Num();
+
+		TArray<FName> RowNames;
+		CurveTable->GetRowMap().GenerateKeyArray(RowNames);
+		MCPTableDump::FilterRowNames(RowNames, RowNameFilter, Dump->MatchedRows);
+
+		// Columns are the union of key times over the matched rows
+		TSet<float> KeyTimeSet;
+		for (const FName& RowName : Dump->MatchedRows)
+		{
+			const FRealCurve* Curve = CurveTable->FindCurveUnchecked(RowName);
+			for (auto It = Curve->GetKeyHandleIterator(); It; ++It)
+			{
+				KeyTimeSet.Add(Curve->GetKeyTime(*It));
+			}
+		}
+		TArray<float> KeyTimes = KeyTimeSet.Array();
+		KeyTimes.Sort();
+
+		for (float KeyTime : KeyTimes)
+		{
+			Dump->Columns.Add(FString::SanitizeFloat(KeyTime));
+		}
+
+		// Rows without a key at a column time leave the cell empty
+		Dump->AppendRowCells = [CurveTable, KeyTimes](FName RowName, FString& Out)
+		{
+			const FRealCurve* Curve = CurveTable->FindCurveUnchecked(RowName);
+			for (float KeyTime : KeyTimes)
+			{
+				Out += TEXT("\t");
+				const FKeyHandle KeyHandle = Curve ? Curve->FindKey(KeyTime) : FKeyHandle::Invalid();
+				if (Curve && Curve->IsKeyHandleValid(KeyHandle))
+				{
+					Out += FString::SanitizeFloat(Curve->GetKeyValue(KeyHandle));
+				}
+			}
+		};
+	}
+	else
+	{
+		OutError = FString::Printf(TEXT("Error: %s is a %s, expected DataTable or CurveTable\n"), *AssetPath, *Asset->GetClass()->GetName());
+		return nullptr;
+	}
+
+	return Dump;
+}
+
+bool UMCPObjectInformDumpLibrary::DumpTableRowsStreamed(const FString& AssetPath, TFunctionRef<bool(const FString& Chunk)> Sink, const FString& RowNameFilter, int32 StartRow, int32 MaxRows, bool bIncludeHeader, int32 MaxChunkChars, int32* OutNextRow)
+{
+	if (OutNextRow)
+	{
+		*OutNextRow = INDEX_NONE;
+	}
+
+	FString Error;
+	TSharedPtr<FMCPTableDump> Dump = PrepareTableDump(AssetPath, RowNameFilter, Error);
+	if (!Dump.IsValid())
+	{
+		Sink(Error);
+		return false;
+	}
+
+	const int32 NumMatched = Dump->MatchedRows.Num();
+	const int32 FirstRow = FMath::Clamp(StartRow, 0, NumMatched);
+	const int32 EndRow = MaxRows > 0 ? FMath::Min(NumMatched, FirstRow + MaxRows) : NumMatched;
+
+	FString Buffer;
+	if (bIncludeHeader)
+	{
+		Dump->AppendHeader(FirstRow, EndRow, Buffer);
+	}
+
+	for (int32 RowIndex = FirstRow; RowIndex < EndRow; ++RowIndex)
+	{
+		if (FMCPCancellationScope::IsCancellationRequested())
+		{
+			Sink(TEXT("Error: Request cancelled"));
+			return false;
+		}
+
+		Dump->AppendRow(RowIndex, Buffer);
+
+		if (Buffer.Len() >= MaxChunkChars)
+		{
+			const bool bContinue = Sink(Buffer);
+			Buffer.Reset();
+			if (!bContinue)
+			{
+				if (OutNextRow && RowIndex + 1 < NumMatched)
+				{
+					*OutNextRow = RowIndex + 1;
+				}
+				return true;
+			}
+		}
+	}
+
+	if (!Buffer.IsEmpty())
+	{
+		Sink(Buffer);
+	}
+
+	if (OutNextRow && EndRow < NumMatched)
+	{
+		*OutNextRow = EndRow;
+	}
+
+	return true;
+}
+
+bool UMCPObjectInformDumpLibrary::DumpBlueprintPropertiesBinary(const FString& PackagePath, TArray<uint8>& OutBytes, FString& OutError, bool bBlueprintVisibleOnly, bool bModifiedOnly, bool bCompress, int32 MaxContainerElements)
+{
+	UBlueprint* Blueprint = LoadObject<UBlueprint>(nullptr, *PackagePath);
+	if (!Blueprint)
+	{
+		OutError = FString::Printf(TEXT("Failed to load Blueprint from path: %s"), *PackagePath);
+		return false;
+	}
+
+	UClass* GeneratedClass = Blueprint->GeneratedClass;
+	if (!GeneratedClass)
+	{
+		OutError = TEXT("Blueprint has no generated class");
+		return false;
+	}
+
+	UObject* DefaultObject = GeneratedClass->GetDefaultObject();
+	if (!DefaultObject)
+	{
+		OutError = TEXT("Failed to get default object");
+		return false;
+	}
+
+	UClass* ParentClass = GeneratedClass->GetSuperClass();
+	const UObject* ParentDefaultObject = (bModifiedOnly && ParentClass) ? ParentClass->GetDefaultObject() : nullptr;
+
+	MCPBinaryDump::FWriter Writer(bBlueprintVisibleOnly, bModifiedOnly, MaxContainerElements);
+	Writer.WriteMetadata(PackagePath, Blueprint->GetName(), GeneratedClass->GetName(), ParentClass ? ParentClass->GetName() : FString());
+	Writer.WriteRootObject(DefaultObject, ParentDefaultObject);
+	Writer.Finish(OutBytes, bCompress);
+	return true;
+}
+
+bool UMCPObjectInformDumpLibrary::ExportBlueprintPropertiesBinary(const FString& PackagePath, const FString& OutputFilePath, bool bBlueprintVisibleOnly, bool bModifiedOnly, bool bCompress, int32 MaxContainerElements)
+{
+	TArray<uint8> Bytes;
+	FString Error;
+	if (!DumpBlueprintPropertiesBinary(PackagePath, Bytes, Error, bBlueprintVisibleOnly, bModifiedOnly, bCompress, MaxContainerElements))
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("ExportBlueprintPropertiesBinary: %s"), *Error);
+		return false;
+	}
+
+	return FFileHelper::SaveArrayToFile(Bytes, *OutputFilePath);
+}
+
 FString UMCPObjectInformDumpLibrary::ExportPropertyValueToText(FProperty* Property, const void* ValuePtr, bool bBlueprintVisibleOnly, bool bModifiedOnly, const void* DefaultValuePtr)
 {
 	if (!Property || !ValuePtr)
@@ -165,51 +979,56 @@ FString UMCPObjectInformDumpLibrary::DumpObjectProperties(const UObject* Object,
 FString UMCPObjectInformDumpLibrary::DumpStructProperties(const UStruct* Struct, const void* StructPtr, int32 Indent, TSet<const UObject*>& VisitedObjects, bool bBlueprintVisibleOnly, bool bModifiedOnly, const void* DefaultStructPtr)
 {
 	FString Result;
-	FString IndentStr = GetIndent(Indent);
 
 	// Iterate through all properties
 	for (TFieldIterator<FProperty> PropIt(Struct); PropIt; ++PropIt)
 	{
-		FProperty* Property = *PropIt;
-		
-		// Check Blueprint visibility filter
-		if (bBlueprintVisibleOnly && !IsBlueprintEditable(Property))
-		{
-			continue;
-		}
-
-		// Get property value pointer
-		const void* ValuePtr = Property->ContainerPtrToValuePtr<void>(StructPtr);
-		
-		// Get default value pointer for comparison
-		const void* DefaultValuePtr = nullptr;
-		if (DefaultStructPtr)
-		{
-			DefaultValuePtr = Property->ContainerPtrToValuePtr<void>(DefaultStructPtr);
-		}
+		DumpPropertyEntry(*PropIt, StructPtr, DefaultStructPtr, Indent, VisitedObjects, bBlueprintVisibleOnly, bModifiedOnly, Result);
+	}
 
-		// Check modified filter
-		if (bModifiedOnly && DefaultValuePtr && !IsPropertyModified(Property, ValuePtr, DefaultValuePtr))
-		{
-			continue;
-		}
+	return Result;
+}
 
-		// Get property name and type
-		FString PropertyName = Property->GetName();
-		FString PropertyType = Property->GetCPPType();
-		FString PropertyClass = Property->GetClass()->GetName();
+bool UMCPObjectInformDumpLibrary::DumpPropertyEntry(FProperty* Property, const void* StructPtr, const void* DefaultStructPtr, int32 Indent, TSet<const UObject*>& VisitedObjects, bool bBlueprintVisibleOnly, bool bModifiedOnly, FString& Out)
+{
+	// Check Blueprint visibility filter
+	if (bBlueprintVisibleOnly && !IsBlueprintEditable(Property))
+	{
+		return false;
+	}
 
-		// Get property value as string
-		FString ValueStr = DumpPropertyValue(Property, ValuePtr, Indent + 1, VisitedObjects, bBlueprintVisibleOnly, bModifiedOnly, DefaultValuePtr);
+	// Get property value pointer
+	const void* ValuePtr = Property->ContainerPtrToValuePtr<void>(StructPtr);
+	
+	// Get default value pointer for comparison
+	const void* DefaultValuePtr = nullptr;
+	if (DefaultStructPtr)
+	{
+		DefaultValuePtr = Property->ContainerPtrToValuePtr<void>(DefaultStructPtr);
+	}
 
-		Result += FString::Printf(TEXT("%sProperty: %s\n"), *IndentStr, *PropertyName);
-		Result += FString::Printf(TEXT("%s  Type: %s\n"), *IndentStr, *PropertyType);
-		Result += FString::Printf(TEXT("%s  PropertyClass: %s\n"), *IndentStr, *PropertyClass);
-		Result += FString::Printf(TEXT("%s  Value: %s\n"), *IndentStr, *ValueStr);
-		Result += TEXT("\n");
+	// Check modified filter
+	if (bModifiedOnly && DefaultValuePtr && !IsPropertyModified(Property, ValuePtr, DefaultValuePtr))
+	{
+		return false;
 	}
 
-	return Result;
+	FString IndentStr = GetIndent(Indent);
+
+	// Get property name and type
+	FString PropertyName = Property->GetName();
+	FString PropertyType = Property->GetCPPType();
+	FString PropertyClass = Property->GetClass()->GetName();
+
+	// Get property value as string
+	FString ValueStr = DumpPropertyValue(Property, ValuePtr, Indent + 1, VisitedObjects, bBlueprintVisibleOnly, bModifiedOnly, DefaultValuePtr);
+
+	Out += FString::Printf(TEXT("%sProperty: %s\n"), *IndentStr, *PropertyName);
+	Out += FString::Printf(TEXT("%s  Type: %s\n"), *IndentStr, *PropertyType);
+	Out += FString::Printf(TEXT("%s  PropertyClass: %s\n"), *IndentStr, *PropertyClass);
+	Out += FString::Printf(TEXT("%s  Value: %s\n"), *IndentStr, *ValueStr);
+	Out += TEXT("\n");
+	return true;
 }
 
 FString UMCPObjectInformDumpLibrary::DumpPropertyValue(FProperty* Property, const void* ValuePtr, int32 Indent, TSet<const UObject*>& VisitedObjects, bool bBlueprintVisibleOnly, bool bModifiedOnly, const void* DefaultValuePtr)
@@ -0,0 +1,478 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPPropertyIndex.h"
+
+#include "MCPServer.h"
+#include "MCPSnapshotStore.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace
+{
+	/** dump 文本中每级缩进两个空格，见 UMCPObjectInformDumpLibrary::GetIndent */
+	constexpr int32 DumpIndentWidth = 2;
+
+	bool IsTokenDelimiter(TCHAR Char)
+	{
+		switch (Char)
+		{
+		case TEXT('"'):
+		case TEXT('\''):
+		case TEXT('('):
+		case TEXT(')'):
+		case TEXT('['):
+		case TEXT(']'):
+		case TEXT('{'):
+		case TEXT('}'):
+		case TEXT(','):
+		case TEXT('='):
+		case TEXT(':'):
+			return true;
+		default:
+			return FChar::IsWhitespace(Char);
+		}
+	}
+
+	/** 解析 "[3]: value"、"{3}: value"、"[Key]: value" 形式的容器元素行 */
+	bool ParseElementLine(const FString& Trimmed, FString& OutSuffix, FString& OutValue)
+	{
+		if (Trimmed.Len() < 4 || (Trimmed[0] != TEXT('[') && Trimmed[0] != TEXT('{')))
+		{
+			return false;
+		}
+
+		const TCHAR Close = Trimmed[0] == TEXT('[') ? TEXT(']') : TEXT('}');
+		const int32 SeparatorIndex = Trimmed.Find(FString::Printf(TEXT("%c: "), Close));
+		if (SeparatorIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		OutSuffix = TEXT("[") + Trimmed.Mid(1, SeparatorIndex - 1) + TEXT("]");
+		OutValue = Trimmed.Mid(SeparatorIndex + 3);
+		return true;
+	}
+
+	bool TryParseNumericValue(const FString& Value, double& OutNumber)
+	{
+		if (Value.IsEmpty() || !FCString::IsNumeric(*Value))
+		{
+			return false;
+		}
+		OutNumber = FCString::Atod(*Value);
+		return true;
+	}
+
+	bool CompareNumeric(double Value, EMCPNumericCompare Compare, double Operand)
+	{
+		switch (Compare)
+		{
+		case EMCPNumericCompare::Less:         return Value < Operand;
+		case EMCPNumericCompare::LessEqual:    return Value <= Operand;
+		case EMCPNumericCompare::Equal:        return FMath::IsNearlyEqual(Value, Operand);
+		case EMCPNumericCompare::NotEqual:     return !FMath::IsNearlyEqual(Value, Operand);
+		case EMCPNumericCompare::GreaterEqual: return Value >= Operand;
+		case EMCPNumericCompare::Greater:      return Value > Operand;
+		default:                               return false;
+		}
+	}
+}
+
+FMCPPropertyIndex::FMCPPropertyIndex()
+{
+}
+
+FMCPPropertyIndex::~FMCPPropertyIndex()
+{
+	if (TSharedPtr<FMCPSnapshotStore> Store = SnapshotStore.Pin())
+	{
+		Store->OnSnapshotUpdated().Remove(SnapshotUpdatedHandle);
+	}
+}
+
+void FMCPPropertyIndex::Initialize(const TSharedRef<FMCPSnapshotStore>& InSnapshotStore)
+{
+	SnapshotStore = InSnapshotStore;
+	SnapshotUpdatedHandle = InSnapshotStore->OnSnapshotUpdated().AddSP(this, &FMCPPropertyIndex::HandleSnapshotUpdated);
+}
+
+int32 FMCPPropertyIndex::Rebuild()
+{
+	TSharedPtr<FMCPSnapshotStore> Store = SnapshotStore.Pin();
+	if (!Store.IsValid())
+	{
+		return 0;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const TArray<FString> AssetPaths = Store->GetAssetPaths();
+
+	FWriteScopeLock WriteLock(IndexLock);
+	Assets.Empty(AssetPaths.Num());
+	AssetIdByPath.Empty(AssetPaths.Num());
+	InvertedIndex.Empty();
+	NumericColumns.Empty();
+
+	FString Dump;
+	for (const FString& AssetPath : AssetPaths)
+	{
+		if (Store->ReadSnapshot(AssetPath, Dump))
+		{
+			IndexAssetLocked(AssetPath, Dump);
+		}
+	}
+
+	UE_LOG(LogMCPServer, Log, TEXT("Property index rebuilt: %d assets, %d tokens, %d numeric columns in %.1f ms"),
+		Assets.Num(), InvertedIndex.Num(), NumericColumns.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return Assets.Num();
+}
+
+void FMCPPropertyIndex::ReindexAsset(const FString& AssetPath)
+{
+	TSharedPtr<FMCPSnapshotStore> Store = SnapshotStore.Pin();
+	FString Dump;
+	const bool bHasSnapshot = Store.IsValid() && Store->ReadSnapshot(AssetPath, Dump);
+
+	FWriteScopeLock WriteLock(IndexLock);
+	RemoveAssetLocked(AssetPath);
+	if (bHasSnapshot)
+	{
+		IndexAssetLocked(AssetPath, Dump);
+	}
+}
+
+void FMCPPropertyIndex::RemoveAsset(const FString& AssetPath)
+{
+	FWriteScopeLock WriteLock(IndexLock);
+	RemoveAssetLocked(AssetPath);
+}
+
+void FMCPPropertyIndex::HandleSnapshotUpdated(const FString& AssetPath, bool bRemoved)
+{
+	if (bRemoved)
+	{
+		RemoveAsset(AssetPath);
+	}
+	else
+	{
+		ReindexAsset(AssetPath);
+	}
+}
+
+void FMCPPropertyIndex::IndexAssetLocked(const FString& AssetPath, const FString& Dump)
+{
+	const int32 AssetId = Assets.Add(FAssetRecord());
+	FAssetRecord& Record = Assets[AssetId];
+	Record.AssetPath = AssetPath;
+	AssetIdByPath.Add(AssetPath, AssetId);
+
+	// 本资产每个 token 命中的条目（EntryId 递增），最后整段插入倒排表
+	TMap<FString, TArray<int32>> EntriesByToken;
+
+	// 依据缩进还原属性路径：每个 "Property: X" 行的缩进级别即其嵌套深度
+	TArray<FString> PathStack;
+	TArray<FString> Lines;
+	Dump.ParseIntoArrayLines(Lines, true);
+
+	bool bInPropertySection = false;
+	for (const FString& Line : Lines)
+	{
+		if (!bInPropertySection)
+		{
+			bInPropertySection = Line.StartsWith(TEXT("=== Properties ==="));
+			continue;
+		}
+
+		int32 Spaces = 0;
+		while (Spaces < Line.Len() && Line[Spaces] == TEXT(' '))
+		{
+			++Spaces;
+		}
+		const FString Trimmed = Line.Mid(Spaces);
+
+		FString PropertyPath;
+		FString Value;
+		if (Trimmed.StartsWith(TEXT("Property: ")))
+		{
+			const int32 Depth = Spaces / DumpIndentWidth;
+			PathStack.SetNum(FMath::Min(PathStack.Num(), Depth));
+			while (PathStack.Num() < Depth)
+			{
+				PathStack.Add(TEXT("?"));
+			}
+			PathStack.Add(Trimmed.Mid(10));
+			continue;
+		}
+		else if (Trimmed.StartsWith(TEXT("Value: ")))
+		{
+			Value = Trimmed.Mid(7);
+			PropertyPath = FString::Join(PathStack, TEXT("."));
+		}
+		else
+		{
+			FString Suffix;
+			if (!ParseElementLine(Trimmed, Suffix, Value))
+			{
+				continue;
+			}
+			PropertyPath = FString::Join(PathStack, TEXT(".")) + Suffix;
+		}
+
+		// 结构体/容器的开头行（"{"、"[Count: N]"）不是值本身，其子项会逐行索引
+		if (Value.IsEmpty() || Value == TEXT("{") || Value.StartsWith(TEXT("[Count:")) || Value.StartsWith(TEXT("Set{Count:")) || Value.StartsWith(TEXT("Map{Count:")))
+		{
+			continue;
+		}
+
+		const int32 EntryId = Record.Entries.Num();
+		FEntry& Entry = Record.Entries.AddDefaulted_GetRef();
+		Entry.PropertyPath = PropertyPath;
+		Entry.Value = Value;
+
+		TArray<FString> Tokens;
+		Tokenize(Value, Tokens);
+		for (const FString& Token : Tokens)
+		{
+			EntriesByToken.FindOrAdd(Token).Add(EntryId);
+		}
+
+		double Number = 0.0;
+		if (TryParseNumericValue(Value, Number) && PathStack.Num() > 0)
+		{
+			const FName ColumnName(*PathStack.Last());
+			FNumericColumn& Column = NumericColumns.FindOrAdd(ColumnName);
+			Column.Values.Add(Number);
+			Column.AssetIds.Add(AssetId);
+			Column.EntryIds.Add(EntryId);
+			Record.NumericColumns.Add(ColumnName);
+		}
+	}
+
+	for (TPair<FString, TArray<int32>>& Pair : EntriesByToken)
+	{
+		TArray<FPosting>& Postings = InvertedIndex.FindOrAdd(Pair.Key);
+		const int32 InsertIndex = Algo::LowerBoundBy(Postings, FPosting{ AssetId, 0 }.GetSortKey(), &FPosting::GetSortKey);
+		TArray<FPosting> AssetPostings;
+		AssetPostings.Reserve(Pair.Value.Num());
+		for (int32 EntryId : Pair.Value)
+		{
+			AssetPostings.Add({ AssetId, EntryId });
+		}
+		Postings.Insert(MoveTemp(AssetPostings), InsertIndex);
+		Record.Tokens.Add(Pair.Key);
+	}
+}
+
+void FMCPPropertyIndex::RemoveAssetLocked(const FString& AssetPath)
+{
+	int32 AssetId = INDEX_NONE;
+	if (!AssetIdByPath.RemoveAndCopyValue(AssetPath, AssetId))
+	{
+		return;
+	}
+
+	FAssetRecord& Record = Assets[AssetId];
+	for (const FString& Token : Record.Tokens)
+	{
+		if (TArray<FPosting>* Postings = InvertedIndex.Find(Token))
+		{
+			const int32 First = Algo::LowerBoundBy(*Postings, FPosting{ AssetId, 0 }.GetSortKey(), &FPosting::GetSortKey);
+			const int32 Last = Algo::LowerBoundBy(*Postings, FPosting{ AssetId + 1, 0 }.GetSortKey(), &FPosting::GetSortKey);
+			Postings->RemoveAt(First, Last - First);
+			if (Postings->Num() == 0)
+			{
+				InvertedIndex.Remove(Token);
+			}
+		}
+	}
+
+	for (const FName& ColumnName : Record.NumericColumns)
+	{
+		if (FNumericColumn* Column = NumericColumns.Find(ColumnName))
+		{
+			int32 WriteIndex = 0;
+			for (int32 ReadIndex = 0; ReadIndex < Column->Values.Num(); ++ReadIndex)
+			{
+				if (Column->AssetIds[ReadIndex] != AssetId)
+				{
+					Column->Values[WriteIndex] = Column->Values[ReadIndex];
+					Column->AssetIds[WriteIndex] = Column->AssetIds[ReadIndex];
+					Column->EntryIds[WriteIndex] = Column->EntryIds[ReadIndex];
+					++WriteIndex;
+				}
+			}
+			Column->Values.SetNum(WriteIndex);
+			Column->AssetIds.SetNum(WriteIndex);
+			Column->EntryIds.SetNum(WriteIndex);
+			if (WriteIndex == 0)
+			{
+				NumericColumns.Remove(ColumnName);
+			}
+		}
+	}
+
+	Assets.RemoveAt(AssetId);
+}
+
+FMCPPropertyIndexHit FMCPPropertyIndex::MakeHit(int32 AssetId, int32 EntryId) const
+{
+	const FAssetRecord& Record = Assets[AssetId];
+	const FEntry& Entry = Record.Entries[EntryId];
+
+	FMCPPropertyIndexHit Hit;
+	Hit.AssetPath = Record.AssetPath;
+	Hit.PropertyPath = Entry.PropertyPath;
+	Hit.Value = Entry.Value;
+	return Hit;
+}
+
+TArray<FMCPPropertyIndexHit> FMCPPropertyIndex::FindByValue(const FString& Query, int32 MaxResults) const
+{
+	TArray<FMCPPropertyIndexHit> Hits;
+
+	TArray<FString> QueryTokens;
+	Tokenize(Query, QueryTokens);
+	if (QueryTokens.Num() == 0)
+	{
+		return Hits;
+	}
+
+	FReadScopeLock ReadLock(IndexLock);
+
+	// 从最短的倒排表开始归并求交集；其余表只向前推进，每步二分跳到候选位置
+	TArray<const TArray<FPosting>*> PostingLists;
+	for (const FString& Token : QueryTokens)
+	{
+		const TArray<FPosting>* Postings = InvertedIndex.Find(Token);
+		if (!Postings)
+		{
+			return Hits;
+		}
+		PostingLists.Add(Postings);
+	}
+	PostingLists.Sort([](const TArray<FPosting>& A, const TArray<FPosting>& B) { return A.Num() < B.Num(); });
+
+	TArray<int32> Cursors;
+	Cursors.SetNumZeroed(PostingLists.Num());
+	for (const FPosting& Candidate : *PostingLists[0])
+	{
+		const uint64 CandidateKey = Candidate.GetSortKey();
+		bool bMatchesAll = true;
+		for (int32 ListIndex = 1; ListIndex < PostingLists.Num() && bMatchesAll; ++ListIndex)
+		{
+			const TArray<FPosting>& Postings = *PostingLists[ListIndex];
+			int32& Cursor = Cursors[ListIndex];
+			Cursor += Algo::LowerBoundBy(MakeArrayView(Postings).Slice(Cursor, Postings.Num() - Cursor), CandidateKey, &FPosting::GetSortKey);
+			if (Cursor >= Postings.Num())
+			{
+				return Hits;
+			}
+			bMatchesAll = Postings[Cursor].GetSortKey() == CandidateKey;
+		}
+
+		if (bMatchesAll)
+		{
+			Hits.Add(MakeHit(Candidate.AssetId, Candidate.EntryId));
+			if (MaxResults > 0 && Hits.Num() >= MaxResults)
+			{
+				break;
+			}
+		}
+	}
+
+	return Hits;
+}
+
+TArray<FMCPPropertyIndexHit> FMCPPropertyIndex::FindByNumeric(FName PropertyName, EMCPNumericCompare Compare, double Operand, int32 MaxResults) const
+{
+	TArray<FMCPPropertyIndexHit> Hits;
+
+	FReadScopeLock ReadLock(IndexLock);
+
+	const FNumericColumn* Column = NumericColumns.Find(PropertyName);
+	if (!Column)
+	{
+		return Hits;
+	}
+
+	const double* Values = Column->Values.GetData();
+	const int32 RowCount = Column->Values.Num();
+	for (int32 Row = 0; Row < RowCount; ++Row)
+	{
+		if (CompareNumeric(Values[Row], Compare, Operand))
+		{
+			Hits.Add(MakeHit(Column->AssetIds[Row], Column->EntryIds[Row]));
+			if (MaxResults > 0 && Hits.Num() >= MaxResults)
+			{
+				break;
+			}
+		}
+	}
+
+	return Hits;
+}
+
+int32 FMCPPropertyIndex::GetIndexedAssetCount() const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	return Assets.Num();
+}
+
+int32 FMCPPropertyIndex::GetTokenCount() const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	return InvertedIndex.Num();
+}
+
+void FMCPPropertyIndex::Tokenize(const FString& Text, TArray<FString>& OutTokens)
+{
+	OutTokens.Reset();
+
+	auto AddToken = [&OutTokens](const FString& Token)
+	{
+		if (!Token.IsEmpty())
+		{
+			OutTokens.AddUnique(Token.ToLower());
+		}
+	};
+
+	int32 TokenStart = INDEX_NONE;
+	for (int32 Index = 0; Index <= Text.Len(); ++Index)
+	{
+		const bool bAtEnd = Index == Text.Len();
+		if (!bAtEnd && !IsTokenDelimiter(Text[Index]))
+		{
+			if (TokenStart == INDEX_NONE)
+			{
+				TokenStart = Index;
+			}
+			continue;
+		}
+
+		if (TokenStart != INDEX_NONE)
+		{
+			const FString Token = Text.Mid(TokenStart, Index - TokenStart);
+			AddToken(Token);
+
+			// 对象路径同时按 '/' 和 '.' 拆出资产名，方便按短名查询（如 "SC_Explosion"）
+			if (Token.Contains(TEXT("/")) || Token.Contains(TEXT(".")))
+			{
+				TArray<FString> Parts;
+				Token.ParseIntoArray(Parts, TEXT("/"), true);
+				for (const FString& Part : Parts)
+				{
+					TArray<FString> SubParts;
+					Part.ParseIntoArray(SubParts, TEXT("."), true);
+					for (const FString& SubPart : SubParts)
+					{
+						if (!FCString::IsNumeric(*SubPart))
+						{
+							AddToken(SubPart);
+						}
+					}
+				}
+			}
+			TokenStart = INDEX_NONE;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPPropertyIndexLibrary.h"
+#include "MCPPropertyIndex.h"
+#include "MCPServer.h"
+
+namespace
+{
+	TSharedPtr<FMCPPropertyIndex> GetPropertyIndex()
+	{
+		if (FMCPServerModule* MCPModule = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+		{
+			return MCPModule->GetPropertyIndex();
+		}
+		return nullptr;
+	}
+
+	bool ParseCompareOperator(const FString& Operator, EMCPNumericCompare& OutCompare)
+	{
+		static const TMap<FString, EMCPNumericCompare> Operators = {
+			{ TEXT("<"), EMCPNumericCompare::Less },
+			{ TEXT("<="), EMCPNumericCompare::LessEqual },
+			{ TEXT("=="), EMCPNumericCompare::Equal },
+			{ TEXT("="), EMCPNumericCompare::Equal },
+			{ TEXT("!="), EMCPNumericCompare::NotEqual },
+			{ TEXT(">="), EMCPNumericCompare::GreaterEqual },
+			{ TEXT(">"), EMCPNumericCompare::Greater },
+		};
+
+		if (const EMCPNumericCompare* Found = Operators.Find(Operator.TrimStartAndEnd()))
+		{
+			OutCompare = *Found;
+			return true;
+		}
+		return false;
+	}
+
+	TArray<FString> FormatHits(const TArray<FMCPPropertyIndexHit>& Hits)
+	{
+		TArray<FString> Results;
+		Results.Reserve(Hits.Num());
+		for (const FMCPPropertyIndexHit& Hit : Hits)
+		{
+			Results.Add(Hit.ToString());
+		}
+		return Results;
+	}
+}
+
+int32 UMCPPropertyIndexLibrary::RebuildPropertyIndex()
+{
+	TSharedPtr<FMCPPropertyIndex> PropertyIndex = GetPropertyIndex();
+	return PropertyIndex.IsValid() ? PropertyIndex->Rebuild() : 0;
+}
+
+TArray<FString> UMCPPropertyIndexLibrary::FindPropertiesByValue(const FString& Query, int32 MaxResults)
+{
+	TSharedPtr<FMCPPropertyIndex> PropertyIndex = GetPropertyIndex();
+	if (!PropertyIndex.IsValid())
+	{
+		return TArray<FString>();
+	}
+	return FormatHits(PropertyIndex->FindByValue(Query, MaxResults));
+}
+
+TArray<FString> UMCPPropertyIndexLibrary::FindPropertiesByNumericValue(const FString& PropertyName, const FString& Operator, float Value, int32 MaxResults)
+{
+	EMCPNumericCompare Compare;
+	if (!ParseCompareOperator(Operator, Compare))
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("FindPropertiesByNumericValue: unsupported operator '%s'"), *Operator);
+		return TArray<FString>();
+	}
+
+	TSharedPtr<FMCPPropertyIndex> PropertyIndex = GetPropertyIndex();
+	if (!PropertyIndex.IsValid())
+	{
+		return TArray<FString>();
+	}
+	return FormatHits(PropertyIndex->FindByNumeric(FName(*PropertyName), Compare, Value, MaxResults));
+}
+
+TArray<FString> UMCPPropertyIndexLibrary::FindBlueprintsReferencing(const FString& Query)
+{
+	TArray<FString> AssetPaths;
+	TSharedPtr<FMCPPropertyIndex> PropertyIndex = GetPropertyIndex();
+	if (!PropertyIndex.IsValid())
+	{
+		return AssetPaths;
+	}
+
+	for (const FMCPPropertyIndexHit& Hit : PropertyIndex->FindByValue(Query, 0))
+	{
+		AssetPaths.AddUnique(Hit.AssetPath);
+	}
+	return AssetPaths;
+}
@@ -0,0 +1,197 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPRequestScheduler.h"
+
+#include "MCPNativeHandlers.h"
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarMCPEndpointFrameBudgetMs(
+	TEXT("MCP.Endpoint.FrameBudgetMs"),
+	8.0f,
+	TEXT("Game thread time per frame (ms) the MCP endpoint may spend executing queued requests. ")
+	TEXT("At least one request runs per frame; high priority requests (state queries) are not limited."),
+	ECVF_Default);
+
+namespace MCPRequestScheduler
+{
+	static thread_local FMCPCancellationToken* CurrentCancellationToken = nullptr;
+}
+
+FMCPCancellationScope::FMCPCancellationScope(const FMCPCancellationTokenPtr& InToken)
+	: Token(InToken)
+	, PreviousToken(MCPRequestScheduler::CurrentCancellationToken)
+{
+	MCPRequestScheduler::CurrentCancellationToken = Token.Get();
+}
+
+FMCPCancellationScope::~FMCPCancellationScope()
+{
+	MCPRequestScheduler::CurrentCancellationToken = PreviousToken;
+}
+
+bool FMCPCancellationScope::IsCancellationRequested()
+{
+	const FMCPCancellationToken* Token = MCPRequestScheduler::CurrentCancellationToken;
+	return Token && Token->IsCancelled();
+}
+
+void FMCPRequestScheduler::Enqueue(FMCPEndpointRequest&& Request)
+{
+	FPriorityQueue& Queue = Queues[static_cast<int32>(Request.Priority)];
+	FConnectionQueue* ConnectionQueue = Queue.Connections.FindByPredicate([&Request](const FConnectionQueue& Candidate)
+	{
+		return Candidate.ConnectionId == Request.ConnectionId;
+	});
+
+	if (!ConnectionQueue)
+	{
+		ConnectionQueue = &Queue.Connections.AddDefaulted_GetRef();
+		ConnectionQueue->ConnectionId = Request.ConnectionId;
+	}
+	ConnectionQueue->Requests.Add(MoveTemp(Request));
+}
+
+void FMCPRequestScheduler::RemoveConnection(uint32 ConnectionId)
+{
+	for (FPriorityQueue& Queue : Queues)
+	{
+		const int32 Index = Queue.Connections.IndexOfByPredicate([ConnectionId](const FConnectionQueue& ConnectionQueue)
+		{
+			return ConnectionQueue.ConnectionId == ConnectionId;
+		});
+		if (Index != INDEX_NONE)
+		{
+			Queue.Connections.RemoveAt(Index);
+			// 保持轮询位置指向原本的下一个连接
+			if (Index < Queue.NextConnection)
+			{
+				Queue.NextConnection--;
+			}
+		}
+	}
+}
+
+int32 FMCPRequestScheduler::Execute(double FrameStartTime, TFunctionRef<void(const FMCPEndpointRequest&)> Handler, TFunctionRef<void(const FMCPEndpointRequest&)> OnExpired)
+{
+	const double BudgetEndTime = FrameStartTime + GetFrameBudgetSeconds();
+	int32 NumExecuted = 0;
+	bool bExecutedBudgeted = false;
+
+	for (int32 PriorityIndex = 0; PriorityIndex < static_cast<int32>(EMCPRequestPriority::Num); ++PriorityIndex)
+	{
+		const bool bBudgeted = PriorityIndex != static_cast<int32>(EMCPRequestPriority::High);
+		FMCPEndpointRequest Request;
+
+		for (;;)
+		{
+			const double Now = FPlatformTime::Seconds();
+			if (bBudgeted && bExecutedBudgeted && Now >= BudgetEndTime)
+			{
+				return NumExecuted;
+			}
+
+			if (!PopNext(Queues[PriorityIndex], Request))
+			{
+				break;
+			}
+
+			if (Request.Deadline > 0.0 && Now > Request.Deadline)
+			{
+				OnExpired(Request);
+				continue;
+			}
+
+			Handler(Request);
+			NumExecuted++;
+			bExecutedBudgeted |= bBudgeted;
+		}
+	}
+
+	return NumExecuted;
+}
+
+int32 FMCPRequestScheduler::Num() const
+{
+	int32 Total = 0;
+	for (int32 PriorityIndex = 0; PriorityIndex < static_cast<int32>(EMCPRequestPriority::Num); ++PriorityIndex)
+	{
+		Total += Num(static_cast<EMCPRequestPriority>(PriorityIndex));
+	}
+	return Total;
+}
+
+int32 FMCPRequestScheduler::Num(EMCPRequestPriority Priority) const
+{
+	int32 Total = 0;
+	for (const FConnectionQueue& ConnectionQueue : Queues[static_cast<int32>(Priority)].Connections)
+	{
+		Total += ConnectionQueue.NumPending();
+	}
+	return Total;
+}
+
+double FMCPRequestScheduler::GetFrameBudgetSeconds()
+{
+	return FMath::Max(CVarMCPEndpointFrameBudgetMs.GetValueOnGameThread(), 0.0f) / 1000.0;
+}
+
+EMCPRequestPriority FMCPRequestScheduler::GetRequestPriority(const FString& Type, const FJsonObject& Message)
+{
+	EMCPRequestPriority Priority = EMCPRequestPriority::Normal;
+	if (Type == TEXT("ping") || Type == TEXT("get_state") || Type == TEXT("subscribe") || Type == TEXT("unsubscribe"))
+	{
+		Priority = EMCPRequestPriority::High;
+	}
+	else if (Type == TEXT("execute") || Type == TEXT("execute_file"))
+	{
+		Priority = EMCPRequestPriority::Low;
+	}
+	FMCPNativeHandlerRegistry::Get().GetPriority(Type, Priority);
+
+	// 客户端只能降低优先级，例如把后台批量请求降为 low；
+	// high 不受帧预算限制，若允许提升，一个客户端就能让 execute 重新造成不受限的单帧卡顿
+	FString PriorityName;
+	if (Message.TryGetStringField(TEXT("priority"), PriorityName))
+	{
+		EMCPRequestPriority Requested = Priority;
+		if (PriorityName == TEXT("normal"))
+		{
+			Requested = EMCPRequestPriority::Normal;
+		}
+		else if (PriorityName == TEXT("low"))
+		{
+			Requested = EMCPRequestPriority::Low;
+		}
+		Priority = FMath::Max(Priority, Requested);
+	}
+	return Priority;
+}
+
+bool FMCPRequestScheduler::PopNext(FPriorityQueue& Queue, FMCPEndpointRequest& OutRequest)
+{
+	if (Queue.Connections.Num() == 0)
+	{
+		Queue.NextConnection = 0;
+		return false;
+	}
+
+	Queue.NextConnection %= Queue.Connections.Num();
+	FConnectionQueue& ConnectionQueue = Queue.Connections[Queue.NextConnection];
+	OutRequest = MoveTemp(ConnectionQueue.Requests[ConnectionQueue.Head++]);
+
+	if (ConnectionQueue.NumPending() == 0)
+	{
+		// 取空的连接原地移除，NextConnection 已指向其后的连接，不会跳过它
+		Queue.Connections.RemoveAt(Queue.NextConnection);
+		return true;
+	}
+
+	if (ConnectionQueue.Head * 2 >= ConnectionQueue.Requests.Num())
+	{
+		ConnectionQueue.Requests.RemoveAt(0, ConnectionQueue.Head);
+		ConnectionQueue.Head = 0;
+	}
+	Queue.NextConnection++;
+	return true;
+}
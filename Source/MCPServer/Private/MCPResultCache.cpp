@@ -0,0 +1,352 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPResultCache.h"
+
+#include "MCPServer.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Dom/JsonObject.h"
+#include "Editor.h"
+#include "GameplayTagsManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/TransactionObjectEvent.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+static TAutoConsoleVariable<int32> CVarMCPEndpointResultCacheSizeMB(
+	TEXT("MCP.Endpoint.ResultCacheSizeMB"),
+	16,
+	TEXT("Memory (MB) for caching results of read-only native requests (dump_object, get_property, ...). 0 disables the cache."),
+	ECVF_Default);
+
+namespace MCPResultCache
+{
+	/** 不影响结果的传输字段，不参与缓存键 */
+	static const TCHAR* const IgnoredFields[] =
+	{
+		TEXT("type"),
+		TEXT("id"),
+		TEXT("priority"),
+		TEXT("deadline_ms"),
+		TEXT("progress"),
+		TEXT("cache"),
+	};
+
+	void AppendQuoted(const FString& Text, FString& Out)
+	{
+		Out += TEXT('"');
+		Out += Text.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\""));
+		Out += TEXT('"');
+	}
+
+	void AppendCanonical(const TSharedPtr<FJsonValue>& Value, FString& Out);
+
+	void AppendCanonicalObject(const FJsonObject& Object, FString& Out, bool bTopLevel)
+	{
+		TArray<FString> Keys;
+		Object.Values.GetKeys(Keys);
+		Keys.Sort();
+
+		Out += TEXT('{');
+		bool bFirst = true;
+		for (const FString& Key : Keys)
+		{
+			if (bTopLevel)
+			{
+				bool bIgnored = false;
+				for (const TCHAR* Ignored : IgnoredFields)
+				{
+					bIgnored |= Key == Ignored;
+				}
+				if (bIgnored)
+				{
+					continue;
+				}
+			}
+
+			if (!bFirst)
+			{
+				Out += TEXT(',');
+			}
+			bFirst = false;
+			AppendQuoted(Key, Out);
+			Out += TEXT(':');
+			AppendCanonical(Object.Values[Key], Out);
+		}
+		Out += TEXT('}');
+	}
+
+	void AppendCanonical(const TSharedPtr<FJsonValue>& Value, FString& Out)
+	{
+		if (!Value.IsValid())
+		{
+			Out += TEXT("null");
+			return;
+		}
+
+		switch (Value->Type)
+		{
+		case EJson::String:
+			AppendQuoted(Value->AsString(), Out);
+			break;
+		case EJson::Number:
+			Out += FString::SanitizeFloat(Value->AsNumber());
+			break;
+		case EJson::Boolean:
+			Out += Value->AsBool() ? TEXT("true") : TEXT("false");
+			break;
+		case EJson::Array:
+		{
+			Out += TEXT('[');
+			bool bFirst = true;
+			for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+			{
+				if (!bFirst)
+				{
+					Out += TEXT(',');
+				}
+				bFirst = false;
+				AppendCanonical(Element, Out);
+			}
+			Out += TEXT(']');
+			break;
+		}
+		case EJson::Object:
+			AppendCanonicalObject(*Value->AsObject(), Out, false);
+			break;
+		default:
+			Out += TEXT("null");
+			break;
+		}
+	}
+
+	int64 EstimateBytes(const FString& Key, const TSharedRef<FJsonObject>& Result)
+	{
+		FString Serialized;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Serialized);
+		FJsonSerializer::Serialize(Result, Writer);
+		return static_cast<int64>(Key.Len() + Serialized.Len()) * sizeof(TCHAR);
+	}
+}
+
+FMCPResultCache& FMCPResultCache::Get()
+{
+	static FMCPResultCache Instance;
+	return Instance;
+}
+
+void FMCPResultCache::StartListening()
+{
+	if (bIsListening)
+	{
+		return;
+	}
+
+	ObjectTransactedHandle = FCoreUObjectDelegates::OnObjectTransacted.AddLambda([this](UObject*, const FTransactionObjectEvent&)
+	{
+		Invalidate();
+	});
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddLambda([this](UObject*, FPropertyChangedEvent&)
+	{
+		Invalidate();
+	});
+	PackageDirtyHandle = UPackage::PackageMarkedDirtyEvent.AddLambda([this](UPackage*, bool)
+	{
+		Invalidate();
+	});
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([this]()
+	{
+		Invalidate();
+	});
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddLambda([this](const FAssetData&)
+	{
+		Invalidate();
+	});
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddLambda([this](const FAssetData&)
+	{
+		Invalidate();
+	});
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddLambda([this](const FAssetData&, const FString&)
+	{
+		Invalidate();
+	});
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddLambda([this](const FAssetData&)
+	{
+		Invalidate();
+	});
+
+	if (GEditor)
+	{
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddLambda([this]()
+		{
+			Invalidate();
+		});
+	}
+	GameplayTagTreeHandle = UGameplayTagsManager::OnEditorRefreshGameplayTagTree.AddLambda([this]()
+	{
+		Invalidate();
+	});
+	BeginPIEHandle = FEditorDelegates::BeginPIE.AddLambda([this](const bool)
+	{
+		Invalidate();
+	});
+	EndPIEHandle = FEditorDelegates::EndPIE.AddLambda([this](const bool)
+	{
+		Invalidate();
+	});
+
+	bIsListening = true;
+}
+
+void FMCPResultCache::StopListening()
+{
+	if (!bIsListening)
+	{
+		return;
+	}
+
+	FCoreUObjectDelegates::OnObjectTransacted.Remove(ObjectTransactedHandle);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+	UPackage::PackageMarkedDirtyEvent.Remove(PackageDirtyHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+	}
+
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+	UGameplayTagsManager::OnEditorRefreshGameplayTagTree.Remove(GameplayTagTreeHandle);
+	FEditorDelegates::BeginPIE.Remove(BeginPIEHandle);
+	FEditorDelegates::EndPIE.Remove(EndPIEHandle);
+
+	bIsListening = false;
+	Entries.Empty();
+	TotalBytes = 0;
+}
+
+bool FMCPResultCache::IsEnabledFor(const FJsonObject& Request)
+{
+	// PIE 期间对象每帧都在变化，且大多不触发失效事件
+	if (GEditor && GEditor->PlayWorld)
+	{
+		return false;
+	}
+
+	bool bUseCache = true;
+	Request.TryGetBoolField(TEXT("cache"), bUseCache);
+	return bUseCache && CVarMCPEndpointResultCacheSizeMB.GetValueOnGameThread() > 0;
+}
+
+FString FMCPResultCache::MakeKey(const FString& Type, const FJsonObject& Request)
+{
+	FString Key = Type;
+	Key += TEXT('|');
+	MCPResultCache::AppendCanonicalObject(Request, Key, true);
+	return Key;
+}
+
+TSharedPtr<FJsonObject> FMCPResultCache::Find(const FString& Type, const FJsonObject& Request)
+{
+	if (!bIsListening || !IsEnabledFor(Request))
+	{
+		return nullptr;
+	}
+
+	FEntry* Entry = Entries.Find(MakeKey(Type, Request));
+	if (!Entry)
+	{
+		++Misses;
+		return nullptr;
+	}
+
+	++Hits;
+	Entry->LastAccess = ++AccessCounter;
+
+	// 浅拷贝：字段值共享，只替换 id
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>(*Entry->Result);
+	FString Id;
+	Request.TryGetStringField(TEXT("id"), Id);
+	Result->SetStringField(TEXT("id"), Id);
+	Result->SetBoolField(TEXT("cached"), true);
+	return Result;
+}
+
+void FMCPResultCache::Add(const FString& Type, const FJsonObject& Request, const TSharedRef<FJsonObject>& Result)
+{
+	bool bSuccess = false;
+	if (!bIsListening || !IsEnabledFor(Request) || !Result->TryGetBoolField(TEXT("success"), bSuccess) || !bSuccess)
+	{
+		return;
+	}
+
+	const int64 BudgetBytes = static_cast<int64>(CVarMCPEndpointResultCacheSizeMB.GetValueOnGameThread()) * 1024 * 1024;
+	FString Key = MakeKey(Type, Request);
+	const int64 Bytes = MCPResultCache::EstimateBytes(Key, Result);
+	if (Bytes > BudgetBytes / 4)
+	{
+		// 单个结果过大时不缓存，避免挤掉所有其他条目
+		return;
+	}
+
+	TSharedRef<FJsonObject> Stored = MakeShared<FJsonObject>(*Result);
+	Stored->RemoveField(TEXT("id"));
+
+	if (FEntry* Existing = Entries.Find(Key))
+	{
+		TotalBytes -= Existing->Bytes;
+	}
+
+	FEntry& Entry = Entries.Add(MoveTemp(Key));
+	Entry.Result = Stored;
+	Entry.Bytes = Bytes;
+	Entry.LastAccess = ++AccessCounter;
+	TotalBytes += Bytes;
+
+	EvictToBudget(BudgetBytes);
+}
+
+void FMCPResultCache::Invalidate()
+{
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	++Invalidations;
+	Entries.Reset();
+	TotalBytes = 0;
+}
+
+void FMCPResultCache::EvictToBudget(int64 BudgetBytes)
+{
+	while (TotalBytes > BudgetBytes && Entries.Num() > 0)
+	{
+		// 条目数量不多（受内存预算限制），线性查找最久未使用的即可
+		const FString* OldestKey = nullptr;
+		const FEntry* OldestEntry = nullptr;
+		for (const TPair<FString, FEntry>& Pair : Entries)
+		{
+			if (!OldestEntry || Pair.Value.LastAccess < OldestEntry->LastAccess)
+			{
+				OldestKey = &Pair.Key;
+				OldestEntry = &Pair.Value;
+			}
+		}
+		TotalBytes -= OldestEntry->Bytes;
+		Entries.Remove(FString(*OldestKey));
+	}
+}
@@ -2,12 +2,19 @@
 
 #include "MCPServer.h"
 #include "MCPTeachingSessionManager.h"
+#include "MCPSnapshotStore.h"
+#include "MCPPropertyIndex.h"
+#include "MCPEndpoint.h"
+#include "MCPHttpServer.h"
+#include "MCPNativeHandlers.h"
+#include "MCPResultCache.h"
 #include "Engine/Engine.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Editor/Transactor.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "Misc/ITransaction.h"
 #include "Misc/OutputDeviceHelper.h"
+#include "Misc/Paths.h"
 
 #define LOCTEXT_NAMESPACE "FMCPServerModule"
 
@@ -223,6 +230,8 @@ void FMCPServerModule::StartupModule()
 	// 创建日志捕获设备
 	LogCaptureDevice = MakeShared<FMCPLogCaptureDevice>();
 	TeachingSessionManager = MakeShared<FMCPTeachingSessionManager>();
+	FMCPNativeHandlerRegistry::Get().RegisterBuiltinHandlers();
+	FMCPResultCache::Get().StartListening();
 	
 	LogCaptureConsoleVariable = IConsoleManager::Get().RegisterConsoleVariable(
 		TEXT("MCP.LogCapture"),
@@ -259,13 +268,123 @@ void FMCPServerModule::StartupModule()
 		TEXT("Stop the current MCP teaching session"),
 		FConsoleCommandWithArgsDelegate::CreateStatic(&FMCPServerModule::StopTeachingConsoleCommand),
 		ECVF_Default);
+
+	IncrementalSnapshotConsoleVariable = IConsoleManager::Get().RegisterConsoleVariable(
+		TEXT("MCP.EnableIncrementalSnapshot"),
+		0,
+		TEXT("0: disable, 1: re-dump blueprints into Saved/MCP/PropertySnapshot.bin on save/compile"),
+		ECVF_Default);
+	IncrementalSnapshotConsoleVariable->SetOnChangedCallback(FConsoleVariableDelegate::CreateStatic(&FMCPServerModule::OnIncrementalSnapshotConsoleVariableChanged));
+
+	RebuildSnapshotCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("MCP.RebuildSnapshot"),
+		TEXT("Dump all blueprints under the given root path (default /Game) into the property snapshot"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FMCPServerModule::RebuildSnapshotConsoleCommand),
+		ECVF_Default);
+
+	CompactSnapshotCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("MCP.CompactSnapshot"),
+		TEXT("Rewrite the property snapshot file keeping only live records"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FMCPServerModule::CompactSnapshotConsoleCommand),
+		ECVF_Default);
+
+	StartEndpointCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("MCP.StartEndpoint"),
+		TEXT("Start the native MCP endpoint: MCP.StartEndpoint [Port=8100] [BindAddress=127.0.0.1]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FMCPServerModule::StartEndpointConsoleCommand),
+		ECVF_Default);
+
+	StopEndpointCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("MCP.StopEndpoint"),
+		TEXT("Stop the native MCP endpoint"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FMCPServerModule::StopEndpointConsoleCommand),
+		ECVF_Default);
+
+	EndpointStatsCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("MCP.EndpointStats"),
+		TEXT("Print per-message-type latency and throughput of the native MCP endpoint: MCP.EndpointStats [reset]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FMCPServerModule::EndpointStatsConsoleCommand),
+		ECVF_Default);
+
+	StartHttpServerCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("MCP.StartHttpServer"),
+		TEXT("Serve the MCP protocol (streamable HTTP) directly from the editor: MCP.StartHttpServer [Port=8101] [Path=/mcp] [BindAddress=127.0.0.1]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FMCPServerModule::StartHttpServerConsoleCommand),
+		ECVF_Default);
+
+	StopHttpServerCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("MCP.StopHttpServer"),
+		TEXT("Stop the native MCP HTTP server"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FMCPServerModule::StopHttpServerConsoleCommand),
+		ECVF_Default);
 	UE_LOG(LogMCPServer, Log, TEXT("MCP Server module started, log capture functionality available"));
 }
 
 void FMCPServerModule::ShutdownModule()
 {
 	EnableObjectPropertyChangeListener(false);
+	StopHttpServer();
+	StopEndpoint();
+	FMCPNativeHandlerRegistry::Get().Reset();
+	FMCPResultCache::Get().StopListening();
 	TeachingSessionManager.Reset();
+	{
+		FScopeLock Lock(&SnapshotMutex);
+		PropertyIndex.Reset();
+		if (SnapshotStore.IsValid())
+		{
+			SnapshotStore->StopListening();
+			SnapshotStore.Reset();
+		}
+	}
+
+	if (IncrementalSnapshotConsoleVariable)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(IncrementalSnapshotConsoleVariable);
+		IncrementalSnapshotConsoleVariable = nullptr;
+	}
+
+	if (RebuildSnapshotCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(RebuildSnapshotCommand);
+		RebuildSnapshotCommand = nullptr;
+	}
+
+	if (CompactSnapshotCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(CompactSnapshotCommand);
+		CompactSnapshotCommand = nullptr;
+	}
+
+	if (StartEndpointCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(StartEndpointCommand);
+		StartEndpointCommand = nullptr;
+	}
+
+	if (StopEndpointCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(StopEndpointCommand);
+		StopEndpointCommand = nullptr;
+	}
+
+	if (EndpointStatsCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(EndpointStatsCommand);
+		EndpointStatsCommand = nullptr;
+	}
+
+	if (StartHttpServerCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(StartHttpServerCommand);
+		StartHttpServerCommand = nullptr;
+	}
+
+	if (StopHttpServerCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(StopHttpServerCommand);
+		StopHttpServerCommand = nullptr;
+	}
 	if (PropertyChangeListenerConsoleVariable)
 	{
 		IConsoleManager::Get().UnregisterConsoleObject(PropertyChangeListenerConsoleVariable);
@@ -534,6 +653,204 @@ void FMCPServerModule::RecordTeachingEvent(FName EventName, const FString& Paylo
 	}
 }
 
+TSharedPtr<FMCPSnapshotStore> FMCPServerModule::GetSnapshotStore()
+{
+	FScopeLock Lock(&SnapshotMutex);
+	if (!SnapshotStore.IsValid())
+	{
+		SnapshotStore = MakeShared<FMCPSnapshotStore>();
+		SnapshotStore->Initialize(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("MCP"), TEXT("PropertySnapshot.bin")));
+	}
+	return SnapshotStore;
+}
+
+TSharedPtr<FMCPPropertyIndex> FMCPServerModule::GetPropertyIndex()
+{
+	// FCriticalSection 可重入，下面的 GetSnapshotStore 会再次加锁
+	FScopeLock Lock(&SnapshotMutex);
+	if (!PropertyIndex.IsValid())
+	{
+		// 首次查询时从快照全量构建，之后随快照增量更新；并发的首次查询等待同一次构建
+		PropertyIndex = MakeShared<FMCPPropertyIndex>();
+		PropertyIndex->Initialize(GetSnapshotStore().ToSharedRef());
+		PropertyIndex->Rebuild();
+	}
+	return PropertyIndex;
+}
+
+void FMCPServerModule::EnableIncrementalSnapshot(bool bEnable)
+{
+	if (bEnable)
+	{
+		GetSnapshotStore()->StartListening();
+	}
+	else if (SnapshotStore.IsValid())
+	{
+		SnapshotStore->StopListening();
+	}
+}
+
+void FMCPServerModule::OnIncrementalSnapshotConsoleVariableChanged(IConsoleVariable* Var)
+{
+	if (Var)
+	{
+		if (FMCPServerModule* MCPModule = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+		{
+			MCPModule->EnableIncrementalSnapshot(Var->GetInt() != 0);
+		}
+	}
+}
+
+void FMCPServerModule::RebuildSnapshotConsoleCommand(const TArray<FString>& Args)
+{
+	if (FMCPServerModule* Module = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+	{
+		const FString RootPath = Args.Num() > 0 ? Args[0] : TEXT("/Game");
+		Module->GetSnapshotStore()->RebuildAll(RootPath);
+	}
+}
+
+void FMCPServerModule::CompactSnapshotConsoleCommand(const TArray<FString>& Args)
+{
+	if (FMCPServerModule* Module = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+	{
+		Module->GetSnapshotStore()->Compact();
+	}
+}
+
+bool FMCPServerModule::StartEndpoint(const FString& BindAddress, int32 Port)
+{
+	if (Endpoint.IsValid() && Endpoint->IsRunning())
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("MCP endpoint already running on port %d"), Endpoint->GetPort());
+		return Endpoint->GetPort() == Port;
+	}
+
+	Endpoint = MakeShared<FMCPEndpoint>();
+	if (!Endpoint->Listen(BindAddress, Port))
+	{
+		Endpoint.Reset();
+		return false;
+	}
+	return true;
+}
+
+void FMCPServerModule::StopEndpoint()
+{
+	if (Endpoint.IsValid())
+	{
+		Endpoint->Shutdown();
+		Endpoint.Reset();
+	}
+}
+
+void FMCPServerModule::StartEndpointConsoleCommand(const TArray<FString>& Args)
+{
+	if (FMCPServerModule* Module = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+	{
+		const int32 Port = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 8100;
+		const FString BindAddress = Args.Num() > 1 ? Args[1] : TEXT("127.0.0.1");
+		Module->StartEndpoint(BindAddress, Port);
+	}
+}
+
+void FMCPServerModule::StopEndpointConsoleCommand(const TArray<FString>& Args)
+{
+	if (FMCPServerModule* Module = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+	{
+		Module->StopEndpoint();
+	}
+}
+
+void FMCPServerModule::EndpointStatsConsoleCommand(const TArray<FString>& Args)
+{
+	FMCPServerModule* Module = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer");
+	TSharedPtr<FMCPEndpoint> ActiveEndpoint = Module ? Module->GetEndpoint() : nullptr;
+	TSharedPtr<FMCPHttpServer> ActiveHttpServer = Module ? Module->GetHttpServer() : nullptr;
+	if (!ActiveEndpoint.IsValid() && !ActiveHttpServer.IsValid())
+	{
+		UE_LOG(LogMCPServer, Display, TEXT("MCP endpoint is not running"));
+		return;
+	}
+
+	const bool bReset = Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase);
+	TArray<FMCPEndpointMetrics*> AllMetrics;
+	if (ActiveEndpoint.IsValid())
+	{
+		AllMetrics.Add(&ActiveEndpoint->GetMetrics());
+	}
+	if (ActiveHttpServer.IsValid())
+	{
+		UE_LOG(LogMCPServer, Display, TEXT("MCP HTTP server on port %d:"), ActiveHttpServer->GetPort());
+		AllMetrics.Add(&ActiveHttpServer->GetMetrics());
+	}
+	for (FMCPEndpointMetrics* Metrics : AllMetrics)
+	{
+		for (const FString& Line : Metrics->ToLines())
+		{
+			UE_LOG(LogMCPServer, Display, TEXT("%s"), *Line);
+		}
+	}
+
+	const FMCPResultCache& Cache = FMCPResultCache::Get();
+	UE_LOG(LogMCPServer, Display, TEXT("Result cache: %d entries, %lld bytes, %llu hits, %llu misses, %llu invalidations"),
+		Cache.Num(), Cache.GetTotalBytes(), Cache.GetHits(), Cache.GetMisses(), Cache.GetInvalidations());
+
+	if (bReset)
+	{
+		for (FMCPEndpointMetrics* Metrics : AllMetrics)
+		{
+			Metrics->Reset();
+		}
+		UE_LOG(LogMCPServer, Display, TEXT("MCP endpoint stats reset"));
+	}
+}
+
+bool FMCPServerModule::StartHttpServer(int32 Port, const FString& Path, const FString& BindAddress)
+{
+	if (HttpServer.IsValid() && HttpServer->IsRunning())
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("MCP HTTP server already running on port %d"), HttpServer->GetPort());
+		return HttpServer->GetPort() == Port && HttpServer->GetPath() == Path;
+	}
+
+	HttpServer = MakeShared<FMCPHttpServer>();
+	if (!HttpServer->Start(Port, Path, BindAddress))
+	{
+		HttpServer.Reset();
+		return false;
+	}
+	return true;
+}
+
+void FMCPServerModule::StopHttpServer()
+{
+	if (HttpServer.IsValid())
+	{
+		HttpServer->Stop();
+		HttpServer.Reset();
+	}
+}
+
+void FMCPServerModule::StartHttpServerConsoleCommand(const TArray<FString>& Args)
+{
+	if (FMCPServerModule* Module = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+	{
+		const int32 Port = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 8101;
+		const FString Path = Args.Num() > 1 ? Args[1] : TEXT("/mcp");
+		const FString BindAddress = Args.Num() > 2 ? Args[2] : TEXT("127.0.0.1");
+		Module->StartHttpServer(Port, Path, BindAddress);
+	}
+}
+
+void FMCPServerModule::StopHttpServerConsoleCommand(const TArray<FString>& Args)
+{
+	if (FMCPServerModule* Module = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+	{
+		Module->StopHttpServer();
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
 	
 IMPLEMENT_MODULE(FMCPServerModule, MCPServer)
\ No newline at end of file
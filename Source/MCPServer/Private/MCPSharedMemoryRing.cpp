@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPSharedMemoryRing.h"
+
+#include "MCPServer.h"
+#include "HAL/PlatformAtomics.h"
+
+namespace MCPSharedMemoryRing
+{
+	constexpr int32 CapacityOffset = 8;
+	constexpr int32 WritePosOffset = 16;
+	constexpr int32 ReadPosOffset = 24;
+}
+
+FMCPSharedMemoryRing::~FMCPSharedMemoryRing()
+{
+	if (Region)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+		Region = nullptr;
+	}
+}
+
+TUniquePtr<FMCPSharedMemoryRing> FMCPSharedMemoryRing::Create(const FString& Name, int32 Capacity)
+{
+	if (Capacity <= 0)
+	{
+		return nullptr;
+	}
+
+	const uint32 AccessMode = static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Read) | static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Write);
+	FPlatformMemory::FSharedMemoryRegion* Region = FPlatformMemory::MapNamedSharedMemoryRegion(Name, true, AccessMode, HeaderSize + Capacity);
+	if (!Region)
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("MCP endpoint: failed to create shared memory region %s (%d bytes)"), *Name, HeaderSize + Capacity);
+		return nullptr;
+	}
+
+	TUniquePtr<FMCPSharedMemoryRing> Ring(new FMCPSharedMemoryRing());
+	Ring->Region = Region;
+	Ring->Header = static_cast<uint8*>(Region->GetAddress());
+	Ring->Data = Ring->Header + HeaderSize;
+	Ring->Capacity = Capacity;
+	Ring->Name = Name;
+
+	FMemory::Memzero(Ring->Header, HeaderSize);
+	FMemory::Memcpy(Ring->Header, &Magic, sizeof(Magic));
+	FMemory::Memcpy(Ring->Header + 4, &Version, sizeof(Version));
+	FMemory::Memcpy(Ring->Header + MCPSharedMemoryRing::CapacityOffset, &Ring->Capacity, sizeof(Ring->Capacity));
+	FPlatformMisc::MemoryBarrier();
+	return Ring;
+}
+
+bool FMCPSharedMemoryRing::Write(const uint8* InData, int32 Size)
+{
+	const uint64 ReadPos = static_cast<uint64>(FPlatformAtomics::AtomicRead(reinterpret_cast<volatile const int64*>(Header + MCPSharedMemoryRing::ReadPosOffset)));
+	if (ReadPos > WritePos || WritePos - ReadPos > Capacity)
+	{
+		// 客户端写坏了读位置，不再使用共享内存
+		return false;
+	}
+
+	if (Size <= 0 || Capacity - (WritePos - ReadPos) < static_cast<uint64>(Size))
+	{
+		return false;
+	}
+
+	const uint64 Offset = WritePos % Capacity;
+	const int32 FirstPart = static_cast<int32>(FMath::Min<uint64>(Size, Capacity - Offset));
+	FMemory::Memcpy(Data + Offset, InData, FirstPart);
+	if (FirstPart < Size)
+	{
+		FMemory::Memcpy(Data, InData + FirstPart, Size - FirstPart);
+	}
+
+	// 数据写完后再发布写位置
+	WritePos += Size;
+	FPlatformAtomics::AtomicStore(reinterpret_cast<volatile int64*>(Header + MCPSharedMemoryRing::WritePosOffset), static_cast<int64>(WritePos));
+	return true;
+}
+
+FString FMCPSharedMemoryRing::GetClientName() const
+{
+#if PLATFORM_WINDOWS
+	// Windows 平台映射时加了 Global\ 前缀
+	return FString(TEXT("Global\\")) + Name;
+#else
+	// POSIX 平台映射为 shm_open("/" + Name)，客户端（multiprocessing.shared_memory）同样会补上前导斜杠
+	return Name;
+#endif
+}
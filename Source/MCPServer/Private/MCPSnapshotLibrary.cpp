@@ -0,0 +1,49 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPSnapshotLibrary.h"
+#include "MCPServer.h"
+#include "MCPSnapshotStore.h"
+
+namespace
+{
+	TSharedPtr<FMCPSnapshotStore> GetSnapshotStore()
+	{
+		if (FMCPServerModule* MCPModule = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+		{
+			return MCPModule->GetSnapshotStore();
+		}
+		return nullptr;
+	}
+}
+
+void UMCPSnapshotLibrary::EnableIncrementalSnapshot(bool bEnable)
+{
+	if (FMCPServerModule* MCPModule = FModuleManager::GetModulePtr<FMCPServerModule>("MCPServer"))
+	{
+		MCPModule->EnableIncrementalSnapshot(bEnable);
+	}
+}
+
+int32 UMCPSnapshotLibrary::RebuildSnapshot(const FString& RootPath)
+{
+	TSharedPtr<FMCPSnapshotStore> SnapshotStore = GetSnapshotStore();
+	return SnapshotStore.IsValid() ? SnapshotStore->RebuildAll(RootPath) : 0;
+}
+
+bool UMCPSnapshotLibrary::ReadAssetSnapshot(const FString& PackagePath, FString& OutDump)
+{
+	TSharedPtr<FMCPSnapshotStore> SnapshotStore = GetSnapshotStore();
+	return SnapshotStore.IsValid() && SnapshotStore->ReadSnapshot(PackagePath, OutDump);
+}
+
+TArray<FString> UMCPSnapshotLibrary::GetSnapshotAssetPaths()
+{
+	TSharedPtr<FMCPSnapshotStore> SnapshotStore = GetSnapshotStore();
+	return SnapshotStore.IsValid() ? SnapshotStore->GetAssetPaths() : TArray<FString>();
+}
+
+bool UMCPSnapshotLibrary::CompactSnapshot()
+{
+	TSharedPtr<FMCPSnapshotStore> SnapshotStore = GetSnapshotStore();
+	return SnapshotStore.IsValid() && SnapshotStore->Compact();
+}
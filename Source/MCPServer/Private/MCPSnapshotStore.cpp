@@ -0,0 +1,581 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPSnapshotStore.h"
+
+#include "MCPObjectInformDumpLibrary.h"
+#include "MCPServer.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Editor.h"
+#include "Engine/Blueprint.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeRWLock.h"
+#include "Serialization/MemoryWriter.h"
+#include "TimerManager.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+namespace
+{
+	/** 每条记录的起始魔数，用于加载时识别被截断/损坏的尾部 */
+	constexpr uint32 SnapshotRecordMagic = 0x5350434D; // "MCPS"
+
+	/** 序列化记录头，正文紧随其后 */
+	TArray<uint8> MakeRecordHeader(EMCPSnapshotRecordType Type, const FDateTime& Timestamp, const FString& AssetPath, int32 BodySize)
+	{
+		TArray<uint8> Header;
+		FMemoryWriter Writer(Header);
+		uint32 Magic = SnapshotRecordMagic;
+		uint8 TypeValue = static_cast<uint8>(Type);
+		int64 Ticks = Timestamp.GetTicks();
+		FString Path = AssetPath;
+		Writer << Magic;
+		Writer << TypeValue;
+		Writer << Ticks;
+		Writer << Path;
+		Writer << BodySize;
+		return Header;
+	}
+
+	/** 只有项目资产参与快照，跳过 /Temp、/Engine 等临时或引擎包 */
+	bool ShouldSnapshotPackage(const FString& PackageName)
+	{
+		return PackageName.StartsWith(TEXT("/Game/"));
+	}
+}
+
+FMCPSnapshotStore::FMCPSnapshotStore()
+{
+}
+
+FMCPSnapshotStore::~FMCPSnapshotStore()
+{
+	StopListening();
+}
+
+void FMCPSnapshotStore::Initialize(const FString& InSnapshotFilePath)
+{
+	SnapshotFilePath = InSnapshotFilePath;
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(SnapshotFilePath), true);
+	LoadIndex();
+}
+
+void FMCPSnapshotStore::LoadIndex()
+{
+	bool bTruncatedTail = false;
+	{
+		FWriteScopeLock WriteLock(IndexLock);
+		bTruncatedTail = LoadIndexLocked();
+	}
+
+	if (bTruncatedTail)
+	{
+		Compact();
+	}
+}
+
+bool FMCPSnapshotStore::LoadIndexLocked()
+{
+	Index.Reset();
+	DeadRecordCount = 0;
+	ValidFileSize = 0;
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*SnapshotFilePath));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	const int64 TotalSize = Reader->TotalSize();
+	while (Reader->Tell() < TotalSize)
+	{
+		uint32 Magic = 0;
+		uint8 TypeValue = 0;
+		int64 Ticks = 0;
+		FString AssetPath;
+		int32 BodySize = 0;
+
+		*Reader << Magic;
+		if (Magic != SnapshotRecordMagic)
+		{
+			break;
+		}
+		*Reader << TypeValue;
+		*Reader << Ticks;
+		*Reader << AssetPath;
+		*Reader << BodySize;
+
+		const int64 BodyOffset = Reader->Tell();
+		if (Reader->IsError() || BodySize < 0 || BodyOffset + BodySize > TotalSize)
+		{
+			break;
+		}
+		Reader->Seek(BodyOffset + BodySize);
+
+		// 同一资产的旧记录以及墓碑本身都是失效记录
+		if (Index.Remove(AssetPath) > 0)
+		{
+			++DeadRecordCount;
+		}
+
+		if (static_cast<EMCPSnapshotRecordType>(TypeValue) == EMCPSnapshotRecordType::Put)
+		{
+			FMCPSnapshotEntry& Entry = Index.Add(AssetPath);
+			Entry.BodyOffset = BodyOffset;
+			Entry.BodySize = BodySize;
+			Entry.Timestamp = FDateTime(Ticks);
+		}
+		else
+		{
+			++DeadRecordCount;
+		}
+
+		ValidFileSize = BodyOffset + BodySize;
+	}
+
+	UE_LOG(LogMCPServer, Log, TEXT("Snapshot index loaded: %d live, %d dead records (%s)"), Index.Num(), DeadRecordCount, *SnapshotFilePath);
+
+	if (ValidFileSize < TotalSize)
+	{
+		UE_LOG(LogMCPServer, Warning, TEXT("Snapshot file has a truncated tail at %lld/%lld bytes, compacting"), ValidFileSize, TotalSize);
+		return true;
+	}
+	return false;
+}
+
+void FMCPSnapshotStore::StartListening()
+{
+	if (bIsListening || !GEditor)
+	{
+		return;
+	}
+
+#if ENGINE_MAJOR_VERSION >= 5
+	PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddSP(this, &FMCPSnapshotStore::HandlePackageSaved);
+#else
+	PackageSavedHandle = UPackage::PackageSavedEvent.AddSP(this, &FMCPSnapshotStore::HandlePackageSaved);
+#endif
+	BlueprintPreCompileHandle = GEditor->OnBlueprintPreCompile().AddSP(this, &FMCPSnapshotStore::HandleBlueprintPreCompile);
+	BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddSP(this, &FMCPSnapshotStore::HandleBlueprintCompiled);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddSP(this, &FMCPSnapshotStore::HandleAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddSP(this, &FMCPSnapshotStore::HandleAssetRenamed);
+
+	bIsListening = true;
+	UE_LOG(LogMCPServer, Log, TEXT("Incremental snapshot listening started"));
+}
+
+void FMCPSnapshotStore::StopListening()
+{
+	if (!bIsListening)
+	{
+		return;
+	}
+
+#if ENGINE_MAJOR_VERSION >= 5
+	UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+#else
+	UPackage::PackageSavedEvent.Remove(PackageSavedHandle);
+#endif
+	if (GEditor)
+	{
+		GEditor->OnBlueprintPreCompile().Remove(BlueprintPreCompileHandle);
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		AssetRegistryModule->Get().OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistryModule->Get().OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+
+	PackageSavedHandle.Reset();
+	BlueprintPreCompileHandle.Reset();
+	BlueprintCompiledHandle.Reset();
+	AssetRemovedHandle.Reset();
+	AssetRenamedHandle.Reset();
+
+	// 尚未落盘的资产直接丢弃，下次开启时由 RebuildAll 补齐
+	PendingAssets.Reset();
+	bIsListening = false;
+	UE_LOG(LogMCPServer, Log, TEXT("Incremental snapshot listening stopped"));
+}
+
+int32 FMCPSnapshotStore::RebuildAll(const FString& RootPath)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FARFilter Filter;
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1)
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+#else
+	Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+#endif
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths.Add(FName(*RootPath));
+	Filter.bRecursivePaths = true;
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	TSet<FString> ExistingAssets;
+	int32 UpdatedCount = 0;
+	for (const FAssetData& AssetData : Assets)
+	{
+		const FString PackageName = AssetData.PackageName.ToString();
+		ExistingAssets.Add(PackageName);
+		if (UpdateAsset(PackageName))
+		{
+			++UpdatedCount;
+		}
+	}
+
+	// 清理快照中已不存在的资产；按路径段匹配，"/Game" 不应匹配 "/GameData/..."
+	const FString RootPrefix = RootPath.EndsWith(TEXT("/")) ? RootPath : RootPath + TEXT("/");
+	for (const FString& AssetPath : GetAssetPaths())
+	{
+		const bool bUnderRoot = AssetPath.StartsWith(RootPrefix) || AssetPath == RootPath;
+		if (bUnderRoot && !ExistingAssets.Contains(AssetPath))
+		{
+			RemoveAsset(AssetPath);
+		}
+	}
+
+	UE_LOG(LogMCPServer, Log, TEXT("Snapshot rebuilt under %s: %d/%d blueprints dumped"), *RootPath, UpdatedCount, Assets.Num());
+	CompactIfNeeded();
+	return UpdatedCount;
+}
+
+bool FMCPSnapshotStore::UpdateAsset(const FString& AssetPath)
+{
+	const FString Dump = UMCPObjectInformDumpLibrary::DumpBlueprintProperties(AssetPath);
+	if (Dump.StartsWith(TEXT("Error:")))
+	{
+		UE_LOG(LogMCPServer, Verbose, TEXT("Snapshot skipped %s: %s"), *AssetPath, *Dump);
+		return false;
+	}
+
+	if (!AppendRecord(EMCPSnapshotRecordType::Put, AssetPath, Dump))
+	{
+		return false;
+	}
+
+	SnapshotUpdatedEvent.Broadcast(AssetPath, false);
+	return true;
+}
+
+void FMCPSnapshotStore::RemoveAsset(const FString& AssetPath)
+{
+	{
+		FReadScopeLock ReadLock(IndexLock);
+		if (!Index.Contains(AssetPath))
+		{
+			return;
+		}
+	}
+
+	if (AppendRecord(EMCPSnapshotRecordType::Tombstone, AssetPath, FString()))
+	{
+		SnapshotUpdatedEvent.Broadcast(AssetPath, true);
+	}
+}
+
+bool FMCPSnapshotStore::AppendRecord(EMCPSnapshotRecordType Type, const FString& AssetPath, const FString& Body)
+{
+	FTCHARToUTF8 BodyUtf8(*Body);
+	const FDateTime Now = FDateTime::UtcNow();
+	const TArray<uint8> Header = MakeRecordHeader(Type, Now, AssetPath, BodyUtf8.Length());
+
+	FWriteScopeLock WriteLock(IndexLock);
+
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*SnapshotFilePath, true, true));
+	if (!File)
+	{
+		UE_LOG(LogMCPServer, Error, TEXT("Failed to open snapshot file for append: %s"), *SnapshotFilePath);
+		return false;
+	}
+
+	// 追加总是写到文件末尾；末尾若有截断的记录（压缩失败或之前的追加只写了一部分），
+	// 先截到最后一条完整记录，否则索引中的偏移与实际位置不符，重新加载时也会在截断处停止
+	if (File->Size() != ValidFileSize && !File->Truncate(ValidFileSize))
+	{
+		UE_LOG(LogMCPServer, Error, TEXT("Failed to truncate snapshot file to %lld bytes: %s"), ValidFileSize, *SnapshotFilePath);
+		return false;
+	}
+
+	const int64 ExpectedSize = ValidFileSize + Header.Num() + BodyUtf8.Length();
+	const bool bSuccess = File->Write(Header.GetData(), Header.Num())
+		&& File->Write(reinterpret_cast<const uint8*>(BodyUtf8.Get()), BodyUtf8.Length())
+		&& File->Flush()
+		&& File->Size() == ExpectedSize;
+	if (!bSuccess)
+	{
+		// 丢弃写了一部分的记录，下次追加仍从最后一条完整记录之后开始
+		File->Truncate(ValidFileSize);
+		UE_LOG(LogMCPServer, Error, TEXT("Failed to append snapshot record for %s"), *AssetPath);
+		return false;
+	}
+
+	const int64 BodyOffset = ValidFileSize + Header.Num();
+	ValidFileSize = ExpectedSize;
+
+	if (Index.Remove(AssetPath) > 0)
+	{
+		++DeadRecordCount;
+	}
+
+	if (Type == EMCPSnapshotRecordType::Put)
+	{
+		FMCPSnapshotEntry& Entry = Index.Add(AssetPath);
+		Entry.BodyOffset = BodyOffset;
+		Entry.BodySize = BodyUtf8.Length();
+		Entry.Timestamp = Now;
+	}
+	else
+	{
+		++DeadRecordCount;
+	}
+
+	return true;
+}
+
+bool FMCPSnapshotStore::ReadSnapshot(const FString& AssetPath, FString& OutDump) const
+{
+	FReadScopeLock ReadLock(IndexLock);
+
+	const FMCPSnapshotEntry* Entry = Index.Find(AssetPath);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*SnapshotFilePath, FILEREAD_AllowWrite));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	TArray<uint8> Body;
+	Body.SetNumUninitialized(Entry->BodySize);
+	Reader->Seek(Entry->BodyOffset);
+	Reader->Serialize(Body.GetData(), Body.Num());
+	if (Reader->IsError())
+	{
+		return false;
+	}
+
+	FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Body.GetData()), Body.Num());
+	OutDump = FString(Converted.Length(), Converted.Get());
+	return true;
+}
+
+TArray<FString> FMCPSnapshotStore::GetAssetPaths() const
+{
+	FReadScopeLock ReadLock(IndexLock);
+
+	TArray<FString> AssetPaths;
+	Index.GetKeys(AssetPaths);
+	AssetPaths.Sort();
+	return AssetPaths;
+}
+
+int32 FMCPSnapshotStore::GetLiveRecordCount() const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	return Index.Num();
+}
+
+int32 FMCPSnapshotStore::GetDeadRecordCount() const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	return DeadRecordCount;
+}
+
+void FMCPSnapshotStore::CompactIfNeeded()
+{
+	bool bShouldCompact = false;
+	{
+		FReadScopeLock ReadLock(IndexLock);
+		bShouldCompact = DeadRecordCount >= CompactionMinDeadRecords && DeadRecordCount > Index.Num();
+	}
+
+	if (bShouldCompact)
+	{
+		Compact();
+	}
+}
+
+bool FMCPSnapshotStore::Compact()
+{
+	FWriteScopeLock WriteLock(IndexLock);
+
+	const FString TempFilePath = SnapshotFilePath + TEXT(".compact");
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*SnapshotFilePath));
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilePath));
+	if (!Writer)
+	{
+		UE_LOG(LogMCPServer, Error, TEXT("Snapshot compaction failed: cannot create %s"), *TempFilePath);
+		return false;
+	}
+
+	TMap<FString, FMCPSnapshotEntry> NewIndex;
+	NewIndex.Reserve(Index.Num());
+	TArray<uint8> Body;
+	int64 WriteOffset = 0;
+
+	for (const TPair<FString, FMCPSnapshotEntry>& Pair : Index)
+	{
+		if (!Reader)
+		{
+			break;
+		}
+
+		Body.SetNumUninitialized(Pair.Value.BodySize);
+		Reader->Seek(Pair.Value.BodyOffset);
+		Reader->Serialize(Body.GetData(), Body.Num());
+		if (Reader->IsError())
+		{
+			UE_LOG(LogMCPServer, Warning, TEXT("Snapshot compaction dropped unreadable record: %s"), *Pair.Key);
+			continue;
+		}
+
+		const TArray<uint8> Header = MakeRecordHeader(EMCPSnapshotRecordType::Put, Pair.Value.Timestamp, Pair.Key, Body.Num());
+		Writer->Serialize(const_cast<uint8*>(Header.GetData()), Header.Num());
+		Writer->Serialize(Body.GetData(), Body.Num());
+
+		FMCPSnapshotEntry& Entry = NewIndex.Add(Pair.Key, Pair.Value);
+		Entry.BodyOffset = WriteOffset + Header.Num();
+		WriteOffset = Entry.BodyOffset + Body.Num();
+	}
+
+	Reader.Reset();
+	if (!Writer->Close())
+	{
+		IFileManager::Get().Delete(*TempFilePath);
+		UE_LOG(LogMCPServer, Error, TEXT("Snapshot compaction failed while writing %s"), *TempFilePath);
+		return false;
+	}
+	Writer.Reset();
+
+	if (!IFileManager::Get().Move(*SnapshotFilePath, *TempFilePath, true, true))
+	{
+		IFileManager::Get().Delete(*TempFilePath);
+		UE_LOG(LogMCPServer, Error, TEXT("Snapshot compaction failed: cannot replace %s"), *SnapshotFilePath);
+		return false;
+	}
+
+	UE_LOG(LogMCPServer, Log, TEXT("Snapshot compacted: %d live records, %d dead records dropped, %lld -> %lld bytes"),
+		NewIndex.Num(), DeadRecordCount, ValidFileSize, WriteOffset);
+
+	Index = MoveTemp(NewIndex);
+	DeadRecordCount = 0;
+	ValidFileSize = WriteOffset;
+	return true;
+}
+
+void FMCPSnapshotStore::QueueAsset(const FString& AssetPath)
+{
+	if (!ShouldSnapshotPackage(AssetPath))
+	{
+		return;
+	}
+
+	PendingAssets.Add(AssetPath);
+
+	if (!bFlushScheduled && GEditor)
+	{
+		bFlushScheduled = true;
+		GEditor->GetTimerManager()->SetTimerForNextTick(FTimerDelegate::CreateSP(this, &FMCPSnapshotStore::FlushPendingAssets));
+	}
+}
+
+void FMCPSnapshotStore::FlushPendingAssets()
+{
+	bFlushScheduled = false;
+	if (!bIsListening || PendingAssets.Num() == 0)
+	{
+		return;
+	}
+
+	TSet<FString> AssetsToUpdate = MoveTemp(PendingAssets);
+	PendingAssets.Reset();
+
+	for (const FString& AssetPath : AssetsToUpdate)
+	{
+		UpdateAsset(AssetPath);
+	}
+
+	UE_LOG(LogMCPServer, Verbose, TEXT("Snapshot incrementally updated %d assets"), AssetsToUpdate.Num());
+	CompactIfNeeded();
+}
+
+#if ENGINE_MAJOR_VERSION >= 5
+void FMCPSnapshotStore::HandlePackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext ObjectSaveContext)
+{
+	if (ObjectSaveContext.IsProceduralSave())
+	{
+		return;
+	}
+#else
+void FMCPSnapshotStore::HandlePackageSaved(const FString& PackageFileName, UObject* PackageObject)
+{
+	UPackage* Package = Cast<UPackage>(PackageObject);
+#endif
+	if (!Package || !ShouldSnapshotPackage(Package->GetName()))
+	{
+		return;
+	}
+
+	bool bHasBlueprint = false;
+	ForEachObjectWithPackage(Package, [&bHasBlueprint](UObject* Object)
+	{
+		bHasBlueprint = Object->IsA<UBlueprint>();
+		return !bHasBlueprint;
+	}, false);
+
+	if (bHasBlueprint)
+	{
+		QueueAsset(Package->GetName());
+	}
+}
+
+void FMCPSnapshotStore::HandleBlueprintPreCompile(UBlueprint* Blueprint)
+{
+	if (Blueprint && Blueprint->GetOutermost() && ShouldSnapshotPackage(Blueprint->GetOutermost()->GetName()))
+	{
+		// 编译完成前 CDO 尚未更新，先记录下来，等 OnBlueprintCompiled 后的下一帧再 dump
+		PendingAssets.Add(Blueprint->GetOutermost()->GetName());
+	}
+}
+
+void FMCPSnapshotStore::HandleBlueprintCompiled()
+{
+	TArray<FString> CompiledAssets = PendingAssets.Array();
+	for (const FString& AssetPath : CompiledAssets)
+	{
+		QueueAsset(AssetPath);
+	}
+}
+
+void FMCPSnapshotStore::HandleAssetRemoved(const FAssetData& AssetData)
+{
+	const FString PackageName = AssetData.PackageName.ToString();
+	PendingAssets.Remove(PackageName);
+	RemoveAsset(PackageName);
+}
+
+void FMCPSnapshotStore::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	const FString OldPackageName = FPackageName::ObjectPathToPackageName(OldObjectPath);
+	PendingAssets.Remove(OldPackageName);
+	RemoveAsset(OldPackageName);
+
+	const UClass* AssetClass = AssetData.GetClass();
+	if (AssetClass && AssetClass->IsChildOf(UBlueprint::StaticClass()))
+	{
+		QueueAsset(AssetData.PackageName.ToString());
+	}
+}
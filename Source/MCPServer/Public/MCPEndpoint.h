@@ -0,0 +1,334 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "MCPEndpointMetrics.h"
+#include "MCPEventHub.h"
+#include "MCPRequestScheduler.h"
+#include "Templates/SharedPointer.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include <atomic>
+
+class FSocket;
+class FRunnableThread;
+class FJsonObject;
+class FMCPSharedMemoryRing;
+struct FMCPBlueprintDump;
+struct FMCPTableDump;
+
+/**
+ * 编辑器内的原生转发端点，替代 MCPForwarder.py 的 tick 轮询 socket。
+ *
+ * 协议与 MCPForwarder.py 相同：4 字节大端序长度 + UTF-8 JSON 消息体，编码、压缩和共享内存传输可在 hello 中协商。
+ * 独立 I/O 线程负责 accept/recv/send 和消息解析，ping/heartbeat/metrics/cancel 直接在 I/O 线程应答；
+ * 其余请求经无锁队列交给游戏线程，由 FMCPRequestScheduler 按优先级和帧预算执行，线程安全的只读请求交给工作线程。
+ * get_state、dump_stream、batch、subscribe 及 FMCPNativeHandlerRegistry 中注册的类型由 C++ 处理，
+ * execute 等请求转交 mcp_server.MCPEndpointBridge 在 Python 中执行。
+ */
+class MCPSERVER_API FMCPEndpoint : public FRunnable, public TSharedFromThis<FMCPEndpoint>
+{
+public:
+	FMCPEndpoint();
+	virtual ~FMCPEndpoint();
+
+	/** 开始监听并启动 I/O 线程 */
+	bool Listen(const FString& BindAddress, int32 Port);
+
+	/** 停止 I/O 线程并关闭所有 socket */
+	void Shutdown();
+
+	bool IsRunning() const { return Thread != nullptr; }
+	int32 GetPort() const { return ListenPort; }
+	int32 GetConnectionCount() const { return NumConnections; }
+
+	/** 延迟与吞吐统计，可在任意线程读取 */
+	FMCPEndpointMetrics& GetMetrics() { return Metrics; }
+	const FMCPEndpointMetrics& GetMetrics() const { return Metrics; }
+
+	/** 向连接发送一条 JSON 消息，可在任意线程调用 */
+	void SendMessage(uint32 ConnectionId, const TSharedRef<FJsonObject>& Message);
+	void SendRawMessage(uint32 ConnectionId, const FString& MessageJson);
+
+	/**
+	 * 向当前正在执行的请求发送进度消息（仅游戏线程，请求处理期间调用）
+	 * @param Fraction 0~1 的完成度，小于 0 表示未知
+	 * @return 当前没有执行中的请求时返回 false
+	 */
+	bool ReportProgress(const FString& Message, float Fraction = -1.0f);
+
+	/** 向当前正在执行的请求发送一段部分输出 */
+	bool SendPartialOutput(const FString& Text);
+
+	/** Python 桥接：当前等待 Python 处理的请求 JSON，以及 Python 写回的响应 JSON（仅游戏线程） */
+	const FString& GetPendingPythonRequest() const { return PendingPythonRequest; }
+	void SetPendingPythonResponse(const FString& ResponseJson) { PendingPythonResponse = ResponseJson; }
+
+	/** 单条消息体上限，超过视为协议错误并断开连接 */
+	static constexpr int32 MaxMessageSize = 256 * 1024 * 1024;
+
+	/** 同时保持的客户端连接上限，超出时拒绝新连接；请求 ID 只在所属连接内有效 */
+	static constexpr int32 MaxConnections = 16;
+
+	/** 单个 batch 请求的子请求数量上限 */
+	static constexpr int32 MaxBatchSize = 1024;
+
+	/** 压缩帧的首字节（MessagePack 中保留不用的 0xc1，也不会是 JSON 的开头） */
+	static constexpr uint8 CompressedFrameMarker = 0xc1;
+	static constexpr uint8 CompressionZlib = 1;
+	static constexpr uint8 CompressionLZ4 = 2;
+	/** 压缩帧的算法字节取该值时表示负载位于共享内存环形缓冲中 */
+	static constexpr uint8 SharedMemoryReference = 0x80;
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	/** 消息在 I/O 线程上按连接协商的编码序列化，游戏线程不承担编码开销 */
+	struct FOutgoingMessage
+	{
+		uint32 ConnectionId = 0;
+		TSharedPtr<FJsonObject> Message;
+		/** Message 为空时使用：已序列化的 UTF-8 JSON（Python 桥接返回的响应） */
+		TArray<uint8> Payload;
+		/** 统计归属的请求类型，为空时按消息自身的 type 统计 */
+		FString MetricsType;
+	};
+
+	/** 由 I/O 线程独占 */
+	struct FConnection
+	{
+		uint32 Id = 0;
+		FSocket* Socket = nullptr;
+		TArray<uint8> RecvBuffer;
+		/** RecvBuffer 中已解析的前缀长度，帧直接在缓冲区上解析，已解析部分过半时才整体前移 */
+		int32 RecvOffset = 0;
+		TArray<uint8> SendBuffer;
+		/** SendBuffer 中已写入 socket 的前缀长度，部分写入后从这里继续 */
+		int32 SendOffset = 0;
+		/** 拥塞期间等待编码的消息，保持发送顺序 */
+		TArray<FOutgoingMessage> DeferredMessages;
+		/** 已发布给游戏线程的拥塞状态 */
+		bool bCongested = false;
+		/** hello 协商后改用 MessagePack 发送 */
+		bool bMessagePack = false;
+		/** hello 协商的压缩算法，NAME_None 表示不压缩 */
+		FName Compression = NAME_None;
+		int32 CompressionThreshold = 0;
+		/** hello 协商的共享内存环形缓冲，仅同机客户端 */
+		TUniquePtr<FMCPSharedMemoryRing> SharedMemory;
+		int32 SharedMemoryThreshold = 0;
+		/** 尚未完成的请求的取消标记，请求结束后游戏线程释放标记，弱引用随之失效 */
+		TMap<FString, TWeakPtr<FMCPCancellationToken, ESPMode::ThreadSafe>> InFlightRequests;
+
+		int32 GetPendingSendBytes() const { return SendBuffer.Num() - SendOffset; }
+	};
+
+	/** I/O 线程 -> 游戏线程的事件，连接关闭与请求走同一队列以保证顺序 */
+	struct FIncomingEvent
+	{
+		FMCPEndpointRequest Request;
+		bool bConnectionClosed = false;
+	};
+
+	/** 游戏线程上正在执行的请求，日志设备可能在其他线程读取，由 CurrentRequestMutex 保护 */
+	struct FCurrentRequest
+	{
+		bool bActive = false;
+		uint32 ConnectionId = 0;
+		FString Id;
+		FString Type;
+		bool bStreamLogs = false;
+		double StartTime = 0.0;
+	};
+
+	/** 把执行中请求的日志转为 partial 消息 */
+	class FRequestLogDevice;
+
+	/** 游戏线程上进行中的分块导出，每帧推进一个 chunk */
+	struct FActiveStream
+	{
+		uint32 ConnectionId = 0;
+		FString Id;
+		FString Kind;
+		FString PackagePath;
+		int32 ChunkChars = 16384;
+		/** 蓝图导出在开始时加载一次，遍历位置和已访问的子对象跨 chunk 保留 */
+		TSharedPtr<FMCPBlueprintDump> Blueprint;
+		/** 表格导出在开始时加载并过滤一次，之后每个 chunk 只格式化对应的行 */
+		TSharedPtr<FMCPTableDump> Table;
+		int32 ChunkRows = 200;
+		int32 EndRow = 0;
+		int32 Cursor = 0;
+		int32 Seq = 0;
+		FMCPCancellationTokenPtr CancelToken;
+	};
+
+	// I/O 线程
+	void AcceptConnection();
+	bool ReceiveData(FConnection& InConnection);
+	bool ParseMessages(FConnection& InConnection);
+	/** Message 按值传入，请求交给其他线程前由 I/O 线程释放自己的引用 */
+	void HandleIncomingMessage(FConnection& InConnection, TSharedPtr<FJsonObject> Message);
+	/**
+	 * {"type": "hello"} 协商连接参数，应答始终为 JSON：
+	 * "encodings": ["msgpack", "json"] 之后改用 MessagePack 发送（接收端按帧首字节区分编码，见 FMCPMessagePack）；
+	 * "compression": ["lz4", "zlib"] 超过 MCP.Endpoint.CompressionThreshold 的帧压缩后发送；
+	 * "shm": true 为同机客户端创建共享内存环形缓冲
+	 */
+	void HandleHello(FConnection& InConnection, const FJsonObject& Message, const FString& RequestId);
+	/**
+	 * {"type": "cancel", "target": <请求 ID>} 取消同一连接上的请求：排队中的不再执行，分块导出停止推进，
+	 * 原生处理器通过 FMCPCancellationScope 提前返回，执行中的 Python 收到 KeyboardInterrupt；被取消的请求回复 "cancelled": true
+	 */
+	void HandleCancel(FConnection& InConnection, const FJsonObject& Message, const FString& RequestId);
+	/** {"type": "metrics", "reset": false} 直接返回 FMCPEndpointMetrics 统计，与控制台命令 MCP.EndpointStats 的数据相同 */
+	void HandleMetrics(FConnection& InConnection, const FJsonObject& Message, const FString& RequestId);
+	/** 若 Token 对应的请求正在执行 Python，在 Python 中抛出 KeyboardInterrupt */
+	void InterruptPython(const FMCPCancellationToken* Token);
+	void AppendFrame(FConnection& InConnection, const TArray<uint8>& Payload);
+	void EncodeOutgoing(const FConnection& InConnection, FOutgoingMessage& Outgoing, TArray<uint8>& OutPayload) const;
+	/** 按连接协商的算法压缩帧，压缩无收益时返回 false */
+	bool CompressPayload(const FConnection& InConnection, const TArray<uint8>& Payload, TArray<uint8>& OutCompressed) const;
+	/** 为同机（回环地址）客户端创建共享内存环形缓冲（见 FMCPSharedMemoryRing），返回写入 hello 应答的描述 */
+	TSharedPtr<FJsonObject> SetupSharedMemory(FConnection& InConnection);
+	/**
+	 * 超过 MCP.Endpoint.SharedMemoryThreshold 的负载写入共享内存，socket 上只发送 CompressedFrameMarker + SharedMemoryReference + 长度；
+	 * 不满足条件或空间不足时返回 false
+	 */
+	bool SendViaSharedMemory(FConnection& InConnection, const TArray<uint8>& Payload);
+	void QueueOutgoingMessages();
+	/** 编码一条消息并追加到连接的发送缓冲 */
+	void WriteOutgoing(FConnection& InConnection, FOutgoingMessage& Outgoing);
+	/** 发送缓冲低于上限时依次编码拥塞期间积压的消息 */
+	void DrainDeferredMessages(FConnection& InConnection);
+	bool FlushSendBuffer(FConnection& InConnection);
+	/**
+	 * 按待发送字节更新连接的拥塞状态，状态变化时通知游戏线程。
+	 * 待发送字节超过 MCP.Endpoint.SendQueueLimitKB 时，之后的消息保留为未编码的 FOutgoingMessage 按顺序等待，
+	 * I/O 线程暂停读取该连接（TCP 窗口把压力传回客户端），游戏线程暂停推进该连接的分块导出
+	 */
+	void UpdateCongestion(FConnection& InConnection);
+	bool IsSendQueueFull(const FConnection& InConnection) const;
+	void CloseConnection(uint32 ConnectionId);
+	void CloseAllConnections();
+
+	/** 游戏线程上执行请求期间发出的消息计入该请求的类型 */
+	FString GetCurrentMetricsType() const;
+
+	/**
+	 * 线程安全的只读请求（见 FMCPNativeHandler::bThreadSafe）交给工作线程执行（成功时移走 Request），
+	 * 同时最多 MCP.Endpoint.WorkerRequests 个；返回 false 表示应走游戏线程
+	 */
+	bool DispatchToWorker(FMCPEndpointRequest& Request);
+
+	// 工作线程
+	void ExecuteOnWorker(const FMCPEndpointRequest& Request);
+
+	// 游戏线程
+	bool Tick(float DeltaTime);
+	/** 请求带 "progress": true 时，执行期间的日志作为 partial 消息逐步发出 */
+	void BeginRequest(const FMCPEndpointRequest& Request);
+	void EndRequest();
+	void CaptureRequestLog(const TCHAR* Text, ELogVerbosity::Type Verbosity, const FName& Category);
+	/** 把缓存的日志作为 partial 消息发出，bForce 为 false 时按时间和大小节流 */
+	void FlushRequestLog(bool bForce);
+	void DropConnectionState(uint32 ConnectionId);
+	/** 连接的发送队列已满，游戏线程上的生产者（分块导出）应暂停 */
+	bool IsConnectionCongested(uint32 ConnectionId) const;
+	void HandleRequest(const FMCPEndpointRequest& Request);
+	/**
+	 * {"type": "batch", "requests": [...], "stop_on_error": true} 在同一个游戏线程时间片内按顺序执行子请求，
+	 * "results" 与子请求一一对应；stop_on_error 时第一个失败之后的子请求标记 "skipped": true。
+	 * 批量请求整体参与调度和取消；dump_stream、hello、cancel 和嵌套 batch 不能作为子请求
+	 */
+	void HandleBatch(const FMCPEndpointRequest& Request);
+	/** subscribe / unsubscribe（见 FMCPEventHub），返回其结果（不发送）；连接关闭时其订阅随之清除 */
+	TSharedRef<FJsonObject> HandleSubscription(const FMCPEndpointRequest& Request);
+	/** 执行 batch 中的一个子请求，返回其结果（不发送） */
+	TSharedRef<FJsonObject> ExecuteBatchEntry(const FMCPEndpointRequest& Batch, const TSharedRef<FJsonObject>& Entry);
+	void HandleExpiredRequest(const FMCPEndpointRequest& Request);
+	void StartStream(const FMCPEndpointRequest& Request);
+	void AdvanceStreams(double FrameStartTime);
+	/** 推进一个 chunk，返回 false 表示该导出已结束 */
+	bool AdvanceStream(FActiveStream& Stream);
+	void DispatchToPython(const FMCPEndpointRequest& Request);
+	/** 在 Python 桥接中执行请求，响应留在 PendingPythonResponse 中；Python 不可用时返回 false */
+	bool RunPythonBridge(const FMCPEndpointRequest& Request);
+	void SendError(uint32 ConnectionId, const FString& RequestId, const FString& Error);
+	void SendCancelled(uint32 ConnectionId, const FString& RequestId);
+	static TSharedRef<FJsonObject> MakeErrorResult(const FString& RequestId, const FString& Error);
+	static TSharedRef<FJsonObject> MakeCancelledResult(const FString& RequestId);
+
+	/**
+	 * ping/heartbeat 的应答，带有游戏线程状态："busy"、帧号 "frame"、距上次 tick 的 "since_tick_ms" 和排队请求数 "queued"；
+	 * 超过 MCP.Endpoint.StallThresholdMs 未 tick 时 state 为 "stalled"，客户端据此延长等待而不是超时重连
+	 */
+	TSharedRef<FJsonObject> MakeStateMessage(const TCHAR* Type, const FString& RequestId) const;
+
+private:
+	FSocket* ListenSocket = nullptr;
+	int32 ListenPort = 0;
+	FRunnableThread* Thread = nullptr;
+	FThreadSafeBool bStopRequested = false;
+
+	/** 由 I/O 线程独占 */
+	TMap<uint32, TUniquePtr<FConnection>> Connections;
+	uint32 NextConnectionId = 1;
+	std::atomic<int32> NumConnections { 0 };
+
+	TQueue<FIncomingEvent, EQueueMode::Spsc> IncomingEvents;
+	TQueue<FOutgoingMessage, EQueueMode::Mpsc> OutgoingMessages;
+
+	/** 发送队列已满的连接，I/O 线程写入、游戏线程读取 */
+	mutable FCriticalSection CongestionMutex;
+	TSet<uint32> CongestedConnections;
+
+	/** 游戏线程待处理请求，按优先级和 MCP.Endpoint.FrameBudgetMs 执行，超过 "deadline_ms" 的请求直接回复错误 */
+	FMCPRequestScheduler Scheduler;
+
+	FMCPEndpointMetrics Metrics;
+
+	/** 游戏线程正在执行请求，ping 时上报 executing */
+	FThreadSafeBool bGameThreadBusy = false;
+
+	/** 游戏线程每次 tick 时更新，I/O 线程据此判断游戏线程是否停滞 */
+	std::atomic<double> LastTickTime { 0.0 };
+	std::atomic<uint64> LastTickFrame { 0 };
+	/** 已交给游戏线程但尚未执行的请求数：IncomingEvents 中的 + 调度器中的 */
+	std::atomic<int32> NumIncomingRequests { 0 };
+	std::atomic<int32> NumScheduledRequests { 0 };
+
+	/** 工作线程上执行中的请求数，关闭时等待归零 */
+	std::atomic<int32> NumWorkerRequests { 0 };
+
+	mutable FCriticalSection CurrentRequestMutex;
+	FCurrentRequest CurrentRequest;
+	FString PendingRequestLog;
+	double LastRequestLogFlushTime = 0.0;
+	TUniquePtr<FOutputDevice> RequestLogDevice;
+
+	/** 事件订阅，每帧在 Tick 末尾推送 */
+	FMCPEventHub EventHub;
+
+	TArray<FActiveStream> ActiveStreams;
+	/** 预算不足时只推进部分导出，起点轮换保证每个导出都能前进 */
+	int32 NextStreamIndex = 0;
+	FString PendingPythonRequest;
+	FString PendingPythonResponse;
+
+	/** 正在执行 Python 的请求的取消标记，I/O 线程据此决定是否中断 Python */
+	FCriticalSection PythonInterruptMutex;
+	const FMCPCancellationToken* PythonCancelToken = nullptr;
+
+#if ENGINE_MAJOR_VERSION >= 5
+	FTSTicker::FDelegateHandle TickerHandle;
+#else
+	FDelegateHandle TickerHandle;
+#endif
+};
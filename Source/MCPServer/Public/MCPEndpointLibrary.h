@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "MCPEndpointLibrary.generated.h"
+
+/**
+ * Blueprint function library for the native MCP endpoint
+ */
+UCLASS()
+class MCPSERVER_API UMCPEndpointLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Start the native endpoint (same protocol as MCPForwarder.py, served from a background I/O thread)
+	 * @param BindAddress Address to listen on
+	 * @param Port Port to listen on, must not be used by the Python forwarder at the same time
+	 * @return True if the endpoint is listening
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint", meta = (DisplayName = "Start MCP Endpoint"))
+	static bool StartEndpoint(const FString& BindAddress = TEXT("127.0.0.1"), int32 Port = 8100);
+
+	/**
+	 * Stop the native endpoint and close all client connections
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint", meta = (DisplayName = "Stop MCP Endpoint"))
+	static void StopEndpoint();
+
+	UFUNCTION(BlueprintPure, Category = "MCP|Endpoint", meta = (DisplayName = "Is MCP Endpoint Running"))
+	static bool IsEndpointRunning();
+
+	UFUNCTION(BlueprintPure, Category = "MCP|Endpoint", meta = (DisplayName = "Is MCP Endpoint Client Connected"))
+	static bool IsEndpointClientConnected();
+
+	/**
+	 * Number of clients currently connected to the native endpoint
+	 */
+	UFUNCTION(BlueprintPure, Category = "MCP|Endpoint", meta = (DisplayName = "Get MCP Endpoint Connection Count"))
+	static int32 GetEndpointConnectionCount();
+
+	/**
+	 * Serve the MCP protocol (streamable HTTP: initialize, tools/list, tools/call) directly from the editor,
+	 * so AI clients can connect without the standalone Python MCP server
+	 * @param Port Port to listen on
+	 * @param Path Route of the MCP endpoint
+	 * @param BindAddress Address to listen on; requests from other machines are rejected unless MCP.HttpServer.AllowRemoteClients is set
+	 * @return True if the route is bound and listening
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint", meta = (DisplayName = "Start MCP HTTP Server"))
+	static bool StartHttpServer(int32 Port = 8101, const FString& Path = TEXT("/mcp"), const FString& BindAddress = TEXT("127.0.0.1"));
+
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint", meta = (DisplayName = "Stop MCP HTTP Server"))
+	static void StopHttpServer();
+
+	UFUNCTION(BlueprintPure, Category = "MCP|Endpoint", meta = (DisplayName = "Is MCP HTTP Server Running"))
+	static bool IsHttpServerRunning();
+
+	/**
+	 * Request JSON the endpoint (or the native MCP HTTP server) is currently handing to Python (used by mcp_server.MCPEndpointBridge)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint")
+	static FString GetPendingPythonRequest();
+
+	/**
+	 * Response JSON for the request returned by GetPendingPythonRequest (used by mcp_server.MCPEndpointBridge)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint")
+	static void SetPendingPythonResponse(const FString& ResponseJson);
+
+	/**
+	 * Run a request through the native C++ handlers (log_tail, dump_object, get_property, set_property, tag_exists, ...)
+	 * Lets the Python forwarder serve the same message types as the native endpoint.
+	 * @param RequestJson The request message as JSON
+	 * @return The result message as JSON, or an empty string if no native handler exists for the request type
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint")
+	static FString ExecuteNativeRequest(const FString& RequestJson);
+
+	/**
+	 * Message types served by native C++ handlers
+	 */
+	UFUNCTION(BlueprintPure, Category = "MCP|Endpoint")
+	static TArray<FString> GetNativeRequestTypes();
+
+	/**
+	 * Send a progress message for the request the native endpoint is currently executing
+	 * Clients extend their timeout on every progress message, so long operations should report regularly.
+	 * @param Message Human-readable description of the current step
+	 * @param Fraction Completion in [0, 1], or negative if unknown
+	 * @return False if no request is being executed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint")
+	static bool ReportProgress(const FString& Message, float Fraction = -1.0f);
+
+	/**
+	 * Send a chunk of output for the request the native endpoint is currently executing, ahead of the final result
+	 * @return False if no request is being executed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint")
+	static bool SendPartialOutput(const FString& Text);
+
+	/**
+	 * Whether the client cancelled the request currently being executed
+	 * Long-running scripts can poll this to stop early; the endpoint also raises KeyboardInterrupt in cancelled Python code.
+	 */
+	UFUNCTION(BlueprintPure, Category = "MCP|Endpoint")
+	static bool IsCurrentRequestCancelled();
+
+	/**
+	 * Drop all cached results of read-only native requests
+	 * Called after running arbitrary Python code, which may change editor state without firing any invalidation event.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Endpoint")
+	static void InvalidateResultCache();
+};
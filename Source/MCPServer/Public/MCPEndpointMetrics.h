@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+
+/**
+ * 以 2 的幂（微秒）分桶的耗时直方图，桶 i 覆盖 [2^(i-1), 2^i) 微秒，最后一个桶收纳所有更长的耗时。
+ * 分位数返回所在桶的上界，精度在 2 倍以内，足以区分帧量化（~16 ms）、Python 执行和序列化开销。
+ */
+struct MCPSERVER_API FMCPLatencyHistogram
+{
+	static constexpr int32 NumBuckets = 32;
+
+	void Add(double Seconds);
+
+	/** @param Fraction 0~1，例如 0.99 表示 p99；没有样本时返回 0 */
+	double GetPercentileSeconds(double Fraction) const;
+	double GetMeanSeconds() const { return Count > 0 ? TotalSeconds / Count : 0.0; }
+
+	/** {"count", "mean_ms", "p50_ms", "p90_ms", "p99_ms", "max_ms"} */
+	TSharedRef<FJsonObject> ToJson() const;
+
+	uint64 Buckets[NumBuckets] = {};
+	uint64 Count = 0;
+	double TotalSeconds = 0.0;
+	double MaxSeconds = 0.0;
+};
+
+/** 单个消息类型的统计 */
+struct FMCPMessageTypeMetrics
+{
+	/** 在游戏线程上执行的次数 */
+	uint64 Executed = 0;
+	/** 排队超时未执行的次数 */
+	uint64 Expired = 0;
+	uint64 MessagesIn = 0;
+	uint64 MessagesOut = 0;
+	uint64 BytesIn = 0;
+	uint64 BytesOut = 0;
+	/** 从 I/O 线程收到到游戏线程开始执行 */
+	FMCPLatencyHistogram QueueWait;
+	/** 游戏线程上的执行时间（含 Python） */
+	FMCPLatencyHistogram Execution;
+	/** I/O 线程上的解码与编码、压缩时间 */
+	FMCPLatencyHistogram Serialization;
+};
+
+/**
+ * 原生端点的延迟与吞吐统计，按请求消息类型分组。
+ *
+ * I/O 线程记录收发字节数和序列化耗时，游戏线程记录排队等待和执行耗时；
+ * 请求执行期间发出的消息（progress、partial、result）计入该请求的类型，
+ * 其他消息（I/O 线程直接应答的 pong、分块导出的 chunk 等）按消息自身的类型计。
+ * 类型名来自客户端，只有 SetKnownTypeFilter 认可的类型单独统计，其余计入 "(unknown)"，统计表不会随客户端输入无限增长。
+ * 通过 {"type": "metrics"} 消息和 MCP.EndpointStats 控制台命令查看。线程安全。
+ */
+class MCPSERVER_API FMCPEndpointMetrics
+{
+public:
+	FMCPEndpointMetrics();
+
+	/** 设置单独统计的类型，未设置时所有类型都单独统计；可在任意线程调用 */
+	void SetKnownTypeFilter(TFunction<bool(const FString& Type)> InIsKnownType);
+
+	void RecordReceived(const FString& Type, int32 Bytes, double DecodeSeconds);
+	void RecordExecuted(const FString& Type, double QueueWaitSeconds, double ExecutionSeconds);
+	void RecordExpired(const FString& Type, double QueueWaitSeconds);
+	void RecordSent(const FString& Type, int32 Bytes, double EncodeSeconds);
+
+	void Reset();
+
+	/** {"uptime", "types": {<type>: {...}}} */
+	TSharedRef<FJsonObject> ToJson() const;
+
+	/** 控制台输出用的表格，每行一个消息类型 */
+	TArray<FString> ToLines() const;
+
+	/** 统计使用的类型名，未被认可的类型为 "(unknown)"；也用作 CPU trace 事件名，事件名数量随之有界 */
+	const FString& GetTypeKey(const FString& Type) const;
+
+private:
+	mutable FCriticalSection Mutex;
+	TFunction<bool(const FString& Type)> IsKnownType;
+	TMap<FString, FMCPMessageTypeMetrics> Types;
+	double StartTime = 0.0;
+};
@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ITransaction.h"
+#include "Templates/Function.h"
+#include <atomic>
+
+class FJsonObject;
+class FJsonValue;
+class UObject;
+
+/** 可订阅的编辑器事件主题 */
+enum class EMCPEventTopic : uint8
+{
+	/** 日志记录（按最低级别和分类过滤） */
+	Log,
+	/** 事务提交、撤销/重做 */
+	Transaction,
+	/** 关卡中选中的 Actor 变化 */
+	Selection,
+	/** 资产包保存到磁盘 */
+	AssetSaved,
+	/** PIE 开始、停止、暂停、恢复 */
+	PIE,
+
+	Num
+};
+
+/**
+ * 原生端点的事件订阅，客户端不必轮询即可得知编辑器变化。
+ *
+ * {"type": "subscribe", "topics": ["log", "transaction", "selection", "asset_saved", "pie"], ...} 创建一个订阅，
+ * 订阅 ID 即请求 ID；可选过滤条件：
+ * - "min_verbosity"：log 主题的最低日志级别（Error、Warning、Display、Log、Verbose），默认 Log
+ * - "categories"：log 主题只接收这些分类
+ * - "path_prefix"：transaction 主题的主对象、asset_saved 主题的包名必须以此开头
+ * - "max_items"：selection 快照最多列出的 Actor 数量
+ * {"type": "unsubscribe", "target": <订阅 ID>} 取消订阅，不带 target 时取消该连接的全部订阅。
+ *
+ * 同一帧内的事件按订阅和主题合并为一条 {"type": "event", "subscription", "topic", "frame", "events": [...]} 消息，
+ * selection 只发送帧末的选择快照，asset_saved 同一包只报告一次。每个订阅每个主题最多积压
+ * MCP.Endpoint.MaxPendingEvents 条，超出的事件丢弃并在下一条消息的 "dropped" 中计数；
+ * 连接发送队列已满时暂停发送，事件继续在上限内积压。
+ *
+ * 只在有订阅时绑定对应主题的编辑器委托和日志设备。日志可在任意线程捕获，其余均在游戏线程使用。
+ */
+class MCPSERVER_API FMCPEventHub
+{
+public:
+	FMCPEventHub();
+	~FMCPEventHub();
+
+	/**
+	 * 创建订阅
+	 * @return 订阅结果；参数无效时返回 nullptr 并填写 OutError
+	 */
+	TSharedPtr<FJsonObject> Subscribe(uint32 ConnectionId, const FString& SubscriptionId, const FJsonObject& Request, FString& OutError);
+
+	/** 取消订阅，SubscriptionId 为空时取消该连接的全部订阅，返回取消的数量 */
+	int32 Unsubscribe(uint32 ConnectionId, const FString& SubscriptionId);
+
+	/** 连接关闭时丢弃其订阅 */
+	void RemoveConnection(uint32 ConnectionId);
+
+	/** 解除所有委托并清空订阅 */
+	void Reset();
+
+	/**
+	 * 每帧调用一次，把积压的事件合并发送
+	 * @param IsPaused 连接发送队列已满时返回 true，该连接的事件留到之后的帧
+	 */
+	void Flush(TFunctionRef<bool(uint32 ConnectionId)> IsPaused, TFunctionRef<void(uint32 ConnectionId, const TSharedRef<FJsonObject>& Message)> Send);
+
+	int32 Num() const { return Subscriptions.Num(); }
+
+	static const TCHAR* GetTopicName(EMCPEventTopic Topic);
+	static bool ParseTopic(const FString& Name, EMCPEventTopic& OutTopic);
+
+private:
+	struct FSubscription
+	{
+		uint32 ConnectionId = 0;
+		FString Id;
+		/** 按 EMCPEventTopic 的位掩码 */
+		uint32 Topics = 0;
+		ELogVerbosity::Type MinVerbosity = ELogVerbosity::Log;
+		TArray<FName> Categories;
+		FString PathPrefix;
+		int32 MaxItems = 100;
+		TArray<TSharedPtr<FJsonValue>> PendingEvents[static_cast<int32>(EMCPEventTopic::Num)];
+		int32 Dropped[static_cast<int32>(EMCPEventTopic::Num)] = {};
+
+		bool HasTopic(EMCPEventTopic Topic) const { return (Topics & (1u << static_cast<uint32>(Topic))) != 0; }
+	};
+
+	/** 日志线程捕获的原始记录，游戏线程 Flush 时分发给各订阅 */
+	struct FLogRecord
+	{
+		FName Category;
+		ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+		FString Message;
+		double Time = 0.0;
+	};
+
+	class FLogDevice;
+
+	/** 按现有订阅绑定或解除各主题的委托 */
+	void UpdateListeners();
+	void StartListening(EMCPEventTopic Topic);
+	void StopListening(EMCPEventTopic Topic);
+
+	/** 把事件加入所有订阅了该主题且通过 Filter 的订阅 */
+	void Publish(EMCPEventTopic Topic, const TSharedRef<FJsonObject>& Event, TFunctionRef<bool(const FSubscription&)> Filter);
+	static void AddPendingEvent(FSubscription& Subscription, EMCPEventTopic Topic, const TSharedPtr<FJsonValue>& Event);
+
+	void CaptureLog(const TCHAR* Text, ELogVerbosity::Type Verbosity, const FName& Category);
+	void DistributeLogs();
+	TSharedRef<FJsonObject> MakeSelectionSnapshot(int32 MaxItems) const;
+
+	void OnTransactionStateChanged(const FTransactionContext& Context, ETransactionStateEventType EventType);
+	void OnSelectionChanged(UObject* Object);
+	void OnPackageSaved(const FString& PackageFileName, const FString& PackageName);
+	void OnPIEStateChanged(const TCHAR* State, bool bIsSimulating);
+
+private:
+	TArray<FSubscription> Subscriptions;
+
+	/** 当前绑定了委托的主题位掩码 */
+	uint32 ListeningTopics = 0;
+
+	TUniquePtr<FLogDevice> LogDevice;
+	/** 订阅中最详细的日志级别，更详细的日志在捕获时直接跳过 */
+	std::atomic<int32> CaptureVerbosity { ELogVerbosity::NoLogging };
+	FCriticalSection LogMutex;
+	TArray<FLogRecord> PendingLogs;
+	int32 DroppedLogs = 0;
+
+	/** 本帧选择有变化，Flush 时生成一次快照 */
+	bool bSelectionDirty = false;
+
+	FDelegateHandle TransactionStateHandle;
+	FDelegateHandle SelectionChangedHandle;
+	FDelegateHandle SelectObjectHandle;
+	FDelegateHandle PackageSavedHandle;
+	FDelegateHandle BeginPIEHandle;
+	FDelegateHandle EndPIEHandle;
+	FDelegateHandle PausePIEHandle;
+	FDelegateHandle ResumePIEHandle;
+};
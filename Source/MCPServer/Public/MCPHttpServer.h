@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HttpResultCallback.h"
+#include "HttpRouteHandle.h"
+#include "MCPEndpointMetrics.h"
+
+class IHttpRouter;
+class FJsonObject;
+class FJsonValue;
+struct FHttpServerRequest;
+
+/**
+ * 编辑器内的原生 MCP 端点（Streamable HTTP 传输），基于引擎的 HTTPServer 模块。
+ *
+ * 在 C++ 中直接处理 MCP 的 JSON-RPC 消息，AI 客户端不再经过独立的 MCPStandalone 进程，
+ * 也不依赖 Python 中由 tick 驱动的 asyncio 事件循环：
+ * - POST <Path>：单条或批量 JSON-RPC 消息，支持 initialize、ping、tools/list、tools/call；
+ *   请求以 application/json 直接应答，只含通知时返回 202
+ * - GET <Path>：不提供服务端推送流，返回 405
+ * - DELETE <Path>：结束 Mcp-Session-Id 指定的会话
+ *
+ * 工具与 Python MCP 服务相同（execute_command、excute_file、get_editor_state），另加 native_request
+ * 调用 FMCPNativeHandlerRegistry 中的处理器。Python 工具经 mcp_server.MCPEndpointBridge 执行，原生工具不经过 Python。
+ * HTTPServer 模块在游戏线程上分发请求，工具调用同步执行。
+ *
+ * initialize 分配 Mcp-Session-Id，之后带未知会话 ID 的请求返回 404；不带会话 ID 的请求也接受，便于 curl 等简单客户端调试。
+ * 工具可执行任意 Python 且没有鉴权，因此默认只监听 127.0.0.1，非本机对端的请求在 MCP.HttpServer.AllowRemoteClients
+ * 开启前一律拒绝；带非本机 Origin 头的请求也被拒绝（防 DNS 重绑定）。
+ */
+class MCPSERVER_API FMCPHttpServer
+{
+public:
+	FMCPHttpServer();
+	~FMCPHttpServer();
+
+	/** 在 Port 上绑定 Path 路由并启动监听，默认只监听本机回环地址 */
+	bool Start(int32 Port, const FString& Path, const FString& BindAddress = TEXT("127.0.0.1"));
+	void Stop();
+
+	bool IsRunning() const { return RouteHandle.IsValid(); }
+	int32 GetPort() const { return ListenPort; }
+	const FString& GetPath() const { return RoutePath; }
+
+	FMCPEndpointMetrics& GetMetrics() { return Metrics; }
+
+	/** Python 桥接：正在等待 Python 处理的请求 JSON，为空表示当前没有由本端点发起的 Python 调用（仅游戏线程） */
+	const FString& GetPendingPythonRequest() const { return PendingPythonRequest; }
+	void SetPendingPythonResponse(const FString& ResponseJson) { PendingPythonResponse = ResponseJson; }
+
+	/** 同时保留的会话上限，超出时丢弃最早的会话 */
+	static constexpr int32 MaxSessions = 64;
+
+private:
+	bool HandleHttpRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+
+	/** 处理一条 JSON-RPC 消息，通知和客户端应答返回 nullptr */
+	TSharedPtr<FJsonObject> HandleMessage(const FJsonObject& Message, FString& InOutSessionId);
+
+	TSharedRef<FJsonObject> HandleInitialize(const FJsonObject& Params, FString& OutSessionId);
+	TSharedRef<FJsonObject> HandleToolsList() const;
+	/** @return tools/call 的 result；未知工具时返回 nullptr 并填写 OutError */
+	TSharedPtr<FJsonObject> HandleToolsCall(const FJsonObject& Params, FString& OutError);
+
+	/** 执行 Python 工具（execute / execute_file），返回桥接写回的响应 */
+	TSharedPtr<FJsonObject> RunPython(const TSharedRef<FJsonObject>& Request, FString& OutError);
+	FString DescribeEditorState() const;
+
+	static TSharedRef<FJsonObject> MakeResponse(const TSharedPtr<FJsonValue>& Id, const TSharedRef<FJsonObject>& Result);
+	static TSharedRef<FJsonObject> MakeErrorResponse(const TSharedPtr<FJsonValue>& Id, int32 Code, const FString& Message);
+	static TSharedRef<FJsonObject> MakeToolResult(const FString& Text, bool bIsError);
+
+private:
+	TSharedPtr<IHttpRouter> Router;
+	FHttpRouteHandle RouteHandle;
+	int32 ListenPort = 0;
+	FString RoutePath;
+
+	/** 按创建顺序排列 */
+	TArray<FString> Sessions;
+	int32 NextRequestId = 1;
+
+	FString PendingPythonRequest;
+	FString PendingPythonResponse;
+
+	FMCPEndpointMetrics Metrics;
+};
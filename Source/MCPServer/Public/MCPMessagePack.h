@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+
+/**
+ * 端点协议的 MessagePack 编解码，与 JSON 消息一一对应。
+ *
+ * - 字符串直接写入 UTF-8 字节，不做 JSON 转义，大段 output/日志的编解码开销远小于 JSON
+ * - 整数值的 number 编码为 int，其余为 float64
+ * - 解码时 bin 类型按 UTF-8 字符串处理，ext 类型解码为 null；map 的键必须是字符串
+ *
+ * MessagePack 的 map 首字节（0x80-0x8f/0xde/0xdf）与 JSON 的 '{' 不会冲突，接收端据此区分帧的编码。
+ */
+class MCPSERVER_API FMCPMessagePack
+{
+public:
+	static void Encode(const FJsonObject& Object, TArray<uint8>& OutBytes);
+
+	/**
+	 * 从缓冲区直接解码一条消息，不复制负载
+	 * @return 解码失败或顶层不是 map 时返回 nullptr
+	 */
+	static TSharedPtr<FJsonObject> Decode(const uint8* Data, int32 Size, FString* OutError = nullptr);
+
+	/** 帧首字节是否为 MessagePack map */
+	static bool IsMessagePackFrame(const uint8* Data, int32 Size);
+
+	/** 嵌套层数上限，防止恶意数据导致栈溢出 */
+	static constexpr int32 MaxDepth = 64;
+};
@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPRequestScheduler.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/Function.h"
+
+class FJsonObject;
+
+/** 处理器读取的一个请求参数 */
+struct FMCPNativeParam
+{
+	FString Name;
+	/** JSON 类型：string、number、boolean */
+	FString Type = TEXT("string");
+	bool bRequired = false;
+};
+
+/** 原生请求处理器，按消息类型注册 */
+struct FMCPNativeHandler
+{
+	/**
+	 * 处理请求：从 Request 读取参数，把结果字段（通常是 "output"）写入 Result
+	 * 失败时返回 false 并填写 OutError；在游戏线程调用（bThreadSafe 时也可能在工作线程调用）
+	 */
+	TFunction<bool(const FJsonObject& Request, FJsonObject& Result, FString& OutError)> Execute;
+
+	/** 调度优先级，请求中的 "priority" 只能将其降低 */
+	EMCPRequestPriority Priority = EMCPRequestPriority::Normal;
+
+	/** 不修改编辑器状态 */
+	bool bReadOnly = true;
+
+	/** 结果只取决于请求参数和编辑器状态（而非时间、日志等），只读时可由 FMCPResultCache 缓存 */
+	bool bCacheable = true;
+
+	/**
+	 * 可缓存的处理器按请求进一步判断是否使用缓存，未设置时总是使用。
+	 * 关卡和 PIE 中的对象每帧都可能变化而不触发任何失效事件，按对象路径读取的处理器只缓存资产和 CDO
+	 */
+	TFunction<bool(const FJsonObject& Request)> CanCache;
+
+	/**
+	 * 不访问 UObject 等只能在游戏线程使用的状态，可在工作线程执行。
+	 * 只读且线程安全的请求由原生端点交给工作线程池，游戏线程忙碌（编译、长时间 Python 执行）时也能立即返回。
+	 */
+	bool bThreadSafe = false;
+
+	/**
+	 * 处理器读取的参数。MCP 工具说明由此生成，执行前按此校验必需参数和类型，
+	 * 因此处理器新增或改名参数时必须同步修改这里
+	 */
+	TArray<FMCPNativeParam> Params;
+};
+
+/**
+ * 原生请求处理器注册表。
+ *
+ * 常用的轻量操作（日志尾部、对象导出、属性读写、标签检查）直接在 C++ 中处理，
+ * 不经过 CodeExecutor 编译执行 Python 代码。原生端点按消息类型查表分发，
+ * Python 转发器通过 UMCPEndpointLibrary::ExecuteNativeRequest 复用同一批处理器。
+ *
+ * 注册和查询可在任意线程进行；处理器只在游戏线程执行，标记 bThreadSafe 的只读处理器除外。
+ */
+class MCPSERVER_API FMCPNativeHandlerRegistry
+{
+public:
+	static FMCPNativeHandlerRegistry& Get();
+
+	void Register(const FString& Type, FMCPNativeHandler Handler);
+	void Unregister(const FString& Type);
+
+	bool HasHandler(const FString& Type) const;
+	bool GetPriority(const FString& Type, EMCPRequestPriority& OutPriority) const;
+	bool IsReadOnly(const FString& Type) const;
+	bool IsCacheable(const FString& Type) const;
+	/** IsCacheable 且处理器的 CanCache 接受该请求（游戏线程） */
+	bool IsCacheableRequest(const FString& Type, const FJsonObject& Request) const;
+	/** 只读且线程安全，可在工作线程执行 */
+	bool IsThreadSafe(const FString& Type) const;
+	TArray<FString> GetHandlerTypes() const;
+	TArray<FMCPNativeParam> GetParams(const FString& Type) const;
+
+	/** 参数签名，如 "get_property(path, property)"，可选参数带 "?" 后缀 */
+	FString DescribeParams(const FString& Type) const;
+
+	/**
+	 * 按注册的参数校验请求：缺少必需参数或类型不符时返回 false；
+	 * 请求中带有未声明的字段时在错误信息中提示，便于客户端发现参数名错误
+	 */
+	bool ValidateParams(const FString& Type, const FJsonObject& Request, FString& OutError) const;
+
+	/**
+	 * 校验参数后执行处理器（游戏线程；线程安全的只读处理器可在任意线程）
+	 * @param Result 处理器写入的结果字段，不包含 type/id/success
+	 * @return 没有对应处理器或处理失败时返回 false
+	 */
+	bool Execute(const FString& Type, const FJsonObject& Request, FJsonObject& Result, FString& OutError) const;
+
+	/**
+	 * 按请求的 "type" 执行处理器并生成完整的 result 消息（type/id/success/error + 处理器写入的字段）
+	 * 在游戏线程上，可缓存的只读处理器优先使用 FMCPResultCache 中的结果；执行非只读处理器后清空缓存
+	 * @return 没有对应处理器时返回 nullptr
+	 */
+	TSharedPtr<FJsonObject> HandleRequest(const FJsonObject& Request) const;
+
+	/** 注册内置处理器：log_tail、captured_logs、clear_captured_logs、find_assets、dump_object、get_property、set_property、tag_exists */
+	void RegisterBuiltinHandlers();
+
+	/** 移除全部处理器及内置处理器使用的日志监听 */
+	void Reset();
+
+	/** log_tail 保留的日志行数上限 */
+	static constexpr int32 MaxLogTailLines = 2000;
+
+private:
+	mutable FRWLock Lock;
+	TMap<FString, FMCPNativeHandler> Handlers;
+};
@@ -4,8 +4,72 @@
 
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "UObject/StrongObjectPtr.h"
 #include "MCPObjectInformDumpLibrary.generated.h"
 
+/**
+ * A Blueprint property dump that is written in several chunks
+ * The Blueprint is loaded once. The walk position and the set of already visited subobjects are kept between chunks,
+ * so concatenating all chunks gives the same text as DumpBlueprintProperties.
+ * Keeps the Blueprint alive while held; game thread only.
+ */
+struct MCPSERVER_API FMCPBlueprintDump
+{
+	/**
+	 * Append whole top-level properties until Out has grown by at least MaxChunkChars characters
+	 * The first call also writes the header.
+	 * @return False once all properties were written
+	 */
+	bool AppendChunk(int32 MaxChunkChars, FString& Out);
+
+	/** Top-level property index the next chunk starts at */
+	int32 GetNextPropertyIndex() const { return NextPropertyIndex; }
+
+private:
+	friend class UMCPObjectInformDumpLibrary;
+
+	/** Holding the generated class keeps its properties and default object alive even if the Blueprint is recompiled meanwhile */
+	TStrongObjectPtr<UObject> Blueprint;
+	TStrongObjectPtr<UObject> GeneratedClass;
+	const UObject* DefaultObject = nullptr;
+	const UObject* ParentDefaultObject = nullptr;
+	TArray<FProperty*> Properties;
+	TSet<const UObject*> VisitedObjects;
+	FString Header;
+	bool bHeaderWritten = false;
+	int32 NextPropertyIndex = 0;
+	bool bBlueprintVisibleOnly = false;
+	bool bModifiedOnly = false;
+};
+
+/**
+ * A DataTable or CurveTable prepared for dumping: the table is loaded, rows are filtered and columns are
+ * resolved once, so a dump split into many chunks only formats the rows of each chunk.
+ * Keeps the table alive while held; game thread only.
+ */
+struct MCPSERVER_API FMCPTableDump
+{
+	FString AssetPath;
+	FString RowNameFilter;
+	FString TableType;
+	FString RowType;
+	int32 TotalRows = 0;
+	TArray<FName> MatchedRows;
+	TArray<FString> Columns;
+
+	/** Append the "=== ... Dump ===" header and the column line for rows [FirstRow, EndRow) */
+	void AppendHeader(int32 FirstRow, int32 EndRow, FString& Out) const;
+
+	/** Append one tab-separated line for MatchedRows[RowIndex]; cells are left empty if the row was removed since */
+	void AppendRow(int32 RowIndex, FString& Out) const;
+
+private:
+	friend class UMCPObjectInformDumpLibrary;
+
+	TStrongObjectPtr<UObject> Table;
+	TFunction<void(FName, FString&)> AppendRowCells;
+};
+
 /**
  * Library for dumping UObject reflection information
  */
@@ -25,6 +89,98 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "MCP|ObjectDump")
 	static FString DumpBlueprintProperties(const FString& PackagePath, bool bBlueprintVisibleOnly = false, bool bModifiedOnly = false);
 
+	/**
+	 * Streaming variant of DumpBlueprintProperties
+	 * Output is produced one top-level property at a time and handed to Sink in chunks of roughly MaxChunkChars characters,
+	 * so the whole dump is never held in memory. Concatenating all chunks gives the same text as DumpBlueprintProperties
+	 * when the dump is written in one call (StartPropertyIndex 0 and Sink never returning false).
+	 * A call resumed at StartPropertyIndex loads the Blueprint again and does not know which subobjects earlier calls
+	 * already wrote, so those are written in full again instead of as "[Circular Reference: ...]"; use PrepareBlueprintDump
+	 * to keep that state across chunks.
+	 * @param PackagePath The package path of the Blueprint (e.g., "/Game/Blueprints/MyBlueprint")
+	 * @param Sink Receives each chunk, return false to stop after this chunk
+	 * @param MaxChunkChars Chunk size threshold, a single property larger than this is still emitted as one chunk
+	 * @param bBlueprintVisibleOnly If true, only dump properties that are visible in Blueprint
+	 * @param bModifiedOnly If true, only dump properties whose values differ from the parent class default values
+	 * @param StartPropertyIndex Top-level property index to resume from, 0 also emits the header
+	 * @param OutNextPropertyIndex Receives the index to resume from, INDEX_NONE once the dump is complete
+	 * @return False if the Blueprint could not be dumped (the error text is passed to Sink)
+	 */
+	static bool DumpBlueprintPropertiesStreamed(const FString& PackagePath, TFunctionRef<bool(const FString& Chunk)> Sink, int32 MaxChunkChars = 16384, bool bBlueprintVisibleOnly = false, bool bModifiedOnly = false, int32 StartPropertyIndex = 0, int32* OutNextPropertyIndex = nullptr);
+
+	/**
+	 * Dump a single chunk of a Blueprint's properties, for clients that pull the dump incrementally
+	 * Each call is independent (see DumpBlueprintPropertiesStreamed), so subobjects shared between chunks are repeated.
+	 * @param PackagePath The package path of the Blueprint
+	 * @param Cursor Resume cursor, 0 for the first chunk
+	 * @param OutNextCursor Cursor for the next call, -1 once the dump is complete
+	 * @param bOutSuccess False if the Blueprint could not be dumped, the returned text is then the error
+	 * @param MaxChunkChars Chunk size threshold in characters
+	 * @return The chunk text
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|ObjectDump")
+	static FString DumpBlueprintPropertiesChunk(const FString& PackagePath, int32 Cursor, int32& OutNextCursor, bool& bOutSuccess, int32 MaxChunkChars = 16384, bool bBlueprintVisibleOnly = false, bool bModifiedOnly = false);
+
+	/**
+	 * Load a Blueprint for a dump that is written over several chunks (see FMCPBlueprintDump)
+	 * @param OutError Receives the error message (containing "Error:") if the Blueprint cannot be dumped
+	 */
+	static TSharedPtr<FMCPBlueprintDump> PrepareBlueprintDump(const FString& PackagePath, bool bBlueprintVisibleOnly, bool bModifiedOnly, FString& OutError);
+
+	/**
+	 * Dump the rows of a DataTable or CurveTable in columnar form
+	 * The column header is written once ("Columns: RowName<TAB>...") followed by one tab-separated line per row.
+	 * DataTable columns are the row struct properties, CurveTable columns are the union of all key times.
+	 * Cell values are not subject to the container element limit of DumpBlueprintProperties.
+	 * @param AssetPath The object path of the table (e.g., "/Game/Data/DT_Weapons")
+	 * @param OutNextRow Row to pass as StartRow to continue, -1 once all matching rows were returned
+	 * @param RowNameFilter Wildcard filter on row names (e.g., "Sword_*"), empty for all rows
+	 * @param StartRow Index of the first row to return, counted among the rows matching the filter
+	 * @param MaxRows Maximum number of rows to return, 0 or less for all
+	 * @param bIncludeHeader If false, only the row lines are returned (for follow-up pages)
+	 * @return The table text, or an error message starting with "Error:"
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|ObjectDump")
+	static FString DumpTableRows(const FString& AssetPath, int32& OutNextRow, const FString& RowNameFilter = TEXT(""), int32 StartRow = 0, int32 MaxRows = 0, bool bIncludeHeader = true);
+
+	/**
+	 * Streaming variant of DumpTableRows, rows are handed to Sink in chunks of roughly MaxChunkChars characters
+	 * @param Sink Receives each chunk, return false to stop after this chunk
+	 * @param OutNextRow Receives the row to resume from, INDEX_NONE once all matching rows were emitted
+	 * @return False if the asset is not a DataTable/CurveTable (the error text is passed to Sink)
+	 */
+	static bool DumpTableRowsStreamed(const FString& AssetPath, TFunctionRef<bool(const FString& Chunk)> Sink, const FString& RowNameFilter = TEXT(""), int32 StartRow = 0, int32 MaxRows = 0, bool bIncludeHeader = true, int32 MaxChunkChars = 16384, int32* OutNextRow = nullptr);
+
+	/**
+	 * Load a DataTable or CurveTable and resolve its matching rows and columns for DumpTableRowsStreamed or a chunked dump
+	 * @param RowNameFilter Wildcard filter on row names, empty for all rows
+	 * @param OutError Receives the error message (starting with "Error:") if the asset is not a DataTable/CurveTable
+	 */
+	static TSharedPtr<FMCPTableDump> PrepareTableDump(const FString& AssetPath, const FString& RowNameFilter, FString& OutError);
+
+	/**
+	 * Export all reflected properties of a Blueprint asset to a compact binary file
+	 * Layout: header, string table, property schema, then tagged varint-encoded values.
+	 * Decode with mcp_server.MCPBinaryDump on the Python side.
+	 * @param PackagePath The package path of the Blueprint (e.g., "/Game/Blueprints/MyBlueprint")
+	 * @param OutputFilePath Absolute path of the file to write
+	 * @param bBlueprintVisibleOnly If true, only dump properties that are visible in Blueprint
+	 * @param bModifiedOnly If true, only dump properties whose values differ from the parent class default values
+	 * @param bCompress If true, zlib-compress the payload after the header
+	 * @param MaxContainerElements Maximum number of array/set/map elements written per container, 0 or less for unlimited
+	 * @return True if the file was written
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|ObjectDump")
+	static bool ExportBlueprintPropertiesBinary(const FString& PackagePath, const FString& OutputFilePath, bool bBlueprintVisibleOnly = false, bool bModifiedOnly = false, bool bCompress = true, int32 MaxContainerElements = 10);
+
+	/**
+	 * Dump all reflected properties of a Blueprint asset into the binary export format
+	 * @param OutBytes Receives the encoded dump
+	 * @param OutError Receives a description of the failure when false is returned
+	 * @return True on success
+	 */
+	static bool DumpBlueprintPropertiesBinary(const FString& PackagePath, TArray<uint8>& OutBytes, FString& OutError, bool bBlueprintVisibleOnly = false, bool bModifiedOnly = false, bool bCompress = true, int32 MaxContainerElements = 10);
+
 	/**
 	 * Export a single property value to text using the same formatting as DumpPropertyValue
 	 */
@@ -68,6 +224,12 @@ public:
 	 */
 	static FString DumpStructProperties(const UStruct* Struct, const void* StructPtr, int32 Indent, TSet<const UObject*>& VisitedObjects, bool bBlueprintVisibleOnly, bool bModifiedOnly, const void* DefaultStructPtr);
 
+	/**
+	 * Append the formatted entry of one property inside a struct/object to Out
+	 * @return false if the property was skipped by the filters
+	 */
+	static bool DumpPropertyEntry(FProperty* Property, const void* StructPtr, const void* DefaultStructPtr, int32 Indent, TSet<const UObject*>& VisitedObjects, bool bBlueprintVisibleOnly, bool bModifiedOnly, FString& Out);
+
 	/**
 	 * Get indentation string
 	 * @param Indent Number of indent levels
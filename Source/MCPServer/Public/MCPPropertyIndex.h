@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+
+class FMCPSnapshotStore;
+
+/** 索引命中项：资产包路径 + 属性路径（如 "AbilityCost.Value" 或 "Sounds[2]"）+ 原始值文本 */
+struct FMCPPropertyIndexHit
+{
+	FString AssetPath;
+	FString PropertyPath;
+	FString Value;
+
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("%s:%s = %s"), *AssetPath, *PropertyPath, *Value);
+	}
+};
+
+/** 数值比较运算符 */
+enum class EMCPNumericCompare : uint8
+{
+	Less,
+	LessEqual,
+	Equal,
+	NotEqual,
+	GreaterEqual,
+	Greater,
+};
+
+/**
+ * 基于属性快照的蓝图默认值索引。
+ *
+ * - 倒排索引：值文本切分出的 token（小写）-> 命中的 (资产, 属性路径)
+ * - 数值列存：属性叶子名 -> 连续的 double 数组，按列扫描回答范围查询
+ *
+ * 数据来源为 FMCPSnapshotStore 中的 dump 文本，快照增量更新时只重建对应资产的条目。
+ * 查询接口可在任意线程调用。
+ */
+class MCPSERVER_API FMCPPropertyIndex : public TSharedFromThis<FMCPPropertyIndex>
+{
+public:
+	FMCPPropertyIndex();
+	~FMCPPropertyIndex();
+
+	/** 绑定快照存储并订阅其更新事件 */
+	void Initialize(const TSharedRef<FMCPSnapshotStore>& InSnapshotStore);
+
+	/** 从快照中全量重建索引，返回索引的资产数量 */
+	int32 Rebuild();
+
+	/** 重新索引单个资产（快照中不存在时移除） */
+	void ReindexAsset(const FString& AssetPath);
+	void RemoveAsset(const FString& AssetPath);
+
+	/** 值文本包含 Query 中所有 token 的属性 */
+	TArray<FMCPPropertyIndexHit> FindByValue(const FString& Query, int32 MaxResults = 100) const;
+
+	/** 属性叶子名为 PropertyName 且数值满足比较条件的属性 */
+	TArray<FMCPPropertyIndexHit> FindByNumeric(FName PropertyName, EMCPNumericCompare Compare, double Operand, int32 MaxResults = 100) const;
+
+	int32 GetIndexedAssetCount() const;
+	int32 GetTokenCount() const;
+
+	/** 将 dump 文本切分为索引 token（与查询使用同一规则） */
+	static void Tokenize(const FString& Text, TArray<FString>& OutTokens);
+
+private:
+	/** 倒排表按 (AssetId, EntryId) 升序排列：同一资产的条目连续，可二分定位、归并求交 */
+	struct FPosting
+	{
+		int32 AssetId = INDEX_NONE;
+		int32 EntryId = INDEX_NONE;
+
+		uint64 GetSortKey() const { return (uint64(uint32(AssetId)) << 32) | uint32(EntryId); }
+	};
+
+	/** 单个属性值条目，按资产分组存储，资产重建时整体替换 */
+	struct FEntry
+	{
+		FString PropertyPath;
+		FString Value;
+	};
+
+	struct FAssetRecord
+	{
+		FString AssetPath;
+		TArray<FEntry> Entries;
+		/** 该资产出现过的 token，移除资产时用于清理倒排表 */
+		TSet<FString> Tokens;
+		/** 该资产写入过的数值列 */
+		TSet<FName> NumericColumns;
+	};
+
+	/** 数值列：三个数组等长，按行对应 */
+	struct FNumericColumn
+	{
+		TArray<double> Values;
+		TArray<int32> AssetIds;
+		TArray<int32> EntryIds;
+	};
+
+	void IndexAssetLocked(const FString& AssetPath, const FString& Dump);
+	void RemoveAssetLocked(const FString& AssetPath);
+	void HandleSnapshotUpdated(const FString& AssetPath, bool bRemoved);
+	FMCPPropertyIndexHit MakeHit(int32 AssetId, int32 EntryId) const;
+
+private:
+	TWeakPtr<FMCPSnapshotStore> SnapshotStore;
+	FDelegateHandle SnapshotUpdatedHandle;
+
+	TSparseArray<FAssetRecord> Assets;
+	TMap<FString, int32> AssetIdByPath;
+	TMap<FString, TArray<FPosting>> InvertedIndex;
+	TMap<FName, FNumericColumn> NumericColumns;
+
+	mutable FRWLock IndexLock;
+};
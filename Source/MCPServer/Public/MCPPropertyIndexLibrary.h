@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "MCPPropertyIndexLibrary.generated.h"
+
+/**
+ * Blueprint function library for querying blueprint default values through the property index
+ *
+ * The index is built from the property snapshot (see UMCPSnapshotLibrary) on first use and is kept
+ * up to date as the snapshot is incrementally updated. Results are formatted as
+ * "<PackagePath>:<PropertyPath> = <Value>".
+ */
+UCLASS()
+class MCPSERVER_API UMCPPropertyIndexLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Rebuild the property index from the current snapshot
+	 * @return Number of indexed blueprints
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|PropertyIndex", meta = (DisplayName = "Rebuild Property Index"))
+	static int32 RebuildPropertyIndex();
+
+	/**
+	 * Find properties whose value text contains every token of the query
+	 * (e.g., "SC_Explosion" or "/Game/Audio/SC_Explosion.SC_Explosion")
+	 * @param Query Tokens to match, case-insensitive
+	 * @param MaxResults Maximum number of results, 0 for unlimited
+	 * @return Matching properties
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|PropertyIndex", meta = (DisplayName = "Find Properties By Value"))
+	static TArray<FString> FindPropertiesByValue(const FString& Query, int32 MaxResults = 100);
+
+	/**
+	 * Find numeric properties with the given name that satisfy a comparison (e.g., "Cooldown", ">", 5)
+	 * @param PropertyName Leaf property name
+	 * @param Operator One of "<", "<=", "==", "!=", ">=", ">"
+	 * @param Value Right-hand operand
+	 * @param MaxResults Maximum number of results, 0 for unlimited
+	 * @return Matching properties
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|PropertyIndex", meta = (DisplayName = "Find Properties By Numeric Value"))
+	static TArray<FString> FindPropertiesByNumericValue(const FString& PropertyName, const FString& Operator, float Value, int32 MaxResults = 100);
+
+	/**
+	 * Find the blueprints that have at least one property value matching the query
+	 * @param Query Tokens to match, case-insensitive
+	 * @return Package paths of matching blueprints
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|PropertyIndex", meta = (DisplayName = "Find Blueprints Referencing"))
+	static TArray<FString> FindBlueprintsReferencing(const FString& Query);
+};
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include <atomic>
+
+class FJsonObject;
+
+/** 请求优先级：数值越小越先执行 */
+enum class EMCPRequestPriority : uint8
+{
+	/** 状态查询等轻量请求，每帧全部执行，不受帧预算限制 */
+	High = 0,
+	/** 原生处理的请求（dump 等） */
+	Normal = 1,
+	/** 执行 Python 代码等重量请求 */
+	Low = 2,
+
+	Num
+};
+
+/** 请求的取消标记：I/O 线程收到 {"type": "cancel"} 时置位，游戏线程在执行前和长操作的循环中检查 */
+struct FMCPCancellationToken
+{
+	bool IsCancelled() const { return bCancelled.load(std::memory_order_relaxed); }
+	void Cancel() { bCancelled.store(true, std::memory_order_relaxed); }
+
+private:
+	std::atomic<bool> bCancelled { false };
+};
+
+typedef TSharedPtr<FMCPCancellationToken, ESPMode::ThreadSafe> FMCPCancellationTokenPtr;
+
+/**
+ * 在当前线程上设置正在执行的请求的取消标记（可嵌套）。
+ * 原生处理器、导出库等长时间运行的代码通过 IsCancellationRequested() 检查，无需知道请求来自哪个端点。
+ */
+class MCPSERVER_API FMCPCancellationScope
+{
+public:
+	explicit FMCPCancellationScope(const FMCPCancellationTokenPtr& Token);
+	~FMCPCancellationScope();
+
+	/** 当前线程正在执行的请求是否已被客户端取消 */
+	static bool IsCancellationRequested();
+
+private:
+	FMCPCancellationTokenPtr Token;
+	FMCPCancellationToken* PreviousToken = nullptr;
+};
+
+/** I/O 线程解析出的完整请求，交给游戏线程处理 */
+struct FMCPEndpointRequest
+{
+	uint32 ConnectionId = 0;
+	FString Type;
+	FString Id;
+	TSharedPtr<FJsonObject> Message;
+	/** FPlatformTime::Seconds() 时间戳 */
+	double ReceiveTime = 0.0;
+	EMCPRequestPriority Priority = EMCPRequestPriority::Normal;
+	/** 超过该时间（FPlatformTime::Seconds）仍未开始执行则直接回复超时，0 表示不限 */
+	double Deadline = 0.0;
+	FMCPCancellationTokenPtr CancelToken;
+
+	bool IsCancelled() const { return CancelToken.IsValid() && CancelToken->IsCancelled(); }
+};
+
+/**
+ * 游戏线程请求调度器。
+ *
+ * - 按优先级分组，同一优先级内按连接轮询，保证多个客户端公平
+ * - 每帧在 MCP.Endpoint.FrameBudgetMs 预算内执行请求，超出预算的留到下一帧（每帧至少执行一个，保证前进）
+ * - High 优先级请求不受预算限制
+ * - 到达截止时间仍未执行的请求不再执行，交给 OnExpired 回复错误
+ *
+ * 仅在游戏线程使用。
+ */
+class MCPSERVER_API FMCPRequestScheduler
+{
+public:
+	void Enqueue(FMCPEndpointRequest&& Request);
+
+	/** 丢弃连接所有排队中的请求 */
+	void RemoveConnection(uint32 ConnectionId);
+
+	/**
+	 * 在预算内执行排队的请求
+	 * @param FrameStartTime 本帧开始处理的时间（FPlatformTime::Seconds），预算从此时起算
+	 * @return 本帧执行的请求数量
+	 */
+	int32 Execute(double FrameStartTime, TFunctionRef<void(const FMCPEndpointRequest&)> Handler, TFunctionRef<void(const FMCPEndpointRequest&)> OnExpired);
+
+	int32 Num() const;
+	int32 Num(EMCPRequestPriority Priority) const;
+
+	/** 当前配置的每帧预算（秒） */
+	static double GetFrameBudgetSeconds();
+
+	/** 根据消息类型（含原生处理器注册的优先级）确定优先级，请求中的 "priority" 字段只能将其降低 */
+	static EMCPRequestPriority GetRequestPriority(const FString& Type, const FJsonObject& Message);
+
+private:
+	struct FConnectionQueue
+	{
+		uint32 ConnectionId = 0;
+		/** Requests[Head] 为下一个待执行的请求，取出时只移动 Head，已取出的前缀积累过半后才整体前移 */
+		TArray<FMCPEndpointRequest> Requests;
+		int32 Head = 0;
+
+		int32 NumPending() const { return Requests.Num() - Head; }
+	};
+
+	struct FPriorityQueue
+	{
+		/** 只包含有待执行请求的连接，取空的连接立即移除 */
+		TArray<FConnectionQueue> Connections;
+		/** 下一个被轮询的连接，每取出一个请求后移；移除前面的连接时随之前移 */
+		int32 NextConnection = 0;
+	};
+
+	/** 按连接轮询取出该优先级的下一个请求 */
+	bool PopNext(FPriorityQueue& Queue, FMCPEndpointRequest& OutRequest);
+
+	FPriorityQueue Queues[static_cast<int32>(EMCPRequestPriority::Num)];
+};
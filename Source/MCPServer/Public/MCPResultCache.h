@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+
+/**
+ * 只读原生请求的结果缓存。
+ *
+ * 键为 消息类型 + 规范化的请求参数（键排序，忽略 id/priority/deadline_ms/progress/cache 等传输字段），
+ * 只缓存 FMCPNativeHandler::bReadOnly 且 bCacheable 的处理器的成功结果；按对象路径读取的处理器只缓存资产和 CDO，
+ * PIE 运行期间不使用缓存。
+ * 任何可能改变编辑器状态的事件都会清空整个缓存：事务（含撤销/重做）、属性修改、包标脏、
+ * 资产注册表增删改、蓝图编译、GameplayTag 树刷新、PIE 开始/结束、垃圾回收，以及执行非只读请求（Python 代码、set_property）。
+ *
+ * 容量由 MCP.Endpoint.ResultCacheSizeMB 限制（0 关闭缓存），超出时淘汰最久未使用的条目。
+ * 请求带 "cache": false 时跳过缓存。仅在游戏线程使用。
+ */
+class MCPSERVER_API FMCPResultCache
+{
+public:
+	static FMCPResultCache& Get();
+
+	/** 订阅失效事件 */
+	void StartListening();
+	void StopListening();
+
+	/**
+	 * 查找缓存结果
+	 * @return 命中时返回结果副本（已设置请求的 id 和 "cached": true），否则返回 nullptr
+	 */
+	TSharedPtr<FJsonObject> Find(const FString& Type, const FJsonObject& Request);
+
+	/** 缓存处理器生成的结果（失败结果不缓存） */
+	void Add(const FString& Type, const FJsonObject& Request, const TSharedRef<FJsonObject>& Result);
+
+	/** 清空缓存 */
+	void Invalidate();
+
+	/** 请求是否允许使用缓存（容量非 0、未指定 "cache": false 且 PIE 未运行） */
+	static bool IsEnabledFor(const FJsonObject& Request);
+
+	/** 生成缓存键，供测试和统计使用 */
+	static FString MakeKey(const FString& Type, const FJsonObject& Request);
+
+	int32 Num() const { return Entries.Num(); }
+	int64 GetTotalBytes() const { return TotalBytes; }
+	uint64 GetHits() const { return Hits; }
+	uint64 GetMisses() const { return Misses; }
+	uint64 GetInvalidations() const { return Invalidations; }
+
+private:
+	struct FEntry
+	{
+		TSharedPtr<FJsonObject> Result;
+		int64 Bytes = 0;
+		uint64 LastAccess = 0;
+	};
+
+	void EvictToBudget(int64 BudgetBytes);
+
+	TMap<FString, FEntry> Entries;
+	int64 TotalBytes = 0;
+	uint64 AccessCounter = 0;
+	uint64 Hits = 0;
+	uint64 Misses = 0;
+	uint64 Invalidations = 0;
+
+	bool bIsListening = false;
+	FDelegateHandle ObjectTransactedHandle;
+	FDelegateHandle ObjectPropertyChangedHandle;
+	FDelegateHandle PackageDirtyHandle;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+	FDelegateHandle GameplayTagTreeHandle;
+	FDelegateHandle BeginPIEHandle;
+	FDelegateHandle EndPIEHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+};
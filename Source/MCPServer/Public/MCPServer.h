@@ -8,6 +8,10 @@
 #include "HAL/IConsoleManager.h"
 
 class FMCPTeachingSessionManager;
+class FMCPSnapshotStore;
+class FMCPPropertyIndex;
+class FMCPEndpoint;
+class FMCPHttpServer;
 
 // 声明 MCP Server 插件专属的日志分类
 DECLARE_LOG_CATEGORY_EXTERN(LogMCPServer, Log, All);
@@ -62,17 +66,40 @@ public:
 	void EnableObjectPropertyChangeListener(bool Enable);
 	static void OnLogCaptureConsoleVariableChanged(IConsoleVariable* Var);
 	static void OnPropertyChangeListenerConsoleVariableChanged(IConsoleVariable* Var);
+	static void OnIncrementalSnapshotConsoleVariableChanged(IConsoleVariable* Var);
 	
 	// 控制台命令函数
 	static void PrintCapturedLogsCommand(const TArray<FString>& Args);
 	static void StartTeachingConsoleCommand(const TArray<FString>& Args);
 	static void StopTeachingConsoleCommand(const TArray<FString>& Args);
+	static void RebuildSnapshotConsoleCommand(const TArray<FString>& Args);
+	static void CompactSnapshotConsoleCommand(const TArray<FString>& Args);
+	static void StartEndpointConsoleCommand(const TArray<FString>& Args);
+	static void StopEndpointConsoleCommand(const TArray<FString>& Args);
+	static void EndpointStatsConsoleCommand(const TArray<FString>& Args);
+	static void StartHttpServerConsoleCommand(const TArray<FString>& Args);
+	static void StopHttpServerConsoleCommand(const TArray<FString>& Args);
 
 	TSharedPtr<FMCPTeachingSessionManager> GetTeachingSessionManager() const { return TeachingSessionManager; }
 	void StartTeachingSession();
 	void StopTeachingSession();
 	void RecordTeachingEvent(FName EventName, const FString& Payload);
 
+	// 增量属性快照
+	TSharedPtr<FMCPSnapshotStore> GetSnapshotStore();
+	void EnableIncrementalSnapshot(bool bEnable);
+	TSharedPtr<FMCPPropertyIndex> GetPropertyIndex();
+
+	// 原生转发端点（替代 MCPForwarder.py）
+	bool StartEndpoint(const FString& BindAddress, int32 Port);
+	void StopEndpoint();
+	TSharedPtr<FMCPEndpoint> GetEndpoint() const { return Endpoint; }
+
+	// 原生 MCP 端点（Streamable HTTP，替代 MCPStandalone/MCPServer.py 的协议处理）
+	bool StartHttpServer(int32 Port, const FString& Path, const FString& BindAddress = TEXT("127.0.0.1"));
+	void StopHttpServer();
+	TSharedPtr<FMCPHttpServer> GetHttpServer() const { return HttpServer; }
+
 private:
 	static TSharedPtr<FMCPLogCaptureDevice> LogCaptureDevice;
 	static bool bLogCaptureEnabled;
@@ -82,6 +109,14 @@ private:
 	static bool bPropertyChangeListenerEnabled;
 	IConsoleCommand* StartTeachingCommand = nullptr;
 	IConsoleCommand* StopTeachingCommand = nullptr;
+	IConsoleVariable* IncrementalSnapshotConsoleVariable = nullptr;
+	IConsoleCommand* RebuildSnapshotCommand = nullptr;
+	IConsoleCommand* CompactSnapshotCommand = nullptr;
+	IConsoleCommand* StartEndpointCommand = nullptr;
+	IConsoleCommand* StopEndpointCommand = nullptr;
+	IConsoleCommand* EndpointStatsCommand = nullptr;
+	IConsoleCommand* StartHttpServerCommand = nullptr;
+	IConsoleCommand* StopHttpServerCommand = nullptr;
 
 	// 属性值缓存：对象 -> 属性名 -> 属性值
 	static TMap<TWeakObjectPtr<UObject>, TMap<FName, FString>> PropertyValueCache;
@@ -89,4 +124,10 @@ private:
 	
 	FDelegateHandle OnObjectTransactedHandle;
 	TSharedPtr<FMCPTeachingSessionManager> TeachingSessionManager;
+	TSharedPtr<FMCPSnapshotStore> SnapshotStore;
+	TSharedPtr<FMCPPropertyIndex> PropertyIndex;
+	/** 保护 SnapshotStore/PropertyIndex 的延迟创建，属性索引查询可能来自工作线程 */
+	FCriticalSection SnapshotMutex;
+	TSharedPtr<FMCPEndpoint> Endpoint;
+	TSharedPtr<FMCPHttpServer> HttpServer;
 };
\ No newline at end of file
@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+
+/**
+ * 端点发往同机客户端的共享内存环形缓冲（单生产者：端点 I/O 线程；单消费者：客户端）。
+ *
+ * 大帧的负载直接写入环形缓冲，socket 上只发送一个 6 字节的引用帧
+ * （FMCPEndpoint::CompressedFrameMarker + SharedMemoryReference + 长度），客户端按顺序从环中读取，
+ * 省去大负载经过内核 socket 缓冲的两次拷贝。socket 兼作唤醒通知，顺序与普通帧一致。
+ *
+ * 共享区布局（小端序）：
+ *   [0]  u32 Magic 'MCPR'
+ *   [4]  u32 Version
+ *   [8]  u64 Capacity   数据区大小
+ *   [16] u64 WritePos   端点写入的累计字节数（端点写）
+ *   [24] u64 ReadPos    客户端读取的累计字节数（客户端写）
+ *   [HeaderSize] 数据区，累计位置对 Capacity 取模，跨越末尾的负载分两段
+ */
+class MCPSERVER_API FMCPSharedMemoryRing
+{
+public:
+	~FMCPSharedMemoryRing();
+
+	/** 创建命名共享内存，失败时返回 nullptr */
+	static TUniquePtr<FMCPSharedMemoryRing> Create(const FString& Name, int32 Capacity);
+
+	/**
+	 * 写入一段负载
+	 * @return 剩余空间不足（客户端读取落后）时返回 false，调用方改走 socket
+	 */
+	bool Write(const uint8* Data, int32 Size);
+
+	/** 客户端打开共享内存使用的名称（含平台前缀） */
+	FString GetClientName() const;
+
+	int32 GetCapacity() const { return static_cast<int32>(Capacity); }
+
+	static constexpr uint32 Magic = 0x5250434d;
+	static constexpr uint32 Version = 1;
+	static constexpr int32 HeaderSize = 64;
+
+private:
+	FMCPSharedMemoryRing() = default;
+
+	FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+	uint8* Header = nullptr;
+	uint8* Data = nullptr;
+	uint64 Capacity = 0;
+	/** 仅端点写入，本地副本避免回读共享区 */
+	uint64 WritePos = 0;
+	FString Name;
+};
@@ -0,0 +1,55 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "MCPSnapshotLibrary.generated.h"
+
+/**
+ * Blueprint function library for the incremental blueprint property snapshot
+ */
+UCLASS()
+class MCPSERVER_API UMCPSnapshotLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Enable or disable incremental snapshot updates on package save / blueprint compile
+	 * (same as console variable MCP.EnableIncrementalSnapshot)
+	 * @param bEnable Whether to listen for asset changes
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Snapshot", meta = (DisplayName = "Enable Incremental Snapshot"))
+	static void EnableIncrementalSnapshot(bool bEnable = true);
+
+	/**
+	 * Re-dump every blueprint under RootPath and drop snapshot entries for assets that no longer exist
+	 * @param RootPath Content root to scan (e.g., "/Game")
+	 * @return Number of blueprints dumped
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Snapshot", meta = (DisplayName = "Rebuild Property Snapshot"))
+	static int32 RebuildSnapshot(const FString& RootPath = TEXT("/Game"));
+
+	/**
+	 * Read the latest snapshot dump of a blueprint without loading it
+	 * @param PackagePath The package path of the Blueprint (e.g., "/Game/Blueprints/MyBlueprint")
+	 * @param OutDump The dump text produced by DumpBlueprintProperties when the asset was last saved/compiled
+	 * @return True if the asset is present in the snapshot
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Snapshot", meta = (DisplayName = "Read Asset Snapshot"))
+	static bool ReadAssetSnapshot(const FString& PackagePath, FString& OutDump);
+
+	/**
+	 * Get the package paths of all assets currently in the snapshot
+	 */
+	UFUNCTION(BlueprintPure, Category = "MCP|Snapshot", meta = (DisplayName = "Get Snapshot Asset Paths"))
+	static TArray<FString> GetSnapshotAssetPaths();
+
+	/**
+	 * Rewrite the snapshot file keeping only the latest record of each live asset
+	 * @return True if compaction succeeded
+	 */
+	UFUNCTION(BlueprintCallable, Category = "MCP|Snapshot", meta = (DisplayName = "Compact Property Snapshot"))
+	static bool CompactSnapshot();
+};
@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+#include "Runtime/Launch/Resources/Version.h"
+#if ENGINE_MAJOR_VERSION >= 5
+#include "UObject/ObjectSaveContext.h"
+#endif
+
+class UBlueprint;
+class UPackage;
+struct FAssetData;
+
+/** 快照文件中的记录类型 */
+enum class EMCPSnapshotRecordType : uint8
+{
+	/** 资产的最新 dump 内容 */
+	Put = 0,
+	/** 资产已被删除/重命名，之前的记录作废 */
+	Tombstone = 1,
+};
+
+/** 内存索引项：指向某资产最新一条 Put 记录的正文位置 */
+struct FMCPSnapshotEntry
+{
+	int64 BodyOffset = 0;
+	int32 BodySize = 0;
+	FDateTime Timestamp;
+};
+
+/** 快照内容变化通知：AssetPath 为包路径，bRemoved 表示写入了墓碑 */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnMCPSnapshotUpdated, const FString& /*AssetPath*/, bool /*bRemoved*/);
+
+/**
+ * 项目蓝图属性快照的增量存储。
+ *
+ * 磁盘格式为只追加日志：每次保存/编译只为变化的资产追加一条 Put 记录，删除或重命名追加墓碑记录。
+ * 内存中只保留 资产路径 -> 最新记录偏移 的索引，读取时按需从文件取正文。
+ * 当失效记录数超过存活记录数（且不少于 CompactionMinDeadRecords）时自动压缩重写文件。
+ *
+ * 读接口（ReadSnapshot/GetAssetPaths）可在任意线程调用，写接口需在游戏线程调用。
+ */
+class MCPSERVER_API FMCPSnapshotStore : public TSharedFromThis<FMCPSnapshotStore>
+{
+public:
+	FMCPSnapshotStore();
+	~FMCPSnapshotStore();
+
+	/** 打开（或创建）快照文件并加载索引 */
+	void Initialize(const FString& InSnapshotFilePath);
+
+	/** 开始/停止监听包保存、蓝图编译及资产删除/重命名事件 */
+	void StartListening();
+	void StopListening();
+	bool IsListening() const { return bIsListening; }
+
+	/** 全量重建：dump RootPath 下所有蓝图，并为已不存在的资产写入墓碑 */
+	int32 RebuildAll(const FString& RootPath = TEXT("/Game"));
+
+	/** 重新 dump 单个蓝图资产并追加记录 */
+	bool UpdateAsset(const FString& AssetPath);
+
+	/** 为资产追加墓碑记录 */
+	void RemoveAsset(const FString& AssetPath);
+
+	/** 读取资产最新的 dump 内容 */
+	bool ReadSnapshot(const FString& AssetPath, FString& OutDump) const;
+
+	/** 获取快照中所有存活资产路径 */
+	TArray<FString> GetAssetPaths() const;
+
+	/** 将文件压缩为仅包含存活记录 */
+	bool Compact();
+
+	int32 GetLiveRecordCount() const;
+	int32 GetDeadRecordCount() const;
+	const FString& GetSnapshotFilePath() const { return SnapshotFilePath; }
+
+	FOnMCPSnapshotUpdated& OnSnapshotUpdated() { return SnapshotUpdatedEvent; }
+
+	/** 失效记录达到该数量后才考虑压缩，避免小文件频繁重写 */
+	static constexpr int32 CompactionMinDeadRecords = 64;
+
+private:
+	bool AppendRecord(EMCPSnapshotRecordType Type, const FString& AssetPath, const FString& Body);
+	void LoadIndex();
+	/** 需持有 IndexLock 写锁；返回文件尾部是否有截断记录 */
+	bool LoadIndexLocked();
+	void CompactIfNeeded();
+
+	void QueueAsset(const FString& AssetPath);
+	void FlushPendingAssets();
+
+#if ENGINE_MAJOR_VERSION >= 5
+	void HandlePackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext ObjectSaveContext);
+#else
+	void HandlePackageSaved(const FString& PackageFileName, UObject* PackageObject);
+#endif
+	void HandleBlueprintPreCompile(UBlueprint* Blueprint);
+	void HandleBlueprintCompiled();
+	void HandleAssetRemoved(const FAssetData& AssetData);
+	void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+private:
+	FString SnapshotFilePath;
+
+	/** 资产路径 -> 最新 Put 记录 */
+	TMap<FString, FMCPSnapshotEntry> Index;
+	int32 DeadRecordCount = 0;
+	int64 ValidFileSize = 0;
+	mutable FRWLock IndexLock;
+
+	/** 等待下一帧 dump 的资产（保存/编译回调中不能直接加载和 dump） */
+	TSet<FString> PendingAssets;
+	bool bFlushScheduled = false;
+
+	bool bIsListening = false;
+	FDelegateHandle PackageSavedHandle;
+	FDelegateHandle BlueprintPreCompileHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+
+	FOnMCPSnapshotUpdated SnapshotUpdatedEvent;
+};
@@ -0,0 +1,272 @@
+"""
+loadtest.py - 转发协议压测工具
+用多个并发的 EditorConnection 向编辑器端点（C++ 原生端点、Python 转发器或 MCPMockEditor）
+持续发送混合类型的请求，统计每种类型的 p50/p99 延迟和总吞吐。
+
+不需要 UE 编辑器：--spawn-mock 在子进程中启动 Content/Python/mcp_server/MCPMockEditor.py，
+其余参数原样转给模拟编辑器（如 --delay execute=5 --frame-ms 16.7）。
+
+使用方法：
+    python loadtest.py --spawn-mock [--clients 8] [--duration 10] [--mix ping=4,execute=1,dump_stream=1]
+    python loadtest.py --port 8100 --clients 4 --encoding msgpack --compression lz4
+"""
+
+import sys
+import os
+import argparse
+import asyncio
+import contextlib
+import json
+import random
+import socket
+import subprocess
+import time
+
+# 获取路径但不添加到sys.path，避免Content/Python中的旧版本库覆盖系统库
+script_dir = os.path.dirname(os.path.abspath(__file__))
+python_dir = os.path.join(script_dir, "Content", "Python")
+mcp_server_dir = os.path.join(python_dir, "mcp_server")
+
+DEFAULT_MIX = "ping=4,get_state=2,log_tail=2,execute=1,dump_stream=1,batch=1"
+
+
+def load_standalone():
+    """直接导入MCPStandalone模块，避免通过__init__.py导入依赖unreal的模块"""
+    if mcp_server_dir not in sys.path:
+        sys.path.insert(0, mcp_server_dir)
+    import importlib.util
+    spec = importlib.util.spec_from_file_location("MCPStandalone", os.path.join(mcp_server_dir, "MCPStandalone.py"))
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+def parse_mix(text):
+    """解析 "ping=4,execute=1" 形式的请求类型权重"""
+    mix = {}
+    for item in text.split(","):
+        name, _, weight = item.strip().partition("=")
+        if name:
+            mix[name] = float(weight) if weight else 1.0
+    if not mix or sum(mix.values()) <= 0:
+        raise ValueError(f"Invalid --mix '{text}'")
+    return mix
+
+
+def build_request(msg_type, args):
+    """按类型构造请求，返回 (请求, 是否分块)；execute 直接发送原始请求，不经过 mypy 检查"""
+    if msg_type == "execute":
+        return {"type": "execute", "code": "pass", "mock_output_bytes": args.output_bytes}, False
+    if msg_type == "dump_stream":
+        return {"type": "dump_stream", "package_path": args.package_path, "chunk_chars": args.chunk_chars}, True
+    if msg_type == "batch":
+        entries = [{"type": "get_state"}] + [{"type": "execute", "code": "pass"} for _ in range(args.batch_size - 1)]
+        return {"type": "batch", "requests": entries}, False
+    if msg_type == "log_tail":
+        return {"type": "log_tail", "lines": 100}, False
+    return {"type": msg_type}, False
+
+
+class Stats:
+    """单个请求类型的统计"""
+
+    def __init__(self):
+        self.latencies = []
+        self.errors = 0
+        self.timeouts = 0
+
+    def summary(self, elapsed):
+        ordered = sorted(self.latencies)
+
+        def percentile(fraction):
+            return ordered[min(int(fraction * len(ordered)), len(ordered) - 1)] * 1000.0 if ordered else 0.0
+
+        return {
+            "count": len(ordered),
+            "errors": self.errors,
+            "timeouts": self.timeouts,
+            "rps": len(ordered) / elapsed if elapsed > 0 else 0.0,
+            "p50_ms": percentile(0.5),
+            "p90_ms": percentile(0.9),
+            "p99_ms": percentile(0.99),
+            "max_ms": ordered[-1] * 1000.0 if ordered else 0.0,
+        }
+
+
+async def run_client(index, MCPStandalone, args, mix, stats, measure_from, stop_at):
+    """一个客户端：顺序发送请求（EditorConnection 每个连接同时只有一个请求在途）"""
+    config = MCPStandalone.ConnectionConfig(encoding=args.encoding, compression=args.compression,
+                                            shared_memory="off", heartbeat_interval=0,
+                                            request_timeout=args.timeout, busy_timeout=0)
+    connection = MCPStandalone.EditorConnection(args.host, args.port, config)
+    if not await connection.connect():
+        print(f"[Client {index}] Failed to connect to {args.host}:{args.port}")
+        return
+
+    rng = random.Random(args.seed + index)
+    types = list(mix.keys())
+    weights = list(mix.values())
+    try:
+        while time.perf_counter() < stop_at:
+            msg_type = rng.choices(types, weights)[0]
+            request, streamed = build_request(msg_type, args)
+            start = time.perf_counter()
+            try:
+                if streamed:
+                    response = await connection.send_request(request, timeout=args.timeout, on_chunk=lambda data: None)
+                else:
+                    response = await connection.send_request(request, timeout=args.timeout)
+                success = response.get("success", True)
+            except (TimeoutError, asyncio.TimeoutError):
+                if start >= measure_from:
+                    stats.setdefault(msg_type, Stats()).timeouts += 1
+                continue
+            except ConnectionError as e:
+                print(f"[Client {index}] Connection lost: {e}")
+                return
+            if start < measure_from:
+                continue
+
+            entry = stats.setdefault(msg_type, Stats())
+            if success:
+                entry.latencies.append(time.perf_counter() - start)
+            else:
+                entry.errors += 1
+    finally:
+        connection.disconnect()
+
+
+async def fetch_server_metrics(MCPStandalone, args):
+    """读取端点自身的统计（C++ 原生端点和模拟编辑器支持，Python 转发器不支持）"""
+    config = MCPStandalone.ConnectionConfig(encoding="json", compression="none", shared_memory="off", heartbeat_interval=0)
+    connection = MCPStandalone.EditorConnection(args.host, args.port, config)
+    if not await connection.connect():
+        return None
+    try:
+        return await connection.get_metrics(reset=True, timeout=5.0)
+    except Exception:
+        return None
+    finally:
+        connection.disconnect()
+
+
+async def run_load(MCPStandalone, args):
+    mix = parse_mix(args.mix)
+    stats = {}
+    # 预热阶段的请求不计入统计，结束后清空端点统计
+    start = time.perf_counter()
+    measure_from = start + args.warmup
+    stop_at = measure_from + args.duration
+
+    clients = [run_client(i, MCPStandalone, args, mix, stats, measure_from, stop_at) for i in range(args.clients)]
+    if args.warmup > 0:
+        async def reset_after_warmup():
+            await asyncio.sleep(args.warmup)
+            await fetch_server_metrics(MCPStandalone, args)
+        clients.append(reset_after_warmup())
+    await asyncio.gather(*clients)
+
+    elapsed = time.perf_counter() - measure_from
+    server_metrics = await fetch_server_metrics(MCPStandalone, args) if args.server_metrics else None
+    return stats, elapsed, server_metrics
+
+
+def print_report(args, stats, elapsed, server_metrics):
+    summaries = {name: entry.summary(elapsed) for name, entry in sorted(stats.items())}
+    total = sum(s["count"] for s in summaries.values())
+    all_latencies = sorted(latency for entry in stats.values() for latency in entry.latencies)
+    overall = Stats()
+    overall.latencies = all_latencies
+    overall.errors = sum(s["errors"] for s in summaries.values())
+    overall.timeouts = sum(s["timeouts"] for s in summaries.values())
+
+    if args.json:
+        print(json.dumps({"clients": args.clients, "duration": elapsed, "encoding": args.encoding,
+                          "compression": args.compression, "types": summaries,
+                          "total": overall.summary(elapsed), "server": server_metrics}, indent=2))
+        return
+
+    print("=" * 78)
+    print(f"{args.clients} clients, {elapsed:.1f}s, encoding={args.encoding}, compression={args.compression}")
+    print("=" * 78)
+    print(f"{'type':<14}{'count':>8}{'err':>6}{'t/o':>6}{'req/s':>10}{'p50 ms':>9}{'p90 ms':>9}{'p99 ms':>9}{'max ms':>9}")
+    for name, s in list(summaries.items()) + [("TOTAL", overall.summary(elapsed))]:
+        print(f"{name:<14}{s['count']:>8}{s['errors']:>6}{s['timeouts']:>6}{s['rps']:>10.1f}"
+              f"{s['p50_ms']:>9.2f}{s['p90_ms']:>9.2f}{s['p99_ms']:>9.2f}{s['max_ms']:>9.2f}")
+    print(f"Throughput: {total / elapsed if elapsed > 0 else 0.0:.1f} req/s")
+
+    if server_metrics and server_metrics.get("types"):
+        print("-" * 78)
+        print("Server-side (queue wait / execution p99, ms):")
+        for name, metrics in sorted(server_metrics["types"].items()):
+            if not metrics.get("executed"):
+                continue
+            queue_wait = metrics.get("queue_wait", {}).get("p99_ms", 0.0)
+            execution = metrics.get("execution", {}).get("p99_ms", 0.0)
+            print(f"  {name:<14}{metrics.get('executed', 0):>8}{queue_wait:>10.2f}{execution:>10.2f}")
+
+
+def wait_for_port(host, port, process, timeout=10.0):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if process.poll() is not None:
+            return False
+        try:
+            with socket.create_connection((host, port), timeout=0.5):
+                return True
+        except OSError:
+            time.sleep(0.1)
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Load-test the MCP editor protocol",
+                                     epilog="Unrecognized options are passed to MCPMockEditor when --spawn-mock is used.")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8100)
+    parser.add_argument("--spawn-mock", action="store_true", help="Start MCPMockEditor in a subprocess")
+    parser.add_argument("--clients", type=int, default=8, help="Concurrent connections")
+    parser.add_argument("--duration", type=float, default=10.0, help="Measured seconds")
+    parser.add_argument("--warmup", type=float, default=1.0, help="Seconds before measuring")
+    parser.add_argument("--mix", default=DEFAULT_MIX, help=f"Request type weights (default {DEFAULT_MIX})")
+    parser.add_argument("--encoding", default="json", choices=["auto", "json", "msgpack"])
+    parser.add_argument("--compression", default="none", choices=["auto", "lz4", "zlib", "none"])
+    parser.add_argument("--output-bytes", type=int, default=256, help="Output size requested from execute (mock editor only)")
+    parser.add_argument("--package-path", default="/Game/LoadTest/BP_LoadTest", help="dump_stream target")
+    parser.add_argument("--chunk-chars", type=int, default=16384)
+    parser.add_argument("--batch-size", type=int, default=4)
+    parser.add_argument("--timeout", type=float, default=30.0, help="Per-request timeout in seconds")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--no-server-metrics", dest="server_metrics", action="store_false",
+                        help="Do not query the endpoint's own metrics afterwards")
+    parser.add_argument("--json", action="store_true", help="Print the report as JSON")
+    args, mock_args = parser.parse_known_args()
+
+    if mock_args and not args.spawn_mock:
+        parser.error(f"unrecognized arguments: {' '.join(mock_args)}")
+
+    mock_process = None
+    if args.spawn_mock:
+        mock_process = subprocess.Popen(
+            [sys.executable, os.path.join(mcp_server_dir, "MCPMockEditor.py"),
+             "--host", args.host, "--port", str(args.port)] + mock_args,
+            stdout=sys.stderr if args.json else None)
+        if not wait_for_port(args.host, args.port, mock_process):
+            mock_process.kill()
+            print(f"Error: MCPMockEditor did not start on {args.host}:{args.port}")
+            sys.exit(1)
+
+    try:
+        # --json 时连接日志改写到 stderr，stdout 只输出报告
+        with contextlib.redirect_stdout(sys.stderr) if args.json else contextlib.nullcontext():
+            MCPStandalone = load_standalone()
+            stats, elapsed, server_metrics = asyncio.run(run_load(MCPStandalone, args))
+        print_report(args, stats, elapsed, server_metrics)
+    finally:
+        if mock_process is not None:
+            mock_process.terminate()
+            mock_process.wait(timeout=5)
+
+
+if __name__ == "__main__":
+    main()